@@ -0,0 +1,308 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// The bot's hot kernels against a synthetic item_template store, from the size of a stock
+// 3.3.5 world database up to 1M templates. sObjectMgr, the config and the world database are
+// the stand-ins in stubs/, so only the module's own code is measured.
+//   kernel_bench [max templates]
+
+#include "AliasTable.h"
+#include "AuctionHouseBotConfig.h"
+#include "AuctionHouseMgr.h"
+#include "Config.h"
+#include "DatabaseEnv.h"
+#include "ItemFilter.h"
+#include "ItemIndex.h"
+#include "ObjectMgr.h"
+#include "PriceKernel.h"
+#include "SyntheticWorld.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr uint32 batchSize = 200; // AuctionHouseBot.ItemsPerCycle default
+
+    uint64 sink = 0; // keeps the optimizer from dropping the measured work
+
+    // Nanoseconds per operation of fn(), which does ops operations, best of a few runs
+    template<class Fn>
+    double NsPerOp(uint64 ops, Fn&& fn)
+    {
+        double best = 0;
+        for (uint32 run = 0; run < 3; ++run)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            fn();
+            const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ops;
+            best = run ? std::min(best, ns) : ns;
+        }
+        return best;
+    }
+
+    void Report(char const* kernel, uint32 templates, double nsPerOp, char const* unit)
+    {
+        std::printf("%-34s %10u %14.1f  %s\n", kernel, templates, nsPerOp, unit);
+    }
+
+    // The filter InitializeItemsToSell() builds from the default config, without the database lists
+    void ConfigureFilter(ItemFilter& filter)
+    {
+        filter.Loot_Items = true;
+        filter.Loot_TGs = true;
+        filter.Other_Items = true;
+        filter.Other_TGs = true;
+        filter.No_Bind = true;
+        filter.Bind_When_Equipped = true;
+        filter.Bind_When_Use = true;
+    }
+
+    void BenchConfig()
+    {
+        AHBConfig config(AUCTIONHOUSE_NEUTRAL);
+        config.SetMaxItems(15000);
+
+        std::array<float, AHB_MAX_QUALITY> percentages = { 0, 27, 12, 10, 1, 0, 0, 0, 10, 30, 8, 2, 0, 0 };
+        config.SetPercentages(percentages);
+
+        constexpr uint32 calls = 2000000;
+        Report("AHBConfig::CalculateMaxCounts", 0, NsPerOp(calls, [&]
+        {
+            for (uint32 i = 0; i < calls; ++i)
+            {
+                config.SetMaxItems(15000 + (i & 1023));
+                config.CalculateMaxCounts();
+                sink += config.GetMaxCount(i % AHB_MAX_QUALITY);
+            }
+        }), "ns/call");
+
+        Report("AHBConfig getters, all qualities", 0, NsPerOp(calls, [&]
+        {
+            for (uint32 i = 0; i < calls; ++i)
+            {
+                for (uint32 quality = 0; quality < AHB_MAX_QUALITY; ++quality)
+                    sink += config.GetMaxCount(quality) + config.GetItemCounts(quality) + config.GetMinPrice(quality) +
+                        config.GetMaxPrice(quality) + config.GetMaxStack(quality) + config.GetBuyerPrice(quality);
+            }
+        }), "ns/pass");
+    }
+
+    void BenchQualitySampling(std::mt19937& rng)
+    {
+        // What the seller misses right after a restart, weighted by its item counts
+        std::array<uint32, AHB_MAX_QUALITY> itemCountToCreate = { 0, 4050, 1800, 1500, 150, 0, 0, 0, 1500, 4500, 1200, 300, 0, 0 };
+
+        constexpr uint32 draws = 5000000;
+        std::discrete_distribution<uint32> randomQuality(itemCountToCreate.begin(), itemCountToCreate.end());
+        Report("discrete_distribution quality draw", 0, NsPerOp(draws, [&]
+        {
+            for (uint32 i = 0; i < draws; ++i)
+                sink += randomQuality(rng);
+        }), "ns/draw");
+
+        constexpr uint32 builds = 500000;
+        Report("discrete_distribution build", 0, NsPerOp(builds, [&]
+        {
+            for (uint32 i = 0; i < builds; ++i)
+            {
+                itemCountToCreate[i % AHB_MAX_QUALITY] ^= 1;
+                std::discrete_distribution<uint32> distribution(itemCountToCreate.begin(), itemCountToCreate.end());
+                sink += distribution.max();
+            }
+        }), "ns/build");
+    }
+
+    // Not a measurement: an item of weight 0 must never be drawn, whatever rounding leaves over while
+    // the table is built. Random tables with a third of the weights 0, the rest spread over 60 decades.
+    bool CheckAliasTableZeroWeights(std::mt19937& rng)
+    {
+        constexpr uint32 tables = 2000;
+        constexpr uint32 drawsPerTable = 5000;
+        std::uniform_int_distribution<uint32> size(2, 200);
+        std::uniform_int_distribution<uint32> zero(0, 2);
+        std::uniform_real_distribution<float> exponent(-30.f, 30.f);
+
+        AHBAliasTable table;
+        std::vector<float> weights;
+
+        for (uint32 t = 0; t < tables; ++t)
+        {
+            weights.resize(size(rng));
+            for (float& weight : weights)
+                weight = zero(rng) ? std::pow(10.f, exponent(rng)) : 0.f;
+            weights[t % weights.size()] = 1.f; // at least one item can be drawn
+
+            table.Build(weights);
+            for (uint32 i = 0; i < drawsPerTable; ++i)
+            {
+                const uint32 index = table.Sample(rng);
+                if (weights[index] <= 0.f)
+                {
+                    std::printf("AHBAliasTable: drew item %u of weight 0 from a table of %zu items\n", index, weights.size());
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    void BenchTemplates(uint32 count, std::mt19937& rng)
+    {
+        GenerateItemTemplates(count, rng);
+        WorldDatabase.Clear();
+        GenerateWorldDatabase(count, rng);
+
+        AuctionHouseIndex index;
+        index.Initialize();
+
+        // The filter rules alone, over every template
+        ItemFilter filter(index.GetPriceOverrides());
+        ConfigureFilter(filter);
+        for (uint32 itemId = 1; itemId <= count; ++itemId)
+        {
+            if (itemId % 10 == 0)
+                filter.npcItems.insert(itemId);
+            if (itemId % 5 < 3)
+                filter.lootItems.insert(itemId);
+        }
+
+        ItemTemplateContainer const& store = *sObjectMgr->GetItemTemplateStore();
+        Report("ItemFilter::IsAccepted", count, NsPerOp(count, [&]
+        {
+            for (auto const& [itemId, itemTemplate] : store)
+                sink += filter.IsAccepted(itemTemplate);
+        }), "ns/template");
+
+        // Everything the index does on a reload, with the database lists
+        sConfigMgr->Set("AuctionHouseBot.ItemWeights", std::to_string(AHB_ITEM_WEIGHTS_UNIFORM));
+        Report("InitializeItemsToSell, uniform", count, NsPerOp(count, [&] { sink += index.InitializeItemsToSell(); }), "ns/template");
+
+        // The largest bin is what the seller samples most from
+        uint32 largestBin = 0;
+        for (uint32 quality = 0; quality < AHB_MAX_QUALITY; ++quality)
+            if (index.GetItemBin(quality).size() > index.GetItemBin(largestBin).size())
+                largestBin = quality;
+
+        std::vector<uint32> const& itemsBin = index.GetItemBin(largestBin);
+        std::vector<uint32> itemBatch;
+        itemBatch.reserve(batchSize);
+
+        constexpr uint32 batches = 2000;
+        Report("std::sample, largest bin", count, NsPerOp(uint64(batches) * batchSize, [&]
+        {
+            for (uint32 i = 0; i < batches; ++i)
+            {
+                itemBatch.clear();
+                std::sample(itemsBin.begin(), itemsBin.end(), std::back_inserter(itemBatch), batchSize, rng);
+                sink += itemBatch.back();
+            }
+        }), "ns/item");
+
+        Report("SampleItemInBracket, uniform", count, NsPerOp(uint64(batches) * batchSize, [&]
+        {
+            for (uint32 i = 0; i < batches * batchSize; ++i)
+            {
+                const uint32 bracket = i % AHB_LEVEL_BRACKETS;
+                if (index.CanSampleBracket(largestBin, bracket))
+                    sink += index.SampleItemInBracket(largestBin, bracket, rng);
+            }
+        }), "ns/item");
+
+        sConfigMgr->Set("AuctionHouseBot.ItemWeights", std::to_string(AHB_ITEM_WEIGHTS_TABLE));
+        Report("InitializeItemsToSell, weighted", count, NsPerOp(count, [&] { sink += index.InitializeItemsToSell(); }), "ns/template");
+
+        Report("SampleWeightedItem", count, NsPerOp(uint64(batches) * batchSize, [&]
+        {
+            for (uint32 i = 0; i < batches * batchSize; ++i)
+                sink += index.SampleWeightedItem(largestBin, rng);
+        }), "ns/item");
+
+        // Every 10th item is overridden, so this is the 1 hit in 10 mix the seller and buyer see
+        constexpr uint32 lookups = 2000000;
+        std::uniform_int_distribution<uint32> pick(1, count);
+        std::vector<uint32> items(lookups);
+        for (uint32& itemId : items)
+            itemId = pick(rng);
+
+        Report("GetOverridenPrice, 1 in 10 hit", count, NsPerOp(lookups, [&]
+        {
+            for (const uint32 itemId : items)
+                if (const auto price = index.GetOverridenPrice(itemId, rng))
+                    sink += *price;
+        }), "ns/lookup");
+    }
+
+    void BenchBuyerBid(std::mt19937& rng)
+    {
+        constexpr uint32 auctions = 1000000;
+        std::uniform_int_distribution<uint32> price(1, 1000000);
+        std::uniform_int_distribution<uint32> count(1, 20);
+        std::uniform_int_distribution<uint32> buyerPrice(1, 8);
+
+        struct Auction
+        {
+            uint32 currentPrice;
+            uint64 basePrice;
+            uint32 count;
+            uint32 buyerPrice;
+        };
+
+        std::vector<Auction> list(auctions);
+        for (Auction& auction : list)
+            auction = { price(rng), price(rng) / 4, count(rng), buyerPrice(rng) };
+
+        std::uniform_real_distribution<float> bidRate(0.1f, 0.9f);
+        const float rate = bidRate(rng);
+
+        Report("CalculateBuyerBid", 0, NsPerOp(auctions, [&]
+        {
+            for (Auction const& auction : list)
+                sink += CalculateBuyerBid(auction.currentPrice, auction.basePrice, auction.count, auction.buyerPrice, auction.currentPrice / 100, rate).bidPrice;
+        }), "ns/auction");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const uint32 maxTemplates = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+
+    std::mt19937 rng(42);
+
+    if (!CheckAliasTableZeroWeights(rng))
+        return 1;
+
+    std::printf("%-34s %10s %14s\n", "kernel", "templates", "time");
+    BenchConfig();
+    BenchQualitySampling(rng);
+    BenchBuyerBid(rng);
+
+    for (uint32 count = AHB_STOCK_TEMPLATE_COUNT; count <= maxTemplates; count = count < 250000 ? 250000 : count * 4)
+        BenchTemplates(count, rng);
+
+    std::printf("(checksum %llu)\n", static_cast<unsigned long long>(sink));
+    return 0;
+}
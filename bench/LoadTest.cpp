@@ -0,0 +1,300 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// The module's side of a startup and of the paths that grow with the auction houses, at a given
+// number of auctions per house: LoadValues() of every house, one buyer query callback, ahexpire
+// (or purge) and the memory the bot holds on top of the auctions. The auctions are in the in-memory
+// houses of stubs/, the database side is timed by load_test.sh against a real server.
+//   load_test [--json <file>] [--botpercent <n>] [--purge] [auctions per house ...]
+
+#include "AuctionHouseBot.h"
+#include "AuctionHouseBotConfig.h"
+#include "AuctionHouseMgr.h"
+#include "Config.h"
+#include "DatabaseEnv.h"
+#include "GameTime.h"
+#include "Metrics.h"
+#include "ModuleHooks.h"
+#include "ObjectMgr.h"
+#include "ProcessMemory.h"
+#include "SyntheticWorld.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr uint32 botAccount = 1;
+    constexpr uint32 botGuid = 1;
+    constexpr uint32 maxExpireUpdates = 10000;  // gives up on an ahexpire job that never finishes
+
+    constexpr std::array<uint32, 3> houses = { AUCTIONHOUSE_ALLIANCE, AUCTIONHOUSE_HORDE, AUCTIONHOUSE_NEUTRAL };
+
+    struct HouseResult
+    {
+        uint32 houseId{ 0 };
+        double loadValuesMs{ 0 };
+        uint64 buyerRows{ 0 };
+        double buyerCallbackMs{ 0 };
+        double expireCommandMs{ 0 };
+        double expireJobMs{ 0 };
+        uint32 expireUpdates{ 0 };
+        double settleMs{ 0 };
+    };
+
+    struct Result
+    {
+        uint32 auctionsPerHouse{ 0 };
+        double seedMs{ 0 };
+        double rssSeededMB{ 0 };
+        double rssLoadedMB{ 0 };
+        double peakRssMB{ 0 };
+        std::vector<HouseResult> houses;
+    };
+
+    double ElapsedMs(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void AdvanceClock(Seconds seconds)
+    {
+        GameTime::SetStubTime(GameTime::GetGameTimeMS() + std::chrono::duration_cast<Milliseconds>(seconds));
+    }
+
+    uint64 CallbackMicroseconds(uint32 houseId)
+    {
+        return sAHMetrics->Read().timers[AHBMetrics::GetHouseSlot(houseId)][uint32(AHBTimer::BuyerCallback)].totalMicroseconds;
+    }
+
+    bool HasUnexpiredBotAuctions(uint32 houseId)
+    {
+        const time_t now = GameTime::GetGameTime().count();
+        for (auto const& [id, auction] : sAuctionMgr->GetAuctionsMapByHouseId(houseId)->GetAuctions())
+            if (auction->owner.GetCounter() == botGuid && auction->expire_time > now)
+                return true;
+
+        return false;
+    }
+
+    // The stock settings, the bot must not sell into the houses while they are measured
+    void RegisterDatabase(uint64& buyerRows)
+    {
+        WorldDatabase.SetHandler("SELECT minitems", [](std::string const&)
+        {
+            FakeRows rows(1);
+            for (uint32 column = 0; column < AHB_CONFIG_COLUMN_MAX; ++column)
+                rows[0].emplace_back(column == AHB_CONFIG_BID_INTERVAL || column == AHB_CONFIG_BIDS_PER_INTERVAL ? 1.0 : 0.0);
+
+            return rows;
+        });
+
+        CharacterDatabase.SetResult("SELECT 1 FROM characters", { { Field(1) } });
+
+        // Like the buyer's query, every house's auctions that are not ours and have no bid
+        CharacterDatabase.SetHandler("SELECT id FROM auctionhouse WHERE itemowner<>", [&buyerRows](std::string const&)
+        {
+            FakeRows rows;
+            for (uint32 houseId : houses)
+                for (auto const& [id, auction] : sAuctionMgr->GetAuctionsMapByHouseId(houseId)->GetAuctions())
+                    if (auction->owner.GetCounter() != botGuid && !auction->bidder)
+                        rows.push_back({ Field(id) });
+
+            buyerRows = rows.size();
+            return rows;
+        });
+    }
+
+    void Configure(bool seller, bool buyer)
+    {
+        sConfigMgr->Set("AuctionHouseBot.EnableSeller", seller ? "1" : "0");
+        sConfigMgr->Set("AuctionHouseBot.EnableBuyer", buyer ? "1" : "0");
+        sConfigMgr->Set("AuctionHouseBot.Account", std::to_string(botAccount));
+        sConfigMgr->Set("AuctionHouseBot.GUID", std::to_string(botGuid));
+        sAHBot->InitializeConfiguration();
+    }
+
+    Result Run(uint32 auctionsPerHouse, uint32 botPercent, bool purge, std::mt19937& rng)
+    {
+        Result result;
+        result.auctionsPerHouse = auctionsPerHouse;
+
+        uint64 buyerRows = 0;
+        RegisterDatabase(buyerRows);
+
+        // The houses are filled before the hooks count anything, like a core that loads them at startup
+        AuctionHouseHooks& hooks = sAuctionMgr->GetHooks();
+        hooks = {};
+        sAuctionMgr->Clear();
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32 houseId : houses)
+            GenerateAuctions(houseId, auctionsPerHouse, botGuid, botPercent, rng);
+
+        result.seedMs = ElapsedMs(start);
+        result.rssSeededMB = ResidentMB();
+
+        RegisterModuleHooks();
+
+        // Startup: the index, then LoadValues() of every house, which counts the auctions and indexes the bot's own
+        Configure(true, false);
+        sAHBot->Initialize();
+
+        for (uint32 houseId : houses)
+        {
+            HouseResult& house = result.houses.emplace_back();
+            house.houseId = houseId;
+
+            AHBConfig config(houseId);
+            start = std::chrono::steady_clock::now();
+            sAHBot->LoadValues(&config);
+            house.loadValuesMs = ElapsedMs(start);
+        }
+
+        result.rssLoadedMB = ResidentMB();
+
+        // Buyer: the first update sends the query of every house, the next one runs their callbacks
+        Configure(false, true);
+        AdvanceClock(1h);
+
+        std::vector<uint64> callbackBefore;
+        for (uint32 houseId : houses)
+            callbackBefore.push_back(CallbackMicroseconds(houseId));
+
+        sAHBot->Update();
+        sAHBot->Update();
+
+        for (std::size_t i = 0; i < houses.size(); ++i)
+        {
+            result.houses[i].buyerRows = buyerRows;
+            result.houses[i].buyerCallbackMs = (CallbackMicroseconds(houses[i]) - callbackBefore[i]) / 1000.0;
+        }
+
+        // ahexpire or purge of every house, the job is sliced over as many updates as it needs, then the core settles
+        // what ahexpire left. A purge leaves the auctions with bids, those are not waited for.
+        Configure(false, false);
+
+        for (HouseResult& house : result.houses)
+        {
+            start = std::chrono::steady_clock::now();
+            if (purge)
+                sAHBot->PurgeHouse(house.houseId, std::nullopt, std::nullopt);
+            else
+                sAHBot->Commands(AHBotCommand::ahexpire, house.houseId, 0, nullptr);
+            house.expireCommandMs = ElapsedMs(start);
+
+            while (house.expireUpdates < maxExpireUpdates && HasUnexpiredBotAuctions(house.houseId))
+            {
+                start = std::chrono::steady_clock::now();
+                sAHBot->Update();
+                house.expireJobMs += ElapsedMs(start);
+                ++house.expireUpdates;
+            }
+
+            start = std::chrono::steady_clock::now();
+            sAuctionMgr->Update();
+            house.settleMs = ElapsedMs(start);
+        }
+
+        result.peakRssMB = PeakResidentMB();
+        return result;
+    }
+
+    void WriteJson(std::ostream& out, std::vector<Result> const& results, std::string const& removal)
+    {
+        out << "[\n";
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            Result const& result = results[i];
+            out << "  {\"auctions_per_house\": " << result.auctionsPerHouse << ", \"seed_ms\": " << result.seedMs
+                << ", \"rss_seeded_mb\": " << result.rssSeededMB << ", \"rss_loaded_mb\": " << result.rssLoadedMB
+                << ", \"peak_rss_mb\": " << result.peakRssMB << ", \"houses\": [\n";
+
+            for (std::size_t j = 0; j < result.houses.size(); ++j)
+            {
+                HouseResult const& house = result.houses[j];
+                out << "    {\"house\": " << house.houseId << ", \"load_values_ms\": " << house.loadValuesMs
+                    << ", \"buyer_rows\": " << house.buyerRows << ", \"buyer_callback_ms\": " << house.buyerCallbackMs
+                    << ", \"" << removal << "_command_ms\": " << house.expireCommandMs << ", \"" << removal << "_job_ms\": " << house.expireJobMs
+                    << ", \"" << removal << "_updates\": " << house.expireUpdates << ", \"settle_ms\": " << house.settleMs << "}"
+                    << (j + 1 < result.houses.size() ? ",\n" : "\n");
+            }
+
+            out << "  ]}" << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        out << "]\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string jsonPath;
+    uint32 botPercent = 50;
+    bool purge = false;
+    std::vector<uint32> scales;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--json" && i + 1 < argc)
+            jsonPath = argv[++i];
+        else if (arg == "--botpercent" && i + 1 < argc)
+            botPercent = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--purge")
+            purge = true;
+        else
+            scales.push_back(std::strtoul(arg.c_str(), nullptr, 10));
+    }
+
+    if (scales.empty())
+        scales = { 10000, 100000, 1000000 };
+
+    GameTime::SetStubTime(std::chrono::duration_cast<Milliseconds>(Seconds(1700000000)));
+
+    std::mt19937 rng(42);
+    GenerateItemTemplates(AHB_STOCK_TEMPLATE_COUNT, rng);
+    GenerateWorldDatabase(AHB_STOCK_TEMPLATE_COUNT, rng);
+
+    std::vector<Result> results;
+
+    const std::string removal = purge ? "purge" : "ahexpire";
+
+    std::printf("%10s %6s %10s %16s %11s %16s %14s %12s %8s %10s %9s\n", "auctions", "house", "seed ms", "LoadValues ms",
+        "buyer rows", "buyer callb. ms", (removal + " ms").c_str(), (removal + " job ms").c_str(), "updates", "settle ms", "rss MB");
+
+    for (uint32 auctionsPerHouse : scales)
+    {
+        Result const& result = results.emplace_back(Run(auctionsPerHouse, botPercent, purge, rng));
+
+        for (HouseResult const& house : result.houses)
+            std::printf("%10u %6u %10.0f %16.2f %11llu %16.2f %14.2f %12.2f %8u %10.2f %9.1f\n", result.auctionsPerHouse, house.houseId,
+                result.seedMs, house.loadValuesMs, static_cast<unsigned long long>(house.buyerRows), house.buyerCallbackMs,
+                house.expireCommandMs, house.expireJobMs, house.expireUpdates, house.settleMs, result.rssLoadedMB);
+    }
+
+    if (!jsonPath.empty())
+    {
+        std::ofstream json(jsonPath);
+        WriteJson(json, results, removal);
+    }
+
+    return 0;
+}
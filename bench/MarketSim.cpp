@@ -0,0 +1,605 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Replays days of a realm's auction houses in seconds. The module's real seller and buyer
+// (AuctionHouseBot::Update) run against the in-memory auction houses and databases in stubs/,
+// while synthetic players list, bid and buy out. For every scenario it reports the bot's
+// throughput per second of CPU, memory, how full the houses were over time and the bot's trade
+// goods at the end, the auctions their supply takes.
+//
+//   market_sim [--csv <file>] [scenario ...]
+//
+// A scenario is name:key=value,... Keys are the columns of mod_auctionhousebot (maxitems,
+// buyerbidsperinterval, ...), AuctionHouseBot.* config options, or one of the simulation's own:
+//   templates   size of the synthetic item_template (37000)
+//   days        simulated days (7)
+//   listings    player auctions per hour and house (10)
+//   playerbids  player bids per hour and house (60)
+//   buyouts     percent of player bids that are buyouts (40)
+//   twoside     1 for a single shared auction house, like AllowTwoSide.Interaction.Auction (0)
+//   bulkfill    1 to start with "ahbotoptions fill" of every house (0)
+// For example, two scenarios in one run:
+//   market_sim "15k:maxitems=15000,minitems=15000,buyerbidsperinterval=10" "15k-fast:maxitems=15000,minitems=15000,AuctionHouseBot.ItemsPerCycle=1000"
+
+#include "AuctionHouseBot.h"
+#include "AuctionHouseMgr.h"
+#include "Config.h"
+#include "DatabaseEnv.h"
+#include "GameTime.h"
+#include "Metrics.h"
+#include "ModuleHooks.h"
+#include "ObjectMgr.h"
+#include "ProcessMemory.h"
+#include "SyntheticWorld.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr uint32 botAccount = 1;
+    constexpr uint32 botGuid = 1;
+    constexpr uint32 firstPlayerGuid = 1000;
+    constexpr uint32 playerCount = 1000;
+    constexpr uint32 sampleHours = 6;               // rows of the fill table, the csv has every hour
+    constexpr Minutes auctionUpdateInterval = 1min; // the core updates the auction houses once a minute
+
+    constexpr std::array<uint32, 3> houses = { AUCTIONHOUSE_ALLIANCE, AUCTIONHOUSE_HORDE, AUCTIONHOUSE_NEUTRAL };
+
+    struct Scenario
+    {
+        std::string name;
+        uint32 templates{ AHB_STOCK_TEMPLATE_COUNT };
+        uint32 days{ 7 };
+        double listings{ 10 };
+        double playerBids{ 60 };
+        uint32 buyoutPercent{ 40 };
+        bool twoSide{ false };
+        bool bulkFill{ false };
+
+        // One mod_auctionhousebot row for every house, the defaults of its base sql
+        std::array<double, AHB_CONFIG_COLUMN_MAX> settings{};
+
+        // AuctionHouseBot.* options
+        std::vector<std::pair<std::string, std::string>> options;
+    };
+
+    struct FillSample
+    {
+        uint32 hour;
+        uint32 houseId;
+        uint32 auctions;
+        uint32 botAuctions;
+    };
+
+    struct Result
+    {
+        Scenario scenario;
+        double indexMs{ 0 };
+        double botCpuSeconds{ 0 };
+        uint64 created{ 0 };
+        uint64 bids{ 0 };
+        uint64 buyouts{ 0 };
+        uint64 statements{ 0 };
+        uint64 sold{ 0 };
+        uint64 expired{ 0 };
+        double updateP50{ 0 };
+        double updateP99{ 0 };
+        double updateMax{ 0 };
+        double rssMB{ 0 };
+        double peakRssMB{ 0 };
+        std::vector<FillSample> fill;
+        uint32 tradeGoodsAuctions{ 0 };
+        uint64 tradeGoodsItems{ 0 };
+    };
+
+    std::array<double, AHB_CONFIG_COLUMN_MAX> DefaultSettings()
+    {
+        std::array<double, AHB_CONFIG_COLUMN_MAX> settings{};
+        settings[AHB_CONFIG_MIN_ITEMS] = 250;
+        settings[AHB_CONFIG_MAX_ITEMS] = 250;
+        settings[AHB_CONFIG_BID_INTERVAL] = 1;
+        settings[AHB_CONFIG_BIDS_PER_INTERVAL] = 1;
+
+        const std::array<double, AHB_MAX_QUALITY> percentages = { 0, 27, 12, 10, 1, 0, 0, 0, 10, 30, 8, 2, 0, 0 };
+        const std::array<double, AHB_DEFAULT_QUALITY_SIZE> minPrice = { 100, 150, 800, 1250, 2250, 3250, 5250 };
+        const std::array<double, AHB_DEFAULT_QUALITY_SIZE> maxPrice = { 150, 250, 1400, 1750, 4550, 5550, 6550 };
+        const std::array<double, AHB_DEFAULT_QUALITY_SIZE> minBidPrice = { 70, 70, 80, 75, 80, 80, 80 };
+        const std::array<double, AHB_DEFAULT_QUALITY_SIZE> maxStack = { 0, 0, 3, 2, 1, 1, 1 };
+        const std::array<double, AHB_DEFAULT_QUALITY_SIZE> buyerPrice = { 1, 3, 5, 12, 15, 20, 22 };
+
+        std::copy(percentages.begin(), percentages.end(), settings.begin() + AHB_CONFIG_PERCENT);
+
+        for (uint32 color = 0; color < AHB_DEFAULT_QUALITY_SIZE; ++color)
+        {
+            settings[AHB_CONFIG_MIN_PRICE + color] = minPrice[color];
+            settings[AHB_CONFIG_MAX_PRICE + color] = maxPrice[color];
+            settings[AHB_CONFIG_MIN_BID_PRICE + color] = minBidPrice[color];
+            settings[AHB_CONFIG_MAX_BID_PRICE + color] = 100;
+            settings[AHB_CONFIG_MAX_STACK + color] = maxStack[color];
+            settings[AHB_CONFIG_BUYER_PRICE + color] = buyerPrice[color];
+        }
+
+        return settings;
+    }
+
+    bool ParseScenario(std::string const& spec, Scenario& scenario)
+    {
+        scenario.settings = DefaultSettings();
+
+        const std::size_t colon = spec.find(':');
+        scenario.name = spec.substr(0, colon);
+        if (colon == std::string::npos)
+            return true;
+
+        std::size_t start = colon + 1;
+        while (start < spec.size())
+        {
+            std::size_t end = spec.find(',', start);
+            if (end == std::string::npos)
+                end = spec.size();
+
+            const std::string assignment = spec.substr(start, end - start);
+            start = end + 1;
+
+            const std::size_t equals = assignment.find('=');
+            if (equals == std::string::npos)
+                return false;
+
+            const std::string key = assignment.substr(0, equals);
+            const std::string value = assignment.substr(equals + 1);
+
+            if (key.starts_with("AuctionHouseBot."))
+            {
+                scenario.options.emplace_back(key, value);
+                continue;
+            }
+
+            if (key == "templates")
+                scenario.templates = std::stoul(value);
+            else if (key == "days")
+                scenario.days = std::stoul(value);
+            else if (key == "listings")
+                scenario.listings = std::stod(value);
+            else if (key == "playerbids")
+                scenario.playerBids = std::stod(value);
+            else if (key == "buyouts")
+                scenario.buyoutPercent = std::stoul(value);
+            else if (key == "twoside")
+                scenario.twoSide = value == "1";
+            else if (key == "bulkfill")
+                scenario.bulkFill = value == "1";
+            else
+            {
+                uint32 column = 0;
+                while (column < AHB_CONFIG_COLUMN_MAX && key != GetAHBConfigColumnName(column))
+                    ++column;
+
+                if (column == AHB_CONFIG_COLUMN_MAX)
+                    return false;
+
+                scenario.settings[column] = std::stod(value);
+            }
+        }
+
+        return true;
+    }
+
+    uint64 SumCounter(AHBMetricsSnapshot const& snapshot, AHBCounter counter)
+    {
+        uint64 sum = 0;
+        for (uint32 slot = 0; slot < AHB_METRIC_HOUSES; ++slot)
+            sum += snapshot.counters[slot][uint32(counter)];
+
+        return sum;
+    }
+
+    // The world and character tables the bot reads, answered from the scenario and the live houses
+    void RegisterDatabase(Scenario const& scenario)
+    {
+        WorldDatabase.SetHandler("SELECT minitems", [&scenario](std::string const&)
+        {
+            FakeRows rows(1);
+            for (double value : scenario.settings)
+                rows[0].emplace_back(value);
+
+            return rows;
+        });
+
+        CharacterDatabase.SetResult("SELECT 1 FROM characters", { { Field(1) } });
+
+        // Not limited to a house, like the buyer's query. Ids of other houses are skipped by the callback.
+        CharacterDatabase.SetHandler("SELECT id FROM auctionhouse WHERE itemowner<>", [](std::string const&)
+        {
+            FakeRows rows;
+            for (uint32 houseId : houses)
+            {
+                for (auto const& [id, auction] : sAuctionMgr->GetAuctionsMapByHouseId(houseId)->GetAuctions())
+                    if (auction->owner.GetCounter() != botGuid && !auction->bidder)
+                        rows.push_back({ Field(id) });
+
+                if (sWorld->getBoolConfig(CONFIG_ALLOW_TWO_SIDE_INTERACTION_AUCTION))
+                    break;
+            }
+
+            return rows;
+        });
+    }
+
+    // Synthetic players: list what they looted at a few times its vendor price, bid on what they find cheap
+    class Players
+    {
+    public:
+        Players(Scenario const& scenario, std::mt19937& rng) : _scenario(scenario), _rng(rng) { }
+
+        void Update(uint32 houseId)
+        {
+            AuctionHouseEntry const* ahEntry = sAuctionHouseStore.LookupEntry(houseId);
+            AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(ahEntry->faction);
+
+            std::poisson_distribution<uint32> listings(_scenario.listings / 60);
+            for (uint32 i = listings(_rng); i; --i)
+                List(ahEntry, auctionHouse);
+
+            std::poisson_distribution<uint32> bids(_scenario.playerBids / 60);
+            for (uint32 i = bids(_rng); i; --i)
+                Bid(auctionHouse);
+        }
+
+    private:
+        ObjectGuid RandomPlayer()
+        {
+            std::uniform_int_distribution<uint32> player(firstPlayerGuid, firstPlayerGuid + playerCount - 1);
+            return ObjectGuid::Create<HighGuid::Player>(player(_rng));
+        }
+
+        uint64 UnitValue(ItemTemplate const* proto) const
+        {
+            return proto->SellPrice ? proto->SellPrice : 1000;
+        }
+
+        void List(AuctionHouseEntry const* ahEntry, AuctionHouseObject* auctionHouse)
+        {
+            std::uniform_int_distribution<uint32> pickItem(1, _scenario.templates);
+            ItemTemplate const* proto = sObjectMgr->GetItemTemplate(pickItem(_rng));
+
+            std::uniform_int_distribution<uint32> stack(1, std::max(1u, std::min(proto->GetMaxStackSize(), 20u)));
+            Item* item = Item::CreateItem(proto->ItemId, stack(_rng));
+            if (!item)
+                return;
+
+            std::uniform_int_distribution<uint32> markup(150, 500);
+            std::uniform_int_distribution<uint32> duration(1, 3);
+
+            const uint32 lifeTime = duration(_rng) * 12 * HOUR;
+            AuctionEntry* auction = new AuctionEntry();
+            auction->Id = sObjectMgr->GenerateAuctionID();
+            auction->houseId = ahEntry->houseId;
+            auction->item_guid = item->GetGUID();
+            auction->item_template = proto->ItemId;
+            auction->itemCount = item->GetCount();
+            auction->owner = RandomPlayer();
+            auction->buyout = UnitValue(proto) * item->GetCount() * markup(_rng) / 100;
+            auction->startbid = auction->buyout * 4 / 5;
+            auction->deposit = AuctionHouseMgr::GetAuctionDeposit(ahEntry, lifeTime, item, item->GetCount());
+            auction->expire_time = GameTime::GetGameTime().count() + lifeTime;
+            auction->auctionHouseEntry = ahEntry;
+
+            CharacterDatabaseTransaction trans = CharacterDatabase.BeginTransaction();
+            item->SaveToDB(trans);
+            auction->SaveToDB(trans);
+            CharacterDatabase.CommitTransaction(trans);
+
+            sAuctionMgr->AddAItem(item);
+            auctionHouse->AddAuction(auction);
+        }
+
+        void Bid(AuctionHouseObject* auctionHouse)
+        {
+            auto const& auctions = auctionHouse->GetAuctions();
+            if (auctions.empty())
+                return;
+
+            // Not uniform over the auctions, but ids are dense enough and it is O(log n)
+            std::uniform_int_distribution<uint32> pickId(auctions.begin()->first, auctions.rbegin()->first);
+            AuctionEntry* auction = auctions.lower_bound(pickId(_rng))->second;
+
+            const ObjectGuid player = RandomPlayer();
+            if (auction->owner == player || auction->bidder == player)
+                return;
+
+            ItemTemplate const* proto = sObjectMgr->GetItemTemplate(auction->item_template);
+            std::uniform_int_distribution<uint32> willingness(100, 600);
+            const uint64 worth = UnitValue(proto) * auction->itemCount * willingness(_rng) / 100;
+
+            std::uniform_int_distribution<uint32> percent(0, 99);
+            const bool buyout = auction->buyout && percent(_rng) < _scenario.buyoutPercent;
+            const uint32 price = buyout ? auction->buyout : auction->bid ? auction->bid + auction->GetAuctionOutBid() : auction->startbid;
+
+            if (price > worth)
+                return;
+
+            CharacterDatabaseTransaction trans = CharacterDatabase.BeginTransaction();
+
+            if (auction->bidder)
+                sAuctionMgr->SendAuctionOutbiddedMail(auction, price, nullptr, trans);
+
+            auction->bidder = player;
+            auction->bid = price;
+
+            if (buyout || (auction->buyout && price >= auction->buyout))
+            {
+                sAuctionMgr->SendAuctionSuccessfulMail(auction, trans);
+                sAuctionMgr->SendAuctionWonMail(auction, trans);
+                auction->DeleteFromDB(trans);
+                sAuctionMgr->RemoveAItem(auction->item_guid);
+                auctionHouse->RemoveAuction(auction);
+            }
+            else
+                trans->Append("UPDATE auctionhouse SET buyguid");
+
+            CharacterDatabase.CommitTransaction(trans);
+        }
+
+        static constexpr uint32 HOUR = 3600;
+
+        Scenario const& _scenario;
+        std::mt19937& _rng;
+    };
+
+    Result Run(Scenario const& scenario, std::mt19937& rng)
+    {
+        Result result;
+        result.scenario = scenario;
+
+        if (sObjectMgr->GetItemTemplateStore()->size() != scenario.templates)
+        {
+            WorldDatabase.Clear();
+            GenerateItemTemplates(scenario.templates, rng);
+            GenerateWorldDatabase(scenario.templates, rng);
+        }
+
+        RegisterDatabase(scenario);
+        sAuctionMgr->Clear();
+        sWorld->setBoolConfig(CONFIG_ALLOW_TWO_SIDE_INTERACTION_AUCTION, scenario.twoSide);
+
+        sConfigMgr->Set("AuctionHouseBot.EnableSeller", "1");
+        sConfigMgr->Set("AuctionHouseBot.EnableBuyer", "1");
+        sConfigMgr->Set("AuctionHouseBot.Account", std::to_string(botAccount));
+        sConfigMgr->Set("AuctionHouseBot.GUID", std::to_string(botGuid));
+        for (auto const& [key, value] : scenario.options)
+            sConfigMgr->Set(key, value);
+
+        const auto indexStart = std::chrono::steady_clock::now();
+        sAHBot->InitializeConfiguration();
+        sAHBot->Initialize();
+        result.indexMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - indexStart).count();
+
+        const AHBMetricsSnapshot before = sAHMetrics->Read();
+        const uint64 statementsBefore = CharacterDatabase.GetStats().statements;
+
+        if (scenario.bulkFill)
+        {
+            for (uint32 houseId : houses)
+            {
+                sAHBot->FillHouse(houseId);
+                if (scenario.twoSide)
+                    break;
+            }
+        }
+
+        Players players(scenario, rng);
+        std::vector<double> updateMicroseconds;
+        std::clock_t botCpu = 0;
+
+        const Minutes duration = std::chrono::duration_cast<Minutes>(std::chrono::days(scenario.days));
+        const Milliseconds start = GameTime::GetGameTimeMS();
+
+        for (Minutes elapsed = 0min; elapsed <= duration; elapsed += auctionUpdateInterval)
+        {
+            GameTime::SetStubTime(start + elapsed);
+
+            for (uint32 houseId : houses)
+            {
+                players.Update(houseId);
+                if (scenario.twoSide)
+                    break;
+            }
+
+            const auto wallStart = std::chrono::steady_clock::now();
+            const std::clock_t cpuStart = std::clock();
+            sAHBot->Update();
+            botCpu += std::clock() - cpuStart;
+            updateMicroseconds.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - wallStart).count());
+
+            sAuctionMgr->Update();
+
+            if (elapsed.count() % 60 == 0)
+            {
+                const uint32 hour = elapsed.count() / 60;
+                for (uint32 houseId : houses)
+                {
+                    AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMapByHouseId(houseId);
+                    const uint32 botAuctions = std::count_if(auctionHouse->GetAuctions().begin(), auctionHouse->GetAuctions().end(),
+                        [](auto const& entry) { return entry.second->owner.GetCounter() == botGuid; });
+
+                    result.fill.push_back({ hour, houseId, auctionHouse->Getcount(), botAuctions });
+
+                    if (scenario.twoSide)
+                        break;
+                }
+            }
+        }
+
+        // Leaves time moving forward for the next scenario, the bot remembers when it last bid
+        GameTime::SetStubTime(start + duration + auctionUpdateInterval);
+
+        const AHBMetricsSnapshot after = sAHMetrics->Read();
+        result.botCpuSeconds = double(botCpu) / CLOCKS_PER_SEC;
+        result.created = SumCounter(after, AHBCounter::SellerItemsCreated) - SumCounter(before, AHBCounter::SellerItemsCreated);
+        result.bids = SumCounter(after, AHBCounter::BuyerBids) - SumCounter(before, AHBCounter::BuyerBids);
+        result.buyouts = SumCounter(after, AHBCounter::BuyerBuyouts) - SumCounter(before, AHBCounter::BuyerBuyouts);
+        result.statements = CharacterDatabase.GetStats().statements - statementsBefore;
+        result.sold = sAuctionMgr->GetStats().sold;
+        result.expired = sAuctionMgr->GetStats().expired;
+
+        for (uint32 houseId : houses)
+        {
+            for (auto const& [id, auction] : sAuctionMgr->GetAuctionsMapByHouseId(houseId)->GetAuctions())
+            {
+                ItemTemplate const* prototype = sObjectMgr->GetItemTemplate(auction->item_template);
+                if (auction->owner.GetCounter() != botGuid || !prototype || prototype->Class != ITEM_CLASS_TRADE_GOODS)
+                    continue;
+
+                ++result.tradeGoodsAuctions;
+                result.tradeGoodsItems += auction->itemCount;
+            }
+
+            if (scenario.twoSide)
+                break;
+        }
+
+        std::sort(updateMicroseconds.begin(), updateMicroseconds.end());
+        result.updateP50 = updateMicroseconds[updateMicroseconds.size() / 2];
+        result.updateP99 = updateMicroseconds[updateMicroseconds.size() * 99 / 100];
+        result.updateMax = updateMicroseconds.back();
+
+        result.rssMB = ResidentMB();
+        result.peakRssMB = PeakResidentMB();
+        return result;
+    }
+
+    void PrintFill(Result const& result)
+    {
+        const double maxItems = std::max(1.0, result.scenario.settings[AHB_CONFIG_MAX_ITEMS]);
+
+        std::printf("\n%s: auctions per house in %% of maxitems (bot auctions)\n", result.scenario.name.c_str());
+        std::printf("%6s", "hour");
+        for (uint32 houseId : houses)
+        {
+            std::printf("  %20u", houseId);
+            if (result.scenario.twoSide)
+                break;
+        }
+        std::printf("\n");
+
+        const uint32 housesPerHour = result.scenario.twoSide ? 1 : houses.size();
+        for (std::size_t i = 0; i < result.fill.size(); i += housesPerHour)
+        {
+            if (result.fill[i].hour % sampleHours)
+                continue;
+
+            std::printf("%6u", result.fill[i].hour);
+            for (uint32 house = 0; house < housesPerHour; ++house)
+            {
+                FillSample const& sample = result.fill[i + house];
+                std::printf("  %9.1f%% (%7u)", 100.0 * sample.auctions / maxItems, sample.botAuctions);
+            }
+            std::printf("\n");
+        }
+
+        std::printf("bot trade goods at the end: %u auctions, %llu items\n", result.tradeGoodsAuctions,
+            static_cast<unsigned long long>(result.tradeGoodsItems));
+    }
+
+    void WriteCsv(std::string const& path, std::vector<Result> const& results)
+    {
+        std::ofstream csv(path);
+        csv << "scenario,hour,house,auctions,bot_auctions,maxitems\n";
+
+        for (Result const& result : results)
+            for (FillSample const& sample : result.fill)
+                csv << result.scenario.name << ',' << sample.hour << ',' << sample.houseId << ',' << sample.auctions << ','
+                    << sample.botAuctions << ',' << result.scenario.settings[AHB_CONFIG_MAX_ITEMS] << '\n';
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string csvPath;
+    std::vector<Scenario> scenarios;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--csv" && i + 1 < argc)
+        {
+            csvPath = argv[++i];
+            continue;
+        }
+
+        Scenario scenario;
+        if (!ParseScenario(arg, scenario))
+        {
+            std::fprintf(stderr, "invalid scenario \"%s\", expected name:key=value,...\n", arg.c_str());
+            return 1;
+        }
+
+        scenarios.push_back(std::move(scenario));
+    }
+
+    if (scenarios.empty())
+    {
+        for (char const* spec : { "stock", "15k:maxitems=15000,minitems=15000,buyerbidsperinterval=10",
+            "15k-1000/cycle:maxitems=15000,minitems=15000,buyerbidsperinterval=10,AuctionHouseBot.ItemsPerCycle=1000" })
+        {
+            Scenario scenario;
+            ParseScenario(spec, scenario);
+            scenarios.push_back(std::move(scenario));
+        }
+    }
+
+    // Bot auctions expire at game time, which should look like a unix time
+    GameTime::SetStubTime(std::chrono::duration_cast<Milliseconds>(Seconds(1700000000)));
+    RegisterModuleHooks();
+
+    std::mt19937 rng(42);
+    std::vector<Result> results;
+
+    for (Scenario const& scenario : scenarios)
+    {
+        results.push_back(Run(scenario, rng));
+        PrintFill(results.back());
+    }
+
+    std::printf("\n%-16s %5s %9s %9s %9s %11s %7s %11s %9s %8s %8s %8s %8s %8s %8s %8s\n", "scenario", "days", "index ms", "bot cpu s",
+        "created", "created/s", "bids", "bids/s", "db stmts", "sold", "expired", "p50 us", "p99 us", "max us", "rss MB", "peak MB");
+
+    for (Result const& result : results)
+    {
+        const double cpu = std::max(result.botCpuSeconds, 1e-6);
+        const uint64 bids = result.bids + result.buyouts;
+
+        std::printf("%-16s %5u %9.0f %9.2f %9llu %11.0f %7llu %11.0f %9llu %8llu %8llu %8.0f %8.0f %8.0f %8.1f %8.1f\n",
+            result.scenario.name.c_str(), result.scenario.days, result.indexMs, result.botCpuSeconds,
+            static_cast<unsigned long long>(result.created), result.created / cpu,
+            static_cast<unsigned long long>(bids), bids / cpu, static_cast<unsigned long long>(result.statements),
+            static_cast<unsigned long long>(result.sold), static_cast<unsigned long long>(result.expired),
+            result.updateP50, result.updateP99, result.updateMax, result.rssMB, result.peakRssMB);
+    }
+
+    if (!csvPath.empty())
+        WriteCsv(csvPath, results);
+
+    return 0;
+}
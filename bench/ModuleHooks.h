@@ -0,0 +1,71 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AHB_BENCH_MODULE_HOOKS_H
+#define AHB_BENCH_MODULE_HOOKS_H
+
+#include "AuctionHouseBot.h"
+#include "AuctionHouseMgr.h"
+
+// What AuctionHouseBotScript.cpp does in the hooks the stubs call, without the script manager
+inline void RegisterModuleHooks()
+{
+    AuctionHouseHooks& hooks = sAuctionMgr->GetHooks();
+    hooks.OnAuctionAdd = [](AuctionHouseObject*, AuctionEntry* auction) { sAHBot->IncrementItemCounts(auction); };
+    hooks.OnAuctionRemove = [](AuctionHouseObject*, AuctionEntry* auction)
+    {
+        sAHBot->DecrementItemCounts(auction, auction->item_template);
+        sAHBot->RecordAuctionRemoved(auction);
+    };
+
+    hooks.OnBeforeSendAuctionSuccessfulMail = [](AuctionEntry* auction, uint32& profit, bool& sendMail)
+    {
+        sAHBot->RecordAuctionSale(auction);
+
+        if (auction->owner.GetCounter() == sAHBot->GetAHBplayerGUID() && sAHBot->RecordBotProceeds(auction, profit))
+            sendMail = false;
+    };
+
+    hooks.OnBeforeSendAuctionExpiredMail = [](AuctionEntry* auction, bool& sendMail)
+    {
+        if (auction->owner.GetCounter() == sAHBot->GetAHBplayerGUID() && sAHBot->SettleBotItem(auction))
+            sendMail = false;
+    };
+
+    hooks.OnBeforeSendAuctionWonMail = [](AuctionEntry* auction, bool& sendMail)
+    {
+        if (auction->bidder.GetCounter() == sAHBot->GetAHBplayerGUID() && sAHBot->SettleBotItem(auction))
+            sendMail = false;
+    };
+
+    hooks.OnBeforeSendAuctionOutbiddedMail = [](AuctionEntry* auction, bool& sendMail)
+    {
+        if (auction->bidder.GetCounter() == sAHBot->GetAHBplayerGUID() && sAHBot->IsDirectSettlement())
+            sendMail = false;
+    };
+
+    hooks.OnBeforeMailDraftSendMailTo = [](uint32 receiver, bool& deleteMailItemsFromDB, bool& sendMail)
+    {
+        if (receiver == sAHBot->GetAHBplayerGUID())
+        {
+            deleteMailItemsFromDB = true;
+            sendMail = false;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,154 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Seller pricing: the per item path the seller used before (override lookup, stddev and
+// distributions built for every item) against AHBPriceBatch, in items per second.
+
+#include "PriceKernel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+namespace
+{
+    constexpr uint32 templateCount = 20000;
+    constexpr uint32 overrideEvery = 10; // every 10th item has a price override
+    constexpr uint32 batchSize = 200;    // AuctionHouseBot.ItemsPerCycle default
+    constexpr uint32 totalItems = 2000000;
+
+    constexpr uint32 minBuyout = 150, maxBuyout = 250, minBid = 40, maxBid = 90;
+
+    struct Result
+    {
+        double itemsPerSecond;
+        double meanBuyout;
+        double meanBid;
+    };
+
+    std::optional<uint32> PerItemOverride(std::unordered_map<uint32, std::pair<uint32, uint32>> const& overrides, uint32 itemId, std::mt19937& rng)
+    {
+        const auto foundOverride = overrides.find(itemId);
+
+        if (foundOverride != overrides.end())
+        {
+            auto [meanPrice, minPrice] = foundOverride->second;
+
+            if (minPrice > meanPrice)
+                minPrice = meanPrice * 0.8;
+
+            float meanPriceF = meanPrice;
+            float minPriceF = minPrice;
+            float stdDev = std::max(1.f, meanPriceF - minPriceF) * 0.2f;
+            std::normal_distribution<float> x(meanPriceF, stdDev);
+            float randVal = x(rng);
+            return std::max(randVal, minPriceF);
+        }
+        return std::nullopt;
+    }
+
+    template<class Fn>
+    Result Run(Fn&& priceBatch)
+    {
+        uint64 buyoutSum = 0;
+        uint64 bidSum = 0;
+
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32 done = 0; done < totalItems; done += batchSize)
+            priceBatch(done, buyoutSum, bidSum);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        return { totalItems / seconds, double(buyoutSum) / totalItems, double(bidSum) / totalItems };
+    }
+}
+
+int main()
+{
+    std::vector<uint32> vendorPrice(templateCount);
+    std::unordered_map<uint32, std::pair<uint32, uint32>> rawOverrides;
+    std::unordered_map<uint32, AHBPriceOverride> overrides;
+
+    std::mt19937 setupRng(42);
+    std::uniform_int_distribution<uint32> price(1, 100000);
+    for (uint32 itemId = 0; itemId < templateCount; ++itemId)
+    {
+        vendorPrice[itemId] = price(setupRng);
+
+        if (itemId % overrideEvery == 0)
+        {
+            const uint32 mean = price(setupRng);
+            const uint32 min = mean / 2;
+            rawOverrides.emplace(itemId, std::pair{ mean, min });
+            overrides.emplace(itemId, AHBPriceOverride::Make(mean, min));
+        }
+    }
+
+    // Same item sequence for both paths
+    std::vector<uint32> items(totalItems);
+    std::uniform_int_distribution<uint32> pick(0, templateCount - 1);
+    for (uint32& itemId : items)
+        itemId = pick(setupRng);
+
+    std::mt19937 rng(7);
+    const Result perItem = Run([&](uint32 first, uint64& buyoutSum, uint64& bidSum)
+    {
+        for (uint32 i = first; i < first + batchSize; ++i)
+        {
+            uint64 basePrice = vendorPrice[items[i]];
+            if (const auto priceOverride = PerItemOverride(rawOverrides, items[i], rng))
+                basePrice = *priceOverride;
+
+            std::uniform_int_distribution<uint32> buyPriceMultiplier(minBuyout, maxBuyout);
+            std::uniform_int_distribution<uint32> bidPriceMultiplier(minBid, maxBid);
+            const uint64 buyoutPrice = basePrice * buyPriceMultiplier(rng) / 100;
+            const uint64 bidPrice = buyoutPrice * bidPriceMultiplier(rng) / 100;
+
+            buyoutSum += buyoutPrice;
+            bidSum += bidPrice;
+        }
+    });
+
+    AHBPriceBatch batch;
+    batch.Reserve(batchSize);
+    const Result batched = Run([&](uint32 first, uint64& buyoutSum, uint64& bidSum)
+    {
+        batch.Clear();
+        for (uint32 i = first; i < first + batchSize; ++i)
+        {
+            const auto found = overrides.find(items[i]);
+            batch.Add(vendorPrice[items[i]], found != overrides.end() ? &found->second : nullptr);
+        }
+
+        batch.Calculate(minBuyout, maxBuyout, minBid, maxBid, rng);
+
+        for (std::size_t i = 0; i < batch.Size(); ++i)
+        {
+            buyoutSum += batch.GetBuyout(i);
+            bidSum += batch.GetBid(i);
+        }
+    });
+
+    std::printf("%u items in batches of %u, %u templates, 1 in %u overridden\n", totalItems, batchSize, templateCount, overrideEvery);
+    std::printf("%-10s %14s %14s %14s\n", "path", "items/s", "mean buyout", "mean bid");
+    std::printf("%-10s %14.0f %14.1f %14.1f\n", "per item", perItem.itemsPerSecond, perItem.meanBuyout, perItem.meanBid);
+    std::printf("%-10s %14.0f %14.1f %14.1f\n", "batch", batched.itemsPerSecond, batched.meanBuyout, batched.meanBid);
+    std::printf("speedup %.2fx\n", batched.itemsPerSecond / perItem.itemsPerSecond);
+    return 0;
+}
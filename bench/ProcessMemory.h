@@ -0,0 +1,45 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AHB_BENCH_PROCESS_MEMORY_H
+#define AHB_BENCH_PROCESS_MEMORY_H
+
+#include "Define.h"
+#include <fstream>
+#include <sys/resource.h>
+#include <unistd.h>
+
+// Resident set of this process right now, in MB
+inline double ResidentMB()
+{
+    std::ifstream statm("/proc/self/statm");
+    uint64 size = 0, resident = 0;
+    if (!(statm >> size >> resident))
+        return 0;
+
+    return double(resident) * sysconf(_SC_PAGESIZE) / (1024 * 1024);
+}
+
+// Largest resident set this process had so far, in MB
+inline double PeakResidentMB()
+{
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0;
+}
+
+#endif
@@ -0,0 +1,134 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SyntheticWorld.h"
+
+#include "AuctionHouseMgr.h"
+#include "DatabaseEnv.h"
+#include "GameTime.h"
+#include "Item.h"
+#include "ObjectMgr.h"
+#include <algorithm>
+#include <array>
+
+void GenerateItemTemplates(uint32 count, std::mt19937& rng)
+{
+    static const std::array<double, MAX_ITEM_QUALITY> qualityWeights = { 16, 34, 28, 12, 8, 1, 0.2, 0.8 };
+    static const std::array<double, MAX_ITEM_CLASS> classWeights = { 8, 2, 18, 3, 40, 0.2, 0.5, 7, 0.1, 6, 0.3, 0.5, 9, 0.2, 0.1, 4, 1 };
+    std::discrete_distribution<uint32> quality(qualityWeights.begin(), qualityWeights.end());
+    std::discrete_distribution<uint32> itemClass(classWeights.begin(), classWeights.end());
+    std::discrete_distribution<uint32> bonding({ 45, 25, 25, 3, 2 });
+    std::uniform_int_distribution<uint32> level(1, 80);
+    std::uniform_int_distribution<uint32> price(1, 200000);
+    std::uniform_int_distribution<uint32> percent(0, 99);
+
+    ItemTemplateContainer& store = sObjectMgr->GetItemTemplateStoreForUpdate();
+    store.clear();
+    store.reserve(count);
+
+    for (uint32 itemId = 1; itemId <= count; ++itemId)
+    {
+        ItemTemplate& itemTemplate = store[itemId];
+        itemTemplate.ItemId = itemId;
+        itemTemplate.Class = itemClass(rng);
+        itemTemplate.Quality = quality(rng);
+        itemTemplate.Bonding = bonding(rng);
+        itemTemplate.ItemLevel = level(rng);
+        itemTemplate.RequiredLevel = percent(rng) < 70 ? itemTemplate.ItemLevel : 0;
+        itemTemplate.SellPrice = percent(rng) < 90 ? price(rng) : 0;
+        itemTemplate.BuyPrice = itemTemplate.SellPrice * 4;
+        itemTemplate.Stackable = itemTemplate.Class == ITEM_CLASS_TRADE_GOODS || itemTemplate.Class == ITEM_CLASS_CONSUMABLE ? 20 : 1;
+        itemTemplate.Duration = percent(rng) < 2 ? 3600 : 0;
+    }
+}
+
+void GenerateWorldDatabase(uint32 count, std::mt19937& rng)
+{
+    std::uniform_int_distribution<uint32> percent(0, 99);
+    std::uniform_int_distribution<uint32> price(1, 500000);
+    FakeRows vendor, loot, disabled, overrides, weights;
+
+    for (uint32 itemId = 1; itemId <= count; ++itemId)
+    {
+        if (percent(rng) < 10)
+            vendor.push_back({ Field(itemId) });
+        if (percent(rng) < 60)
+            loot.push_back({ Field(itemId) });
+        if (percent(rng) < 15)
+            disabled.push_back({ Field(itemId) });
+        if (itemId % AHB_SYNTHETIC_OVERRIDE_EVERY == 0)
+        {
+            const uint32 mean = price(rng);
+            overrides.push_back({ Field(itemId), Field(mean), Field(mean / 2) });
+        }
+        if (percent(rng) < 20)
+            weights.push_back({ Field(itemId), Field(1 + percent(rng)) });
+    }
+
+    WorldDatabase.SetResult("SELECT item FROM mod_auctionhousebot_disabled_items", std::move(disabled));
+    WorldDatabase.SetResult("SELECT distinct item FROM npc_vendor", std::move(vendor));
+    WorldDatabase.SetResult("SELECT item FROM creature_loot_template", std::move(loot));
+    WorldDatabase.SetResult("SELECT item, avgPrice, minPrice FROM mod_auctionhousebot_priceOverride", std::move(overrides));
+    WorldDatabase.SetResult("SELECT item, weight FROM mod_auctionhousebot_item_weights", std::move(weights));
+}
+
+void GenerateAuctions(uint32 houseId, uint32 count, uint32 botGuid, uint32 botPercent, std::mt19937& rng)
+{
+    constexpr uint32 firstPlayerGuid = 1000;
+    constexpr uint32 playerCount = 100000;
+
+    AuctionHouseEntry const* ahEntry = sAuctionHouseStore.LookupEntry(houseId);
+    AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMapByHouseId(houseId);
+
+    std::uniform_int_distribution<uint32> pickItem(1, sObjectMgr->GetItemTemplateStore()->size());
+    std::uniform_int_distribution<uint32> player(firstPlayerGuid, firstPlayerGuid + playerCount - 1);
+    std::uniform_int_distribution<uint32> percent(0, 99);
+    std::uniform_int_distribution<uint32> lifeTime(1, 48 * 3600);
+    std::uniform_int_distribution<uint32> price(1, 500000);
+    const uint32 now = GameTime::GetGameTime().count();
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        ItemTemplate const* proto = sObjectMgr->GetItemTemplate(pickItem(rng));
+        Item* item = Item::CreateItem(proto->ItemId, std::min(proto->GetMaxStackSize(), 1 + percent(rng) % 20));
+        if (!item)
+            continue;
+
+        const bool bot = percent(rng) < botPercent;
+
+        AuctionEntry* auction = new AuctionEntry();
+        auction->Id = sObjectMgr->GenerateAuctionID();
+        auction->houseId = houseId;
+        auction->item_guid = item->GetGUID();
+        auction->item_template = proto->ItemId;
+        auction->itemCount = item->GetCount();
+        auction->owner = ObjectGuid::Create<HighGuid::Player>(bot ? botGuid : player(rng));
+        auction->buyout = price(rng);
+        auction->startbid = auction->buyout / 2;
+        auction->expire_time = now + lifeTime(rng);
+        auction->auctionHouseEntry = ahEntry;
+
+        if (!bot && percent(rng) < 10)
+        {
+            auction->bidder = ObjectGuid::Create<HighGuid::Player>(player(rng));
+            auction->bid = auction->startbid;
+        }
+
+        sAuctionMgr->AddAItem(item);
+        auctionHouse->AddAuction(auction);
+    }
+}
@@ -0,0 +1,39 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AHB_BENCH_SYNTHETIC_WORLD_H
+#define AHB_BENCH_SYNTHETIC_WORLD_H
+
+#include "Define.h"
+#include <random>
+
+constexpr uint32 AHB_STOCK_TEMPLATE_COUNT = 37000;  // item_template rows of a stock 3.3.5 world database
+constexpr uint32 AHB_SYNTHETIC_OVERRIDE_EVERY = 10; // every 10th item has a price override
+
+// Fills sObjectMgr with item ids 1..count, roughly the shape of the stock item_template:
+// mostly armor and weapons, mostly white and green
+void GenerateItemTemplates(uint32 count, std::mt19937& rng);
+
+// Vendor, loot, disabled, price override and weight lists of WorldDatabase, their share of the
+// templates is about what it is for a stock database
+void GenerateWorldDatabase(uint32 count, std::mt19937& rng);
+
+// Adds count auctions of random templates to the house, as if the core had loaded them at startup:
+// botPercent of them are owned by botGuid, a tenth of the others has a bid
+void GenerateAuctions(uint32 houseId, uint32 count, uint32 botGuid, uint32 botPercent, std::mt19937& rng);
+
+#endif
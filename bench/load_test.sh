@@ -0,0 +1,182 @@
+#!/usr/bin/env bash
+#
+# Load test of the bot with large auction houses. For every scale it seeds a scratch database on a
+# local MySQL/MariaDB server with that many auctions per house (the core's auctionhouse and
+# item_instance tables), times what the database does for the worldserver's startup load, the
+# buyer's SELECT and ahexpire, then runs load_test for the module's side of the same paths:
+# LoadValues(), the buyer callback, the ahexpire job and memory. Everything ends up in one JSON file.
+#
+#   MYSQL="mysql -uroot -h127.0.0.1" bench/load_test.sh [output.json]
+#
+# Environment:
+#   MYSQL       client command and connection options (mysql)
+#   DATABASE    scratch database, dropped and recreated (ahbot_loadtest)
+#   SCALES      auctions per house (10000 100000 1000000)
+#   BOT_GUID    owner of the bot's auctions (1)
+#   BOT_PERCENT share of the auctions owned by the bot (50)
+#   LOAD_TEST   load_test binary, skipped if missing (bench/build/load_test)
+#
+# Times are wall clock around the client, so they include a connection, a few ms at most.
+
+set -euo pipefail
+
+MYSQL=${MYSQL:-mysql}
+DATABASE=${DATABASE:-ahbot_loadtest}
+SCALES=${SCALES:-10000 100000 1000000}
+BOT_GUID=${BOT_GUID:-1}
+BOT_PERCENT=${BOT_PERCENT:-50}
+LOAD_TEST=${LOAD_TEST:-$(dirname "$0")/build/load_test}
+OUTPUT=${1:-ahbot_load_test.json}
+
+HOUSES="2 6 7"
+
+sql() {
+    $MYSQL -N -B "$DATABASE" -e "$1"
+}
+
+# Runs the statement, prints how long it took in ms. Results are read and thrown away.
+timed() {
+    local start end
+    start=$(date +%s%N)
+    sql "$1" > /dev/null
+    end=$(date +%s%N)
+    echo $(( (end - start) / 1000000 ))
+}
+
+create_schema() {
+    $MYSQL -e "DROP DATABASE IF EXISTS \`$DATABASE\`; CREATE DATABASE \`$DATABASE\`"
+
+    # The core's tables, item_instance without the columns no query here reads
+    sql "CREATE TABLE auctionhouse (
+        id INT UNSIGNED NOT NULL DEFAULT 0,
+        houseid TINYINT UNSIGNED NOT NULL DEFAULT 7,
+        itemguid INT UNSIGNED NOT NULL DEFAULT 0,
+        itemowner INT UNSIGNED NOT NULL DEFAULT 0,
+        buyoutprice INT UNSIGNED NOT NULL DEFAULT 0,
+        time INT UNSIGNED NOT NULL DEFAULT 0,
+        buyguid INT UNSIGNED NOT NULL DEFAULT 0,
+        lastbid INT UNSIGNED NOT NULL DEFAULT 0,
+        startbid INT UNSIGNED NOT NULL DEFAULT 0,
+        deposit INT UNSIGNED NOT NULL DEFAULT 0,
+        PRIMARY KEY (id),
+        UNIQUE KEY item_guid (itemguid)
+    ) ENGINE=InnoDB"
+
+    sql "CREATE TABLE item_instance (
+        guid INT UNSIGNED NOT NULL DEFAULT 0,
+        itemEntry MEDIUMINT UNSIGNED NOT NULL DEFAULT 0,
+        owner_guid INT UNSIGNED NOT NULL DEFAULT 0,
+        creatorGuid INT UNSIGNED NOT NULL DEFAULT 0,
+        giftCreatorGuid INT UNSIGNED NOT NULL DEFAULT 0,
+        count INT UNSIGNED NOT NULL DEFAULT 1,
+        duration INT NOT NULL DEFAULT 0,
+        charges TINYTEXT,
+        flags MEDIUMINT UNSIGNED NOT NULL DEFAULT 0,
+        enchantments TEXT NOT NULL,
+        randomPropertyId SMALLINT NOT NULL DEFAULT 0,
+        durability SMALLINT UNSIGNED NOT NULL DEFAULT 0,
+        playedTime INT UNSIGNED NOT NULL DEFAULT 0,
+        text TEXT,
+        PRIMARY KEY (guid),
+        KEY idx_owner_guid (owner_guid)
+    ) ENGINE=InnoDB"
+
+    # 0..10^digits-1, enough rows to seed the largest scale from
+    local max=1 scale digits from="digits d0" terms="d0.d" factor=1 i
+    for scale in $SCALES; do
+        if [ "$scale" -gt "$max" ]; then
+            max=$scale
+        fi
+    done
+    digits=$(( max - 1 ))
+    digits=${#digits}
+
+    for (( i = 1; i < digits; i++ )); do
+        factor=$(( factor * 10 ))
+        from="$from, digits d$i"
+        terms="$terms + $factor * d$i.d"
+    done
+
+    sql "CREATE TABLE digits (d TINYINT UNSIGNED NOT NULL PRIMARY KEY);
+        INSERT INTO digits VALUES (0),(1),(2),(3),(4),(5),(6),(7),(8),(9);
+        CREATE TABLE seq (n INT UNSIGNED NOT NULL PRIMARY KEY);
+        INSERT INTO seq SELECT $terms FROM $from"
+}
+
+# Auction ids and item guids of a house start at house * 10000000
+seed() {
+    local auctions=$1 house offset
+    sql "TRUNCATE auctionhouse; TRUNCATE item_instance"
+
+    for house in $HOUSES; do
+        offset=$(( house * 10000000 ))
+        sql "INSERT INTO item_instance (guid, itemEntry, owner_guid, count, enchantments)
+            SELECT $offset + n, 1 + n % 37000, 0, 1 + n % 20, '' FROM seq WHERE n < $auctions"
+        sql "INSERT INTO auctionhouse (id, houseid, itemguid, itemowner, buyoutprice, time, buyguid, lastbid, startbid, deposit)
+            SELECT $offset + n, $house, $offset + n,
+                IF(n % 100 < $BOT_PERCENT, $BOT_GUID, 1000 + n % 100000),
+                1 + n % 500000, UNIX_TIMESTAMP() + n % 172800,
+                IF(n % 100 >= $BOT_PERCENT AND n % 10 = 0, 1000 + n % 99991, 0),
+                IF(n % 100 >= $BOT_PERCENT AND n % 10 = 0, 1 + n % 250000, 0),
+                1 + n % 250000, 100
+            FROM seq WHERE n < $auctions"
+    done
+
+    sql "ANALYZE TABLE auctionhouse, item_instance" > /dev/null
+}
+
+measure() {
+    local auctions=$1 module="null" table_mb load_auctions load_items buyer_rows buyer_select ahexpire
+
+    seed "$auctions"
+
+    table_mb=$(sql "SELECT ROUND(SUM(data_length + index_length) / 1048576, 1) FROM information_schema.tables
+        WHERE table_schema = '$DATABASE' AND table_name IN ('auctionhouse', 'item_instance')")
+
+    # What the worldserver reads at startup, before the bot's LoadValues() counts the houses
+    load_auctions=$(timed "SELECT id, houseid, itemguid, itemEntry, count, itemowner, buyoutprice, time, buyguid, lastbid, startbid, deposit
+        FROM auctionhouse ah INNER JOIN item_instance ii ON ii.guid = ah.itemguid")
+    load_items=$(timed "SELECT creatorGuid, giftCreatorGuid, count, duration, charges, flags, enchantments, randomPropertyId, durability,
+        playedTime, text, itemguid, itemEntry FROM auctionhouse ah JOIN item_instance ii ON ah.itemguid = ii.guid")
+
+    # The buyer's query, sent for every house every bid interval
+    buyer_rows=$(sql "SELECT COUNT(*) FROM auctionhouse WHERE itemowner<>$BOT_GUID AND buyguid<>$BOT_GUID AND buyguid=0")
+    buyer_select=$(timed "SELECT id FROM auctionhouse WHERE itemowner<>$BOT_GUID AND buyguid<>$BOT_GUID AND buyguid=0")
+
+    # ahexpire of one house, the statement QueueExpireJob() sends
+    ahexpire=$(timed "UPDATE auctionhouse SET time = UNIX_TIMESTAMP() WHERE itemowner = $BOT_GUID AND houseid = 7")
+
+    if [ -x "$LOAD_TEST" ]; then
+        "$LOAD_TEST" --json "$OUTPUT.module" --botpercent "$BOT_PERCENT" "$auctions" > /dev/null
+        module=$(cat "$OUTPUT.module")
+        rm -f "$OUTPUT.module"
+    fi
+
+    printf '  {"auctions_per_house": %s, "database": {"table_mb": %s, "load_auctions_ms": %s, "load_items_ms": %s, "buyer_rows": %s, "buyer_select_ms": %s, "ahexpire_ms": %s}, "module": %s}' \
+        "$auctions" "$table_mb" "$load_auctions" "$load_items" "$buyer_rows" "$buyer_select" "$ahexpire" "$module"
+}
+
+if [ ! -x "$LOAD_TEST" ]; then
+    echo "$LOAD_TEST not found, only the database is measured. Build it with:" >&2
+    echo "  cmake -S bench -B bench/build && cmake --build bench/build --target load_test" >&2
+fi
+
+create_schema
+
+{
+    printf '{"date": "%s", "server": "%s", "bot_percent": %s, "results": [\n' \
+        "$(date -u +%Y-%m-%dT%H:%M:%SZ)" "$(sql "SELECT VERSION()")" "$BOT_PERCENT"
+
+    first=1
+    for auctions in $SCALES; do
+        echo "Measuring $auctions auctions per house" >&2
+        [ $first -eq 1 ] || printf ',\n'
+        measure "$auctions"
+        first=0
+    done
+
+    printf '\n]}\n'
+} > "$OUTPUT.tmp"
+
+mv "$OUTPUT.tmp" "$OUTPUT"
+echo "Results written to $OUTPUT" >&2
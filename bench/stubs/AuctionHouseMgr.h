@@ -0,0 +1,375 @@
+/*
+ * Minimal stand-in for the core's AuctionHouseMgr.h, in-memory auction
+ * houses that expire and settle auctions and call the hooks the module's
+ * scripts are registered for, so the module can be simulated without an
+ * AzerothCore tree.
+ */
+
+#ifndef AHB_BENCH_AUCTION_HOUSE_MGR_H
+#define AHB_BENCH_AUCTION_HOUSE_MGR_H
+
+#include "DatabaseEnv.h"
+#include "GameTime.h"
+#include "Item.h"
+#include "World.h"
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+class Player;
+
+enum AuctionHouses
+{
+    AUCTIONHOUSE_ALLIANCE = 2,
+    AUCTIONHOUSE_HORDE = 6,
+    AUCTIONHOUSE_NEUTRAL = 7
+};
+
+constexpr uint32 AH_MINIMUM_DEPOSIT = 100;
+
+struct AuctionHouseEntry
+{
+    uint32 houseId;
+    uint32 faction;
+    uint32 depositPercent;
+    uint32 cutPercent;
+};
+
+template<class T>
+class DBCStorage
+{
+public:
+    explicit DBCStorage(std::unordered_map<uint32, T> entries) : _entries(std::move(entries)) { }
+
+    T const* LookupEntry(uint32 id) const
+    {
+        const auto found = _entries.find(id);
+        return found != _entries.end() ? &found->second : nullptr;
+    }
+
+private:
+    std::unordered_map<uint32, T> _entries;
+};
+
+// AuctionHouse.dbc, only the houses the module uses
+inline DBCStorage<AuctionHouseEntry> sAuctionHouseStore({
+    { AUCTIONHOUSE_ALLIANCE, { AUCTIONHOUSE_ALLIANCE, 55, 15, 5 } },
+    { AUCTIONHOUSE_HORDE, { AUCTIONHOUSE_HORDE, 29, 15, 5 } },
+    { AUCTIONHOUSE_NEUTRAL, { AUCTIONHOUSE_NEUTRAL, 120, 75, 15 } } });
+
+struct AuctionEntry
+{
+    uint32 Id{ 0 };
+    uint8 houseId{ 0 };
+    ObjectGuid item_guid;
+    uint32 item_template{ 0 };
+    uint32 itemCount{ 0 };
+    ObjectGuid owner;
+    uint32 startbid{ 0 };
+    uint32 bid{ 0 };
+    uint32 buyout{ 0 };
+    time_t expire_time{ 0 };
+    ObjectGuid bidder;
+    uint32 deposit{ 0 };
+    AuctionHouseEntry const* auctionHouseEntry{ nullptr };
+
+    uint8 GetHouseId() const { return houseId; }
+
+    uint32 GetAuctionCut() const { return uint32(uint64(bid) * auctionHouseEntry->cutPercent / 100); }
+
+    uint32 GetAuctionOutBid() const
+    {
+        const uint32 outbid = uint32(uint64(bid) * 5 / 100);
+        return outbid ? outbid : 1;
+    }
+
+    void SaveToDB(CharacterDatabaseTransaction trans) const { trans->Append("INSERT INTO auctionhouse"); }
+    void DeleteFromDB(CharacterDatabaseTransaction trans) const { trans->Append("DELETE FROM auctionhouse"); }
+};
+
+// What the core's ScriptMgr would call, the simulation points them at the module like its scripts do
+struct AuctionHouseHooks
+{
+    std::function<void(class AuctionHouseObject*, AuctionEntry*)> OnAuctionAdd;
+    std::function<void(class AuctionHouseObject*, AuctionEntry*)> OnAuctionRemove;
+    std::function<void(AuctionEntry*, uint32& profit, bool& sendMail)> OnBeforeSendAuctionSuccessfulMail;
+    std::function<void(AuctionEntry*, bool& sendMail)> OnBeforeSendAuctionWonMail;
+    std::function<void(AuctionEntry*, bool& sendMail)> OnBeforeSendAuctionExpiredMail;
+    std::function<void(AuctionEntry*, bool& sendMail)> OnBeforeSendAuctionOutbiddedMail;
+
+    // MailScript::OnBeforeMailDraftSendMailTo() of the mails above
+    std::function<void(uint32 receiver, bool& deleteMailItemsFromDB, bool& sendMail)> OnBeforeMailDraftSendMailTo;
+};
+
+class AuctionHouseObject
+{
+public:
+    typedef std::map<uint32, AuctionEntry*> AuctionEntryMap;
+
+    explicit AuctionHouseObject(AuctionHouseHooks const& hooks) : _hooks(hooks) { }
+    ~AuctionHouseObject() { Clear(); }
+
+    uint32 Getcount() const { return _auctionsMap.size(); }
+    AuctionEntryMap const& GetAuctions() const { return _auctionsMap; }
+
+    AuctionEntry* GetAuction(uint32 id) const
+    {
+        const auto found = _auctionsMap.find(id);
+        return found != _auctionsMap.end() ? found->second : nullptr;
+    }
+
+    void AddAuction(AuctionEntry* auction)
+    {
+        _auctionsMap[auction->Id] = auction;
+
+        if (_hooks.OnAuctionAdd)
+            _hooks.OnAuctionAdd(this, auction);
+    }
+
+    bool RemoveAuction(AuctionEntry* auction)
+    {
+        const bool wasInMap = _auctionsMap.erase(auction->Id) != 0;
+
+        if (_hooks.OnAuctionRemove)
+            _hooks.OnAuctionRemove(this, auction);
+
+        delete auction;
+        return wasInMap;
+    }
+
+    // Auctions whose time ran out. A scan of the whole house every call, like the core's
+    // AuctionHouseObject::Update(), so expire times lowered by ahexpire are seen too.
+    template<class Fn>
+    void ForEachExpired(time_t now, Fn&& fn)
+    {
+        std::vector<AuctionEntry*> expired;
+        for (auto const& [id, auction] : _auctionsMap)
+            if (auction->expire_time <= now)
+                expired.push_back(auction);
+
+        for (AuctionEntry* auction : expired)
+            fn(auction);
+    }
+
+    // Without the hooks, the simulation starts every run with empty houses
+    void Clear()
+    {
+        for (auto const& [id, auction] : _auctionsMap)
+            delete auction;
+
+        _auctionsMap.clear();
+    }
+
+private:
+    AuctionHouseHooks const& _hooks;
+    AuctionEntryMap _auctionsMap;
+};
+
+struct AuctionHouseMgrStats
+{
+    uint64 sold{ 0 };
+    uint64 expired{ 0 };
+    uint64 mails{ 0 };
+};
+
+class AuctionHouseMgr
+{
+public:
+    static AuctionHouseMgr* instance()
+    {
+        static AuctionHouseMgr instance;
+        return &instance;
+    }
+
+    AuctionHouseHooks& GetHooks() { return _hooks; }
+    AuctionHouseMgrStats const& GetStats() const { return _stats; }
+
+    AuctionHouseObject* GetAuctionsMap(uint32 factionTemplateId)
+    {
+        if (sWorld->getBoolConfig(CONFIG_ALLOW_TWO_SIDE_INTERACTION_AUCTION))
+            return &_neutralAuctions;
+
+        switch (factionTemplateId)
+        {
+            case 55: return &_allianceAuctions;
+            case 29: return &_hordeAuctions;
+            default: return &_neutralAuctions;
+        }
+    }
+
+    AuctionHouseObject* GetAuctionsMapByHouseId(uint32 houseId)
+    {
+        return GetAuctionsMap(sAuctionHouseStore.LookupEntry(houseId)->faction);
+    }
+
+    static AuctionHouseEntry const* GetAuctionHouseEntry(uint32 factionTemplateId)
+    {
+        uint32 houseId = AUCTIONHOUSE_NEUTRAL;
+        if (!sWorld->getBoolConfig(CONFIG_ALLOW_TWO_SIDE_INTERACTION_AUCTION))
+            houseId = factionTemplateId == 55 ? AUCTIONHOUSE_ALLIANCE : factionTemplateId == 29 ? AUCTIONHOUSE_HORDE : AUCTIONHOUSE_NEUTRAL;
+
+        return sAuctionHouseStore.LookupEntry(houseId);
+    }
+
+    static uint32 GetAuctionDeposit(AuctionHouseEntry const* entry, uint32 time, Item* pItem, uint32 count)
+    {
+        const uint32 sellPrice = pItem->GetTemplate()->SellPrice;
+        if (!sellPrice)
+            return AH_MINIMUM_DEPOSIT;
+
+        const float multiplier = float(entry->depositPercent) * 3 / 100;
+        const uint32 timeHr = time / HOUR_SECONDS / 12;
+        return std::max(uint32(multiplier * sellPrice * count / 3 * timeHr * 3), AH_MINIMUM_DEPOSIT);
+    }
+
+    Item* GetAItem(ObjectGuid itemGuid)
+    {
+        const auto found = _items.find(itemGuid.GetCounter());
+        return found != _items.end() ? found->second : nullptr;
+    }
+
+    void AddAItem(Item* item) { _items[item->GetGUID().GetCounter()] = item; }
+
+    // Like the core, only forgets the item, a mail or whoever took it out before frees it
+    bool RemoveAItem(ObjectGuid itemGuid, bool /*deleteFromDB*/ = false)
+    {
+        return _items.erase(itemGuid.GetCounter()) != 0;
+    }
+
+    void SendAuctionWonMail(AuctionEntry* auction, CharacterDatabaseTransaction trans, bool = true, bool = true)
+    {
+        Item* item = GetAItem(auction->item_guid);
+        if (!item)
+            return;
+
+        bool sendMail = true;
+        if (_hooks.OnBeforeSendAuctionWonMail)
+            _hooks.OnBeforeSendAuctionWonMail(auction, sendMail);
+
+        trans->Append("UPDATE item_instance SET owner_guid");
+
+        if (sendMail)
+            SendMail(auction->bidder, item, trans);
+    }
+
+    void SendAuctionExpiredMail(AuctionEntry* auction, CharacterDatabaseTransaction trans, bool = true, bool = true)
+    {
+        Item* item = GetAItem(auction->item_guid);
+        if (!item)
+            return;
+
+        bool sendMail = true;
+        if (_hooks.OnBeforeSendAuctionExpiredMail)
+            _hooks.OnBeforeSendAuctionExpiredMail(auction, sendMail);
+
+        if (sendMail)
+            SendMail(auction->owner, item, trans);
+    }
+
+    void SendAuctionOutbiddedMail(AuctionEntry* auction, uint32 /*newPrice*/, Player* /*newBidder*/, CharacterDatabaseTransaction trans, bool = true, bool = true)
+    {
+        bool sendMail = true;
+        if (_hooks.OnBeforeSendAuctionOutbiddedMail)
+            _hooks.OnBeforeSendAuctionOutbiddedMail(auction, sendMail);
+
+        if (sendMail)
+            SendMail(auction->bidder, nullptr, trans);
+    }
+
+    void SendAuctionSuccessfulMail(AuctionEntry* auction, CharacterDatabaseTransaction trans, bool = true, bool = true)
+    {
+        uint32 profit = auction->bid + auction->deposit - auction->GetAuctionCut();
+        bool sendMail = true;
+        if (_hooks.OnBeforeSendAuctionSuccessfulMail)
+            _hooks.OnBeforeSendAuctionSuccessfulMail(auction, profit, sendMail);
+
+        if (sendMail)
+            SendMail(auction->owner, nullptr, trans);
+    }
+
+    // Settles every auction whose time ran out, like the core's AuctionHouseObject::Update()
+    void Update()
+    {
+        const time_t now = GameTime::GetGameTime().count();
+
+        for (AuctionHouseObject* auctionHouse : { &_allianceAuctions, &_hordeAuctions, &_neutralAuctions })
+        {
+            auctionHouse->ForEachExpired(now, [&](AuctionEntry* auction)
+            {
+                CharacterDatabaseTransaction trans = CharacterDatabase.BeginTransaction();
+
+                if (auction->bidder)
+                {
+                    SendAuctionSuccessfulMail(auction, trans);
+                    SendAuctionWonMail(auction, trans);
+                    ++_stats.sold;
+                }
+                else
+                {
+                    SendAuctionExpiredMail(auction, trans);
+                    ++_stats.expired;
+                }
+
+                auction->DeleteFromDB(trans);
+                RemoveAItem(auction->item_guid);
+                auctionHouse->RemoveAuction(auction);
+                CharacterDatabase.CommitTransaction(trans);
+            });
+        }
+    }
+
+    void Clear()
+    {
+        for (AuctionHouseObject* auctionHouse : { &_allianceAuctions, &_hordeAuctions, &_neutralAuctions })
+            auctionHouse->Clear();
+
+        for (auto const& [guid, item] : _items)
+            delete item;
+
+        _items.clear();
+        _stats = {};
+    }
+
+private:
+    static constexpr uint32 HOUR_SECONDS = 3600;
+
+    // MailDraft::SendMailTo(). The mail would own the item, nobody reads the mails here so it is freed.
+    void SendMail(ObjectGuid receiver, Item* item, CharacterDatabaseTransaction trans)
+    {
+        bool deleteMailItemsFromDB = false;
+        bool sendMail = true;
+        if (_hooks.OnBeforeMailDraftSendMailTo)
+            _hooks.OnBeforeMailDraftSendMailTo(receiver.GetCounter(), deleteMailItemsFromDB, sendMail);
+
+        if (item)
+        {
+            if (deleteMailItemsFromDB)
+                item->DeleteFromDB(trans);
+
+            _items.erase(item->GetGUID().GetCounter());
+            delete item;
+        }
+
+        if (!sendMail)
+            return;
+
+        trans->Append("INSERT INTO mail");
+        if (item)
+            trans->Append("INSERT INTO mail_items");
+
+        ++_stats.mails;
+    }
+
+    AuctionHouseHooks _hooks;
+    AuctionHouseObject _allianceAuctions{ _hooks };
+    AuctionHouseObject _hordeAuctions{ _hooks };
+    AuctionHouseObject _neutralAuctions{ _hooks };
+    std::unordered_map<uint32, Item*> _items;
+    AuctionHouseMgrStats _stats;
+};
+
+#define sAuctionMgr AuctionHouseMgr::instance()
+
+#endif
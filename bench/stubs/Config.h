@@ -0,0 +1,47 @@
+/*
+ * Minimal stand-in for the core's Config.h, so the module's
+ * kernels can be built and benchmarked without an AzerothCore tree.
+ */
+
+#ifndef AHB_BENCH_CONFIG_H
+#define AHB_BENCH_CONFIG_H
+
+#include <string>
+#include <unordered_map>
+
+// Options the benchmark set, everything else has its default
+class ConfigMgr
+{
+public:
+    static ConfigMgr* instance()
+    {
+        static ConfigMgr instance;
+        return &instance;
+    }
+
+    void Set(std::string const& name, std::string value) { _options[name] = std::move(value); }
+
+    template<class T>
+    T GetOption(std::string const& name, T const& def, bool /*showLogs*/ = true) const
+    {
+        const auto found = _options.find(name);
+        if (found == _options.end())
+            return def;
+
+        if constexpr (std::is_same_v<T, std::string>)
+            return found->second;
+        else if constexpr (std::is_same_v<T, bool>)
+            return found->second == "1" || found->second == "true";
+        else if constexpr (std::is_floating_point_v<T>)
+            return T(std::stod(found->second));
+        else
+            return T(std::stoll(found->second));
+    }
+
+private:
+    std::unordered_map<std::string, std::string> _options;
+};
+
+#define sConfigMgr ConfigMgr::instance()
+
+#endif
@@ -0,0 +1,172 @@
+/*
+ * Minimal stand-in for the core's DatabaseEnv.h, an in-memory database that
+ * answers queries from registered rows or handlers and only counts writes.
+ */
+
+#ifndef AHB_BENCH_DATABASE_ENV_H
+#define AHB_BENCH_DATABASE_ENV_H
+
+#include "DatabaseEnvFwd.h"
+#include "Define.h"
+#include "StringFormat.h"
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+class Field
+{
+public:
+    Field() = default;
+    Field(std::string value) : _text(std::move(value)), _isText(true) { }
+    Field(double value) : _number(value) { }
+
+    template<class T>
+    T Get() const
+    {
+        if constexpr (std::is_same_v<T, std::string>)
+            return _isText ? _text : std::to_string(_number);
+        else if (_isText)
+        {
+            if constexpr (std::is_floating_point_v<T>)
+                return T(std::stod(_text));
+            else
+                return T(std::stoll(_text));
+        }
+        else
+            return T(_number);
+    }
+
+private:
+    std::string _text;
+    double _number{ 0 };
+    bool _isText{ false };
+};
+
+typedef std::vector<std::vector<Field>> FakeRows;
+
+class ResultSet
+{
+public:
+    explicit ResultSet(FakeRows rows) : _rows(std::move(rows)) { }
+
+    Field const* Fetch() const { return _rows[_row].data(); }
+    bool NextRow() { return ++_row < _rows.size(); }
+    uint64 GetRowCount() const { return _rows.size(); }
+
+private:
+    FakeRows _rows;
+    std::size_t _row{ 0 };
+};
+
+class Transaction
+{
+public:
+    template<class... Args>
+    void Append(std::string_view /*sql*/, Args&&... /*args*/) { ++_size; }
+
+    std::size_t GetSize() const { return _size; }
+
+private:
+    std::size_t _size{ 0 };
+};
+
+struct FakeDatabaseStats
+{
+    uint64 queries{ 0 };
+    uint64 asyncQueries{ 0 };
+    uint64 statements{ 0 };     // Execute() and every statement of a committed transaction
+    uint64 transactions{ 0 };
+};
+
+// Answers a query with the rows registered for the longest prefix of its text, nothing is ever written
+class FakeDatabase
+{
+public:
+    typedef std::function<FakeRows(std::string const& query)> Handler;
+
+    void SetResult(std::string queryPrefix, FakeRows rows)
+    {
+        _handlers[std::move(queryPrefix)] = [rows = std::move(rows)](std::string const&) { return rows; };
+    }
+
+    // For results that depend on the state of the simulation when the query is issued
+    void SetHandler(std::string queryPrefix, Handler handler) { _handlers[std::move(queryPrefix)] = std::move(handler); }
+
+    void Clear() { _handlers.clear(); }
+
+    FakeDatabaseStats const& GetStats() const { return _stats; }
+
+    template<class... Args>
+    QueryResult Query(std::string_view sql, Args&&... args)
+    {
+        ++_stats.queries;
+        return Answer(Format(sql, std::forward<Args>(args)...));
+    }
+
+    QueryCallback AsyncQuery(std::string_view sql)
+    {
+        ++_stats.asyncQueries;
+        return QueryCallback(Answer(std::string(sql)));
+    }
+
+    template<class... Args>
+    void Execute(std::string_view /*sql*/, Args&&... /*args*/) { ++_stats.statements; }
+
+    template<class... Args>
+    void DirectExecute(std::string_view /*sql*/, Args&&... /*args*/) { ++_stats.statements; }
+
+    std::shared_ptr<Transaction> BeginTransaction() { return std::make_shared<Transaction>(); }
+
+    void CommitTransaction(std::shared_ptr<Transaction> trans)
+    {
+        ++_stats.transactions;
+        _stats.statements += trans->GetSize();
+    }
+
+    void DirectCommitTransaction(std::shared_ptr<Transaction>& trans) { CommitTransaction(trans); }
+
+    void EscapeString(std::string& /*str*/) { }
+
+private:
+    template<class... Args>
+    static std::string Format(std::string_view sql, Args&&... args)
+    {
+        if constexpr (sizeof...(Args) > 0)
+            return fmt::format(fmt::runtime(sql), std::forward<Args>(args)...);
+        else
+            return std::string(sql);
+    }
+
+    QueryResult Answer(std::string const& query) const
+    {
+        Handler const* handler = nullptr;
+        std::size_t matched = 0;
+
+        for (auto const& [prefix, candidate] : _handlers)
+        {
+            if (prefix.size() > matched && query.starts_with(prefix))
+            {
+                handler = &candidate;
+                matched = prefix.size();
+            }
+        }
+
+        if (!handler)
+            return nullptr;
+
+        FakeRows rows = (*handler)(query);
+        if (rows.empty())
+            return nullptr;
+
+        return std::make_shared<ResultSet>(std::move(rows));
+    }
+
+    std::unordered_map<std::string, Handler> _handlers;
+    FakeDatabaseStats _stats;
+};
+
+inline FakeDatabase WorldDatabase;
+inline FakeDatabase CharacterDatabase;
+
+#endif
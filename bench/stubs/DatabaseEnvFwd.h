@@ -0,0 +1,62 @@
+/*
+ * Minimal stand-in for the core's DatabaseEnvFwd.h, so the module can be
+ * benchmarked and simulated without an AzerothCore tree.
+ */
+
+#ifndef AHB_BENCH_DATABASE_ENV_FWD_H
+#define AHB_BENCH_DATABASE_ENV_FWD_H
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+class ResultSet;
+typedef std::shared_ptr<ResultSet> QueryResult;
+
+class Transaction;
+typedef std::shared_ptr<Transaction> CharacterDatabaseTransaction;
+typedef std::shared_ptr<Transaction> WorldDatabaseTransaction;
+
+// The result is produced when the query is issued, the callback runs on a later ProcessReadyCallbacks(),
+// the way a worker thread's result is usually not there before the next world update
+class QueryCallback
+{
+public:
+    explicit QueryCallback(QueryResult result) : _result(std::move(result)) { }
+
+    QueryCallback&& WithCallback(std::function<void(QueryResult)> callback) &&
+    {
+        _callback = std::move(callback);
+        return std::move(*this);
+    }
+
+    void Invoke() { _callback(std::move(_result)); }
+
+private:
+    QueryResult _result;
+    std::function<void(QueryResult)> _callback;
+};
+
+class QueryCallbackProcessor
+{
+public:
+    void AddCallback(QueryCallback&& callback) { _pending.push_back(std::move(callback)); }
+
+    void ProcessReadyCallbacks()
+    {
+        std::vector<QueryCallback> ready = std::move(_ready);
+        _ready = std::move(_pending);
+        _pending.clear();
+
+        for (QueryCallback& callback : ready)
+            callback.Invoke();
+    }
+
+    std::size_t Size() const { return _pending.size() + _ready.size(); }
+
+private:
+    std::vector<QueryCallback> _pending;
+    std::vector<QueryCallback> _ready;
+};
+
+#endif
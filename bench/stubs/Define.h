@@ -0,0 +1,24 @@
+/*
+ * Minimal stand-in for the core's Define.h, so the module's std-only kernels
+ * can be built and benchmarked without an AzerothCore tree.
+ */
+
+#ifndef AHB_BENCH_DEFINE_H
+#define AHB_BENCH_DEFINE_H
+
+#include <cassert>
+#include <cstdint>
+
+typedef std::int64_t int64;
+typedef std::int32_t int32;
+typedef std::int16_t int16;
+typedef std::int8_t int8;
+typedef std::uint64_t uint64;
+typedef std::uint32_t uint32;
+typedef std::uint16_t uint16;
+typedef std::uint8_t uint8;
+
+// The core's Errors.h asserts in release builds too, a benchmark does not need to
+#define WPAssert(cond, ...) assert(cond)
+
+#endif
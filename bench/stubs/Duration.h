@@ -0,0 +1,19 @@
+/*
+ * Minimal stand-in for the core's Duration.h, so the module's
+ * kernels can be built and benchmarked without an AzerothCore tree.
+ */
+
+#ifndef AHB_BENCH_DURATION_H
+#define AHB_BENCH_DURATION_H
+
+#include <chrono>
+
+using Microseconds = std::chrono::microseconds;
+using Milliseconds = std::chrono::milliseconds;
+using Seconds = std::chrono::seconds;
+using Minutes = std::chrono::minutes;
+using Hours = std::chrono::hours;
+
+using namespace std::chrono_literals;
+
+#endif
@@ -0,0 +1,25 @@
+/*
+ * Minimal stand-in for the core's GameTime.h, a clock that only moves when
+ * the simulation advances it.
+ */
+
+#ifndef AHB_BENCH_GAME_TIME_H
+#define AHB_BENCH_GAME_TIME_H
+
+#include "Duration.h"
+
+namespace GameTime
+{
+    inline Milliseconds& GetStubTime()
+    {
+        static Milliseconds now{ 0 };
+        return now;
+    }
+
+    inline void SetStubTime(Milliseconds now) { GetStubTime() = now; }
+
+    inline Seconds GetGameTime() { return std::chrono::duration_cast<Seconds>(GetStubTime()); }
+    inline Milliseconds GetGameTimeMS() { return GetStubTime(); }
+}
+
+#endif
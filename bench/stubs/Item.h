@@ -0,0 +1,99 @@
+/*
+ * Minimal stand-in for the core's Item.h, items that only know their
+ * template and stack size, so the module can be simulated without an
+ * AzerothCore tree.
+ */
+
+#ifndef AHB_BENCH_ITEM_H
+#define AHB_BENCH_ITEM_H
+
+#include "DatabaseEnv.h"
+#include "ObjectGuid.h"
+#include "ObjectMgr.h"
+
+class Player;
+
+enum EnchantmentSlot
+{
+    PERM_ENCHANTMENT_SLOT,
+    MAX_ENCHANTMENT_SLOT = 12
+};
+
+enum ItemFields
+{
+    ITEM_FIELD_DURATION,
+    ITEM_FIELD_FLAGS,
+    ITEM_FIELD_DURABILITY
+};
+
+enum ItemUpdateState
+{
+    ITEM_UNCHANGED,
+    ITEM_CHANGED,
+    ITEM_NEW,
+    ITEM_REMOVED
+};
+
+class Item
+{
+public:
+    virtual ~Item() = default;
+
+    static Item* CreateItem(uint32 item, uint32 count, Player const* /*player*/ = nullptr)
+    {
+        ItemTemplate const* proto = sObjectMgr->GetItemTemplate(item);
+        if (!proto || !count)
+            return nullptr;
+
+        Item* created = new Item();
+        created->_guid = ObjectGuid::Create<HighGuid::Item>(sObjectMgr->GenerateItemLowGuid());
+        created->_template = proto;
+        created->_count = count;
+        return created;
+    }
+
+    static int32 GenerateItemRandomPropertyId(uint32 /*itemId*/) { return 0; }
+    void SetItemRandomProperties(int32 /*randomPropId*/) { }
+
+    void AddToUpdateQueueOf(Player* /*player*/) { }
+    void RemoveFromUpdateQueueOf(Player* /*player*/) { }
+    void FSetState(ItemUpdateState state) { _state = state; }
+    void SetState(ItemUpdateState state, Player* /*forplayer*/ = nullptr) { _state = state; }
+    ItemUpdateState GetState() const { return _state; }
+
+    ObjectGuid GetGUID() const { return _guid; }
+    uint32 GetEntry() const { return _template->ItemId; }
+    ItemTemplate const* GetTemplate() const { return _template; }
+
+    uint32 GetCount() const { return _count; }
+    void SetCount(uint32 count) { _count = count; }
+
+    // No enchantments, charges or durability, only what a bulk insert of the items reads
+    uint32 GetEnchantmentId(EnchantmentSlot /*slot*/) const { return 0; }
+    uint32 GetEnchantmentDuration(EnchantmentSlot /*slot*/) const { return 0; }
+    uint32 GetEnchantmentCharges(EnchantmentSlot /*slot*/) const { return 0; }
+    int32 GetSpellCharges(uint8 /*index*/ = 0) const { return 0; }
+    int32 GetItemRandomPropertyId() const { return 0; }
+
+    uint32 GetUInt32Value(uint16 index) const
+    {
+        switch (index)
+        {
+            case ITEM_FIELD_DURATION: return _template->Duration;
+            case ITEM_FIELD_FLAGS: return _template->Flags;
+            default: return 0;
+        }
+    }
+
+    void SaveToDB(CharacterDatabaseTransaction trans) { trans->Append("REPLACE INTO item_instance"); }
+    void DeleteFromDB(CharacterDatabaseTransaction trans) { trans->Append("DELETE FROM item_instance"); }
+    static void DeleteFromDB(CharacterDatabaseTransaction trans, ObjectGuid::LowType /*itemGuid*/) { trans->Append("DELETE FROM item_instance"); }
+
+private:
+    ObjectGuid _guid;
+    ItemTemplate const* _template{ nullptr };
+    uint32 _count{ 1 };
+    ItemUpdateState _state{ ITEM_NEW };
+};
+
+#endif
@@ -0,0 +1,73 @@
+/*
+ * Minimal stand-in for the core's ItemTemplate.h, so the module's
+ * kernels can be built and benchmarked without an AzerothCore tree.
+ */
+
+#ifndef AHB_BENCH_ITEM_TEMPLATE_H
+#define AHB_BENCH_ITEM_TEMPLATE_H
+
+#include "SharedDefines.h"
+#include <unordered_map>
+
+constexpr uint8 MAX_ITEM_PROTO_SPELLS = 5;
+
+enum ItemBondingType
+{
+    NO_BIND,
+    BIND_WHEN_PICKED_UP,
+    BIND_WHEN_EQUIPED,
+    BIND_WHEN_USE,
+    BIND_QUEST_ITEM,
+    BIND_QUEST_ITEM1,
+    MAX_BIND_TYPE
+};
+
+enum ItemClass
+{
+    ITEM_CLASS_CONSUMABLE,
+    ITEM_CLASS_CONTAINER,
+    ITEM_CLASS_WEAPON,
+    ITEM_CLASS_GEM,
+    ITEM_CLASS_ARMOR,
+    ITEM_CLASS_REAGENT,
+    ITEM_CLASS_PROJECTILE,
+    ITEM_CLASS_TRADE_GOODS,
+    ITEM_CLASS_GENERIC,
+    ITEM_CLASS_RECIPE,
+    ITEM_CLASS_MONEY,
+    ITEM_CLASS_QUIVER,
+    ITEM_CLASS_QUEST,
+    ITEM_CLASS_KEY,
+    ITEM_CLASS_PERMANENT,
+    ITEM_CLASS_MISC,
+    ITEM_CLASS_GLYPH,
+    MAX_ITEM_CLASS
+};
+
+// Only the fields the module reads
+struct ItemTemplate
+{
+    uint32 ItemId{ 0 };
+    uint32 Class{ 0 };
+    uint32 SubClass{ 0 };
+    uint32 Quality{ 0 };
+    uint32 Flags{ 0 };
+    uint32 BuyPrice{ 0 };
+    uint32 SellPrice{ 0 };
+    int32 AllowableClass{ -1 };
+    uint32 ItemLevel{ 0 };
+    uint32 RequiredLevel{ 0 };
+    uint32 RequiredSkillRank{ 0 };
+    int32 Stackable{ 1 };
+    uint32 Bonding{ 0 };
+    uint32 Duration{ 0 };
+    uint32 MinMoneyLoot{ 0 };
+    uint32 AmmoType{ 0 };
+
+    bool IsConjuredConsumable() const { return Class == ITEM_CLASS_CONSUMABLE && (Flags & 0x2); }
+    uint32 GetMaxStackSize() const { return Stackable > 0 ? uint32(Stackable) : 0x7FFFFFFF - 1; }
+};
+
+typedef std::unordered_map<uint32, ItemTemplate> ItemTemplateContainer;
+
+#endif
@@ -0,0 +1,19 @@
+/*
+ * Minimal stand-in for the core's Log.h, so the module's
+ * kernels can be built and benchmarked without an AzerothCore tree.
+ */
+
+#ifndef AHB_BENCH_LOG_H
+#define AHB_BENCH_LOG_H
+
+#include <fmt/format.h>
+
+// Never logs, the arguments are only type checked against the format string
+#define AHB_BENCH_LOG(filter, ...) do { if (false) (void)fmt::format(__VA_ARGS__); } while (0)
+#define LOG_TRACE(...) AHB_BENCH_LOG(__VA_ARGS__)
+#define LOG_DEBUG(...) AHB_BENCH_LOG(__VA_ARGS__)
+#define LOG_INFO(...) AHB_BENCH_LOG(__VA_ARGS__)
+#define LOG_WARN(...) AHB_BENCH_LOG(__VA_ARGS__)
+#define LOG_ERROR(...) AHB_BENCH_LOG(__VA_ARGS__)
+
+#endif
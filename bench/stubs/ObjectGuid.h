@@ -0,0 +1,47 @@
+/*
+ * Minimal stand-in for the core's ObjectGuid.h, so the module can be
+ * benchmarked and simulated without an AzerothCore tree.
+ */
+
+#ifndef AHB_BENCH_OBJECT_GUID_H
+#define AHB_BENCH_OBJECT_GUID_H
+
+#include "Define.h"
+#include <string>
+
+enum class HighGuid
+{
+    Player,
+    Item
+};
+
+// Only the counter matters, players and items are never compared with each other
+class ObjectGuid
+{
+public:
+    typedef uint32 LowType;
+
+    ObjectGuid() = default;
+
+    template<HighGuid high>
+    static ObjectGuid Create(LowType counter) { return ObjectGuid(counter); }
+
+    LowType GetCounter() const { return _counter; }
+    uint64 GetRawValue() const { return _counter; }
+    std::string ToString() const { return std::to_string(_counter); }
+
+    explicit operator bool() const { return _counter != 0; }
+    bool operator==(ObjectGuid const& other) const = default;
+    bool operator<(ObjectGuid const& other) const { return _counter < other._counter; }
+
+    static ObjectGuid const Empty;
+
+private:
+    explicit ObjectGuid(LowType counter) : _counter(counter) { }
+
+    LowType _counter{ 0 };
+};
+
+inline ObjectGuid const ObjectGuid::Empty;
+
+#endif
@@ -0,0 +1,43 @@
+/*
+ * Minimal stand-in for the core's ObjectMgr.h, serving a generated item
+ * template store, so the module can be benchmarked and simulated without
+ * an AzerothCore tree.
+ */
+
+#ifndef AHB_BENCH_OBJECT_MGR_H
+#define AHB_BENCH_OBJECT_MGR_H
+
+#include "ItemTemplate.h"
+#include "Random.h" // the core's ObjectMgr.h pulls it in through Util.h
+
+// Serves the synthetic item template store the benchmark generated
+class ObjectMgr
+{
+public:
+    static ObjectMgr* instance()
+    {
+        static ObjectMgr instance;
+        return &instance;
+    }
+
+    ItemTemplateContainer const* GetItemTemplateStore() const { return &_itemTemplates; }
+    ItemTemplateContainer& GetItemTemplateStoreForUpdate() { return _itemTemplates; }
+
+    ItemTemplate const* GetItemTemplate(uint32 entry) const
+    {
+        const auto found = _itemTemplates.find(entry);
+        return found != _itemTemplates.end() ? &found->second : nullptr;
+    }
+
+    uint32 GenerateAuctionID() { return ++_auctionId; }
+    uint32 GenerateItemLowGuid() { return ++_itemGuid; }
+
+private:
+    ItemTemplateContainer _itemTemplates;
+    uint32 _auctionId{ 0 };
+    uint32 _itemGuid{ 0 };
+};
+
+#define sObjectMgr ObjectMgr::instance()
+
+#endif
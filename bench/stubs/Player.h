@@ -0,0 +1,43 @@
+/*
+ * Minimal stand-in for the core's Player.h, a player that is only a guid,
+ * so the module can be simulated without an AzerothCore tree.
+ */
+
+#ifndef AHB_BENCH_PLAYER_H
+#define AHB_BENCH_PLAYER_H
+
+#include "Item.h"
+#include "ObjectGuid.h"
+#include "WorldSession.h"
+
+class Player
+{
+public:
+    explicit Player(WorldSession* session) : _session(session) { }
+    virtual ~Player() = default;
+
+    bool Initialize(ObjectGuid::LowType guidlow)
+    {
+        _guid = ObjectGuid::Create<HighGuid::Player>(guidlow);
+        return true;
+    }
+
+    ObjectGuid GetGUID() const { return _guid; }
+    WorldSession* GetSession() const { return _session; }
+    uint8 GetLevel() const { return _level; }
+    void SetLevel(uint8 level) { _level = level; }
+    bool IsGameMaster() const { return false; }
+
+private:
+    WorldSession* _session;
+    ObjectGuid _guid;
+    uint8 _level{ 80 };
+};
+
+namespace ObjectAccessor
+{
+    inline void AddObject(Player* /*object*/) { }
+    inline void RemoveObject(Player* /*object*/) { }
+}
+
+#endif
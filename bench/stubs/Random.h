@@ -0,0 +1,28 @@
+/*
+ * Minimal stand-in for the core's Random.h, seeded so simulations can be
+ * repeated, so the module can be simulated without an AzerothCore tree.
+ */
+
+#ifndef AHB_BENCH_RANDOM_H
+#define AHB_BENCH_RANDOM_H
+
+#include "Define.h"
+#include <random>
+
+inline std::mt19937& GetStubRandomEngine()
+{
+    static std::mt19937 engine(1);
+    return engine;
+}
+
+inline float frand(float min, float max)
+{
+    return std::uniform_real_distribution<float>(min, max)(GetStubRandomEngine());
+}
+
+inline uint32 urand(uint32 min, uint32 max)
+{
+    return std::uniform_int_distribution<uint32>(min, max)(GetStubRandomEngine());
+}
+
+#endif
@@ -0,0 +1,41 @@
+/*
+ * Minimal stand-in for the parts of the core's SharedDefines.h the module's kernels use, so the module's
+ * kernels can be built and benchmarked without an AzerothCore tree.
+ */
+
+#ifndef AHB_BENCH_SHARED_DEFINES_H
+#define AHB_BENCH_SHARED_DEFINES_H
+
+#include "Define.h"
+
+enum ItemQualities
+{
+    ITEM_QUALITY_POOR,
+    ITEM_QUALITY_NORMAL,
+    ITEM_QUALITY_UNCOMMON,
+    ITEM_QUALITY_RARE,
+    ITEM_QUALITY_EPIC,
+    ITEM_QUALITY_LEGENDARY,
+    ITEM_QUALITY_ARTIFACT,
+    ITEM_QUALITY_HEIRLOOM,
+    MAX_ITEM_QUALITY
+};
+
+enum Classes
+{
+    CLASS_NONE,
+    CLASS_WARRIOR,
+    CLASS_PALADIN,
+    CLASS_HUNTER,
+    CLASS_ROGUE,
+    CLASS_PRIEST,
+    CLASS_DEATH_KNIGHT,
+    CLASS_SHAMAN,
+    CLASS_MAGE,
+    CLASS_WARLOCK,
+    CLASS_UNK,
+    CLASS_DRUID,
+    MAX_CLASSES
+};
+
+#endif
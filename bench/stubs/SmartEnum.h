@@ -0,0 +1,25 @@
+/*
+ * Minimal stand-in for the core's SmartEnum.h, enum names are not needed here, so the module's
+ * kernels can be built and benchmarked without an AzerothCore tree.
+ */
+
+#ifndef AHB_BENCH_SMART_ENUM_H
+#define AHB_BENCH_SMART_ENUM_H
+
+namespace Acore::Impl::EnumUtilsImpl
+{
+    struct EnumText
+    {
+        char const* Constant;
+        char const* Title;
+        char const* Description;
+    };
+
+    template<class Enum>
+    struct EnumUtils
+    {
+        static EnumText ToString(Enum) { return { "", "", "" }; }
+    };
+}
+
+#endif
@@ -0,0 +1,27 @@
+/*
+ * Minimal stand-in for the core's StringConvert.h, so the module can be
+ * simulated without an AzerothCore tree.
+ */
+
+#ifndef AHB_BENCH_STRING_CONVERT_H
+#define AHB_BENCH_STRING_CONVERT_H
+
+#include <charconv>
+#include <optional>
+#include <string_view>
+
+namespace Acore
+{
+    template<class T>
+    std::optional<T> StringTo(std::string_view str)
+    {
+        T value{};
+        auto const [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+        if (ec != std::errc() || ptr != str.data() + str.size())
+            return std::nullopt;
+
+        return value;
+    }
+}
+
+#endif
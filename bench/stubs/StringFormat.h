@@ -0,0 +1,21 @@
+/*
+ * Minimal stand-in for the core's StringFormat.h, on top of fmt, so the module's
+ * kernels can be built and benchmarked without an AzerothCore tree.
+ */
+
+#ifndef AHB_BENCH_STRING_FORMAT_H
+#define AHB_BENCH_STRING_FORMAT_H
+
+#include <fmt/format.h>
+#include <string>
+
+namespace Acore
+{
+    template<class... Args>
+    std::string StringFormatFmt(fmt::format_string<Args...> format, Args&&... args)
+    {
+        return fmt::format(format, std::forward<Args>(args)...);
+    }
+}
+
+#endif
@@ -0,0 +1,45 @@
+/*
+ * Minimal stand-in for the core's World.h, only the settings the module
+ * reads, so it can be simulated without an AzerothCore tree.
+ */
+
+#ifndef AHB_BENCH_WORLD_H
+#define AHB_BENCH_WORLD_H
+
+#include "Define.h"
+
+enum WorldBoolConfigs
+{
+    CONFIG_ALLOW_TWO_SIDE_INTERACTION_AUCTION,
+    BOOL_CONFIG_VALUE_COUNT
+};
+
+enum WorldIntConfigs
+{
+    CONFIG_EXPANSION,
+    INT_CONFIG_VALUE_COUNT
+};
+
+class World
+{
+public:
+    static World* instance()
+    {
+        static World instance;
+        return &instance;
+    }
+
+    bool getBoolConfig(WorldBoolConfigs index) const { return _boolConfigs[index]; }
+    void setBoolConfig(WorldBoolConfigs index, bool value) { _boolConfigs[index] = value; }
+
+    uint32 getIntConfig(WorldIntConfigs index) const { return _intConfigs[index]; }
+    void setIntConfig(WorldIntConfigs index, uint32 value) { _intConfigs[index] = value; }
+
+private:
+    bool _boolConfigs[BOOL_CONFIG_VALUE_COUNT]{};
+    uint32 _intConfigs[INT_CONFIG_VALUE_COUNT]{ 2 };
+};
+
+#define sWorld World::instance()
+
+#endif
@@ -0,0 +1,45 @@
+/*
+ * Minimal stand-in for the core's WorldSession.h, a session without a
+ * socket, so the module can be simulated without an AzerothCore tree.
+ */
+
+#ifndef AHB_BENCH_WORLD_SESSION_H
+#define AHB_BENCH_WORLD_SESSION_H
+
+#include "ObjectGuid.h"
+#include "World.h"
+#include <ctime>
+#include <memory>
+#include <string>
+
+enum AccountTypes
+{
+    SEC_PLAYER,
+    SEC_MODERATOR,
+    SEC_GAMEMASTER,
+    SEC_ADMINISTRATOR,
+    SEC_CONSOLE
+};
+
+enum LocaleConstant
+{
+    LOCALE_enUS
+};
+
+class WorldSession
+{
+public:
+    WorldSession(uint32 id, std::string&& name, std::shared_ptr<void> /*sock*/, AccountTypes /*sec*/, uint8 /*expansion*/, time_t /*muteTime*/,
+        LocaleConstant /*locale*/, uint32 /*recruiterId*/, bool /*isARecruiter*/, bool /*skipQueue*/, uint32 /*totalTime*/) :
+        _accountId(id), _accountName(std::move(name)) { }
+
+    uint32 GetAccountId() const { return _accountId; }
+
+    void SendAuctionBidderNotification(uint32 /*location*/, uint32 /*auctionId*/, ObjectGuid /*bidder*/, uint32 /*bidSum*/, uint32 /*diff*/, uint32 /*itemEntry*/) { }
+
+private:
+    uint32 _accountId;
+    std::string _accountName;
+};
+
+#endif
@@ -0,0 +1,8 @@
+CREATE TABLE IF NOT EXISTS `mod_auctionhousebot_market_prices` (
+  `item` mediumint(8) unsigned NOT NULL,
+  `price` float NOT NULL DEFAULT 0 COMMENT 'Per unit, moving average of the sales',
+  `sold` int(10) unsigned NOT NULL DEFAULT 0 COMMENT 'Units sold',
+  `expired` int(10) unsigned NOT NULL DEFAULT 0 COMMENT 'Auctions that expired without a bid',
+  `lastSeen` int(10) unsigned NOT NULL DEFAULT 0 COMMENT 'Unix time of the last sale or expiration',
+  PRIMARY KEY (`item`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8;
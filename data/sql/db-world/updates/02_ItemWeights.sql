@@ -0,0 +1,5 @@
+CREATE TABLE IF NOT EXISTS `mod_auctionhousebot_item_weights` (
+  `item` mediumint(8) unsigned NOT NULL,
+  `weight` float NOT NULL DEFAULT 1 COMMENT 'Relative chance of the item being picked within its quality bin, 0 never picks it',
+  PRIMARY KEY (`item`)
+) ENGINE=MyISAM DEFAULT CHARSET=utf8;
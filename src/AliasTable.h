@@ -0,0 +1,111 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AHB_ALIAS_TABLE_H
+#define AHB_ALIAS_TABLE_H
+
+#include "Define.h"
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// Walker/Vose alias table, O(n) to build and O(1) per weighted draw
+class AHBAliasTable
+{
+public:
+    void Build(std::vector<float> const& weights)
+    {
+        _probability.clear();
+        _alias.clear();
+
+        const std::size_t count = weights.size();
+        double totalWeight = 0;
+        for (float weight : weights)
+            totalWeight += std::max(weight, 0.f);
+
+        if (!count || totalWeight <= 0)
+            return;
+
+        _probability.resize(count, 1.f);
+        _alias.resize(count);
+        std::iota(_alias.begin(), _alias.end(), 0u);
+
+        std::vector<double> scaled(count);
+        std::vector<uint32> small;
+        std::vector<uint32> large;
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            scaled[i] = std::max(weights[i], 0.f) * count / totalWeight;
+            (scaled[i] < 1.0 ? small : large).push_back(i);
+        }
+
+        while (!small.empty() && !large.empty())
+        {
+            const uint32 less = small.back();
+            small.pop_back();
+            const uint32 more = large.back();
+            large.pop_back();
+
+            _probability[less] = static_cast<float>(scaled[less]);
+            _alias[less] = more;
+
+            scaled[more] = (scaled[more] + scaled[less]) - 1.0;
+            (scaled[more] < 1.0 ? small : large).push_back(more);
+        }
+
+        // Whatever is left over is 1 within rounding errors and keeps its default probability of 1,
+        // except for items of weight 0, which rounding can leave in small too. Those are never drawn.
+        const uint32 weighted = std::find_if(weights.begin(), weights.end(), [](float weight) { return weight > 0.f; }) - weights.begin();
+        for (const uint32 less : small)
+        {
+            if (weights[less] > 0.f)
+                continue;
+
+            _probability[less] = 0.f;
+            _alias[less] = weighted;
+        }
+    }
+
+    // Returns an index into the weights the table was built from
+    template<class Rng>
+    uint32 Sample(Rng& rng) const
+    {
+        std::uniform_int_distribution<uint32> column(0, _probability.size() - 1);
+        std::uniform_real_distribution<float> coin(0.f, 1.f);
+
+        const uint32 index = column(rng);
+        return coin(rng) < _probability[index] ? index : _alias[index];
+    }
+
+    bool IsEmpty() const
+    {
+        return _probability.empty();
+    }
+
+    std::size_t GetMemoryUsage() const
+    {
+        return _probability.capacity() * sizeof(float) + _alias.capacity() * sizeof(uint32);
+    }
+
+private:
+    std::vector<float> _probability;
+    std::vector<uint32> _alias;
+};
+
+#endif
@@ -19,7 +19,12 @@
 #include "AuctionHouseMgr.h"
 #include "AuctionHouseBot.h"
 #include "ItemIndex.h"
+#include "Metrics.h"
+#include "Profiler.h"
+#include "Statements.h"
+#include "TraceWriter.h"
 
+#include <chrono>
 #include <numeric>
 #include <random>
 
@@ -28,6 +33,7 @@
 #include "WorldSession.h"
 #include "GameTime.h"
 #include "DatabaseEnv.h"
+#include "Log.h"
 #include "StringConvert.h"
 #include "StringFormat.h"
 #include <vector>
@@ -51,7 +57,117 @@ AuctionHouseBot::AuctionHouseBot()
 
 std::mt19937 rng{ std::random_device{}() };
 
-void AuctionHouseBot::AddNewAuctions(Player* AHBplayer, AHBConfig* config)
+namespace
+{
+    uint32 GetMaxStackSize(AHBConfig& config, ItemTemplate const* prototype)
+    {
+        uint32 maxStackSize = std::max(1u, prototype->GetMaxStackSize());
+        const uint32 maxStackConfig = config.GetMaxStack(prototype->Quality);
+
+        if (maxStackConfig)
+            maxStackSize = std::min(maxStackSize, maxStackConfig);
+
+        return maxStackSize;
+    }
+
+    // ItemsPerCycle is what the seller creates per update across all houses. Every house that misses
+    // auctions gets at least minShare of it, the rest goes by how many auctions each one misses.
+    // The shares never add up to more than the budget, whatever the number of houses.
+    std::vector<uint32> ShareItemBudget(uint32 budget, std::vector<uint32> const& deficits, float minShare)
+    {
+        std::vector<uint32> shares(deficits.size(), 0);
+
+        const uint32 houses = std::count_if(deficits.begin(), deficits.end(), [](uint32 deficit) { return deficit > 0; });
+        if (!houses || !budget)
+            return shares;
+
+        const uint32 minimum = std::max(1u, std::min(uint32(budget * minShare), budget / houses));
+        uint32 left = budget;
+        uint64 missing = 0;
+
+        for (std::size_t i = 0; i < deficits.size(); ++i)
+        {
+            shares[i] = std::min({ deficits[i], minimum, left });
+            left -= shares[i];
+            missing += deficits[i] - shares[i];
+        }
+
+        const uint32 rest = left;
+        for (std::size_t i = 0; i < deficits.size() && missing; ++i)
+        {
+            const uint32 extra = std::min<uint64>({ deficits[i] - shares[i], uint64(rest) * (deficits[i] - shares[i]) / missing, left });
+            shares[i] += extra;
+            left -= extra;
+        }
+
+        return shares;
+    }
+
+    uint32 CalculateStackSize(AHBConfig& config, ItemTemplate const* prototype, std::mt19937& random)
+    {
+        // Some items only make sense in specific size
+        if (prototype->Class == ITEM_CLASS_GLYPH)
+            return 1u; // Glyphs only sold in 1 stacks
+
+        std::uniform_int_distribution<uint32> stackSize(1, GetMaxStackSize(config, prototype));
+        return stackSize(random);
+    }
+
+    // Draws count items of a quality bin into items, by level bracket if any bracket has a weight
+    void SelectItems(AuctionHouseIndex const& itemIndex, uint32 quality, uint32 count, std::array<float, AHB_LEVEL_BRACKETS> const& bracketWeights,
+        std::vector<uint32>& items, std::mt19937& random)
+    {
+        if (std::any_of(bracketWeights.begin(), bracketWeights.end(), [](float weight) { return weight > 0; }))
+        {
+            std::discrete_distribution<uint32> randomBracket(bracketWeights.begin(), bracketWeights.end());
+
+            for (uint32 i = 0; i < count; ++i)
+                items.push_back(itemIndex.SampleItemInBracket(quality, randomBracket(random), random));
+        }
+        else if (itemIndex.IsWeighted(quality))
+        {
+            // Weighted draws are with replacement, popular items can be listed more than once per batch
+            for (uint32 i = 0; i < count; ++i)
+                items.push_back(itemIndex.SampleWeightedItem(quality, random));
+        }
+        else
+        {
+            auto const& itemsBin = itemIndex.GetItemBin(quality);
+            std::sample(itemsBin.begin(), itemsBin.end(), std::back_inserter(items), count, random);
+        }
+    }
+
+    // Values of one item_instance row, what Item::SaveToDB() writes for a new item
+    void AppendItemInstanceRow(std::string& values, Item* item, ObjectGuid::LowType owner)
+    {
+        std::string charges;
+        for (uint8 i = 0; i < MAX_ITEM_PROTO_SPELLS; ++i)
+            charges += Acore::StringFormatFmt("{} ", item->GetSpellCharges(i));
+
+        std::string enchantments;
+        for (uint8 i = 0; i < MAX_ENCHANTMENT_SLOT; ++i)
+            enchantments += Acore::StringFormatFmt("{} {} {} ", item->GetEnchantmentId(EnchantmentSlot(i)),
+                item->GetEnchantmentDuration(EnchantmentSlot(i)), item->GetEnchantmentCharges(EnchantmentSlot(i)));
+
+        if (!values.empty())
+            values += ',';
+
+        values += Acore::StringFormatFmt("({}, {}, {}, 0, 0, {}, {}, '{}', {}, '{}', {}, {}, 0, '')", item->GetGUID().GetCounter(), item->GetEntry(), owner,
+            item->GetCount(), item->GetUInt32Value(ITEM_FIELD_DURATION), charges, item->GetUInt32Value(ITEM_FIELD_FLAGS), enchantments,
+            item->GetItemRandomPropertyId(), item->GetUInt32Value(ITEM_FIELD_DURABILITY));
+    }
+
+    void AppendAuctionRow(std::string& values, AuctionEntry const* auction)
+    {
+        if (!values.empty())
+            values += ',';
+
+        values += Acore::StringFormatFmt("({}, {}, {}, {}, {}, {}, 0, 0, {}, {})", auction->Id, auction->houseId, auction->item_guid.GetCounter(),
+            auction->owner.GetCounter(), auction->buyout, auction->expire_time, auction->startbid, auction->deposit);
+    }
+}
+
+void AuctionHouseBot::AddNewAuctions(Player* AHBplayer, AHBConfig* config, uint32 itemBudget)
 {
     if (!AHBSeller)
     {
@@ -59,9 +175,16 @@ void AuctionHouseBot::AddNewAuctions(Player* AHBplayer, AHBConfig* config)
         return;
     }
 
+    AHBScopedTimer sellerTimer(AHBTimer::Seller, config->GetAuctionHouseID());
+    AHB_PROFILE_SCOPE("AddNewAuctions");
+
     uint32 minItems = config->GetMinItems();
     uint32 maxItems = config->GetMaxItems();
 
+    // Done unless it is left pending below, a settings change or the next removal wakes it again
+    AHBRefill& refill = _refills[config->GetAuctionHouseID()];
+    refill.pending = false;
+
     if (maxItems == 0)
     {
         LOG_DEBUG("module.ahbot", "Auctions disabled");
@@ -86,6 +209,7 @@ void AuctionHouseBot::AddNewAuctions(Player* AHBplayer, AHBConfig* config)
     if (auctions >= minItems)
     {
         LOG_DEBUG("module.ahbot", "AHSeller: Auctions above minimum");
+        refill.removed = 0;
         return;
     }
 
@@ -95,8 +219,8 @@ void AuctionHouseBot::AddNewAuctions(Player* AHBplayer, AHBConfig* config)
         return;
     }
 
-    if ((maxItems - auctions) >= ItemsPerCycle)
-        itemsToCreate = ItemsPerCycle;
+    if ((maxItems - auctions) >= itemBudget)
+        itemsToCreate = itemBudget;
     else
         itemsToCreate = (maxItems - auctions);
 
@@ -109,12 +233,14 @@ void AuctionHouseBot::AddNewAuctions(Player* AHBplayer, AHBConfig* config)
     LOG_DEBUG("module.ahbot", "AHSeller: creating {} items", itemsToCreate);
 
 
-    // Check how many items we are missing in every quality level (plus the separate trade goods levels)
+    // Check how many items we are missing in every quality level (plus the separate trade goods levels),
+    // only in the ones that lost auctions since the last refill
     std::array<uint32, AHB_MAX_QUALITY> itemCountToCreate {};
+    const std::bitset<AHB_MAX_QUALITY> bins = GetRefillBins(config);
 
     for (uint32 i = 0; i < AHB_MAX_QUALITY; ++i)
     {
-        if (itemsCount[i] < maxCounts[i])
+        if (bins[i] && itemsCount[i] < maxCounts[i])
             itemCountToCreate[i] = maxCounts[i] - itemsCount[i];
 
         LOG_DEBUG("module.ahbot", "AHSeller: Q {} have {} want {} diff {}", i, itemsCount[i], maxCounts[i], itemCountToCreate[i]);
@@ -124,60 +250,39 @@ void AuctionHouseBot::AddNewAuctions(Player* AHBplayer, AHBConfig* config)
     itemsToCreate = std::min(itemsToCreate, std::accumulate(itemCountToCreate.begin(), itemCountToCreate.end(), 0u));
 
     if (itemsToCreate == 0)
+    {
+        refill.bins.reset();
+        refill.removed = 0;
         return; // huh?
+    }
 
     // Every iteration we will select a quality to add items for
     // That means in the first cycles, the AH will not be balanced (eg full of only blue items) but with the next cycles it will balance out
 
     // Weighted distribution, the quality with most missing items has highest probability
     std::discrete_distribution<uint32> randomQuality(itemCountToCreate.begin(), itemCountToCreate.end());
-    std::uniform_int_distribution<uint32> randomTime(0, 3); // 12h, 24h, 48h
 
     // List of itemID's we chose to create this batch
     std::vector<uint32> itemBatch;
     itemBatch.reserve(512);
     std::vector<std::pair<Item*, AuctionEntry*>> auctionBatch;
     itemBatch.reserve(512);
+    std::vector<AuctionEntry*> toppedUp;
 
-    auto calculateStackSize = [config](ItemTemplate const* prototype)
-        {
-            // Some items only make sense in specific size
-            if (prototype->Class == ITEM_CLASS_GLYPH)
-                return 1u; // Glyphs only sold in 1 stacks
-
-
-            uint32 maxStackSize = std::max(1u, prototype->GetMaxStackSize());
-            const uint32 maxStackConfig = config->GetMaxStack(prototype->Quality);
-
-            if (maxStackConfig)
-                maxStackSize = std::min(maxStackSize, maxStackConfig);
-
-            std::uniform_int_distribution<uint32> stackSize(1, maxStackSize);
-            return stackSize(rng);
-        };
-
-    auto calculatePrices = [config, this](ItemTemplate const* prototype, uint64 vendorPrice) -> std::pair<uint32, uint32>
-        {
-            if (const auto priceOverride = sAHIndex->GetOverridenPrice(prototype->ItemId, rng))
-                vendorPrice = *priceOverride;
-
-            std::uniform_int_distribution<uint32> buyPriceMultiplier(config->GetMinPrice(prototype->Quality), config->GetMaxPrice(prototype->Quality));
-            std::uniform_int_distribution<uint32> bidPriceMultiplier(config->GetMinBidPrice(prototype->Quality), config->GetMaxBidPrice(prototype->Quality));
-            //#TODO float?
-            uint64 buyoutPrice = vendorPrice * buyPriceMultiplier(rng);
-            buyoutPrice /= 100;
-            uint64 bidPrice = buyoutPrice * bidPriceMultiplier(rng);
-            bidPrice /= 100;
-
-            return { buyoutPrice, bidPrice };
-        };
+    // Prices of a batch are calculated together once all its items are created, every item of a batch has the same quality
+    AHBPriceBatch priceBatch;
+    priceBatch.Reserve(512);
 
     auto const itemIndex = sAHIndex;
 
+    const std::array<uint32, AHB_LEVEL_BRACKETS> onlinePlayers = GetOnlinePlayersPerBracket();
+
     while (itemsToCreate)
     {
         itemBatch.clear();
         auctionBatch.clear();
+        toppedUp.clear();
+        priceBatch.Clear();
 
         // Choose random category
 
@@ -198,85 +303,124 @@ void AuctionHouseBot::AddNewAuctions(Player* AHBplayer, AHBConfig* config)
             quality = std::distance(itemCountToCreate.begin(), found);
         }
 
-        auto const& itemsBin = itemIndex->GetItemBin(quality);
         const auto itemsToCreateInQuality = std::min(itemsToCreate, itemCountToCreate[quality]);
 
+        {
+            AHB_PROFILE_SCOPE("AddNewAuctions.select");
+            SelectItems(*itemIndex, quality, itemsToCreateInQuality, GetBracketWeights(quality, onlinePlayers), itemBatch, rng);
+        }
 
-        std::sample(itemsBin.begin(), itemsBin.end(), std::back_inserter(itemBatch), itemsToCreateInQuality, rng);
-
+        if (itemBatch.empty())
+        {
+            // Nothing to sell in this quality (or a reload has not been applied yet), don't keep picking it
+            itemCountToCreate[quality] = 0;
+            refill.bins.reset(quality);
+            continue;
+        }
 
         LOG_DEBUG("module.ahbot", "AHSeller: Creating {} items of quality {}", itemBatch.size(), quality);
 
-        for (const auto itemID : itemBatch)
         {
-            WPAssert(itemID, "zero ItemID"); // shouldn't be possible, we already filter this when we initialize itemsBin
+            AHB_PROFILE_SCOPE("AddNewAuctions.create");
 
-            ItemTemplate const* prototype = sObjectMgr->GetItemTemplate(itemID);
-            if (!prototype)
+            for (const auto itemID : itemBatch)
             {
-                LOG_ERROR("module.ahbot", "AHSeller: ItemTemplate is nullptr!");
-                continue;
-            }
+                WPAssert(itemID, "zero ItemID"); // shouldn't be possible, we already filter this when we initialize itemsBin
 
-            Item* item = Item::CreateItem(itemID, 1, AHBplayer);
-            if (!item)
-            {
-                LOG_ERROR("module.ahbot", "AHSeller: Item not created!");
-                break;
-            }
+                ItemTemplate const* prototype = sObjectMgr->GetItemTemplate(itemID);
+                if (!prototype)
+                {
+                    LOG_ERROR("module.ahbot", "AHSeller: ItemTemplate is nullptr!");
+                    continue;
+                }
+
+                // Trade goods go on top of a listing of the same item first, fewer and larger stacks for the same supply
+                if (ConsolidateTradeGoods && prototype->Class == ITEM_CLASS_TRADE_GOODS && prototype->Quality <= AHB_MAX_DEFAULT_QUALITY)
+                {
+                    if (AuctionEntry* auction = TopUpAuction(config, auctionHouse, prototype, CalculateStackSize(*config, prototype, rng)))
+                    {
+                        toppedUp.push_back(auction);
+                        continue;
+                    }
+                }
+
+                Item* item = Item::CreateItem(itemID, 1, AHBplayer);
+                if (!item)
+                {
+                    LOG_ERROR("module.ahbot", "AHSeller: Item not created!");
+                    break;
+                }
 
-            item->AddToUpdateQueueOf(AHBplayer);
+                item->AddToUpdateQueueOf(AHBplayer);
 
-            const uint32 randomPropertyId = Item::GenerateItemRandomPropertyId(itemID);
-            if (randomPropertyId != 0)
-                item->SetItemRandomProperties(randomPropertyId);
+                const uint32 randomPropertyId = Item::GenerateItemRandomPropertyId(itemID);
+                if (randomPropertyId != 0)
+                    item->SetItemRandomProperties(randomPropertyId);
 
-            uint64 buyoutPrice = 0;
-            uint64 bidPrice = 0;
-            uint32 stackCount = 1;
+                uint32 stackCount = 1;
 
-            if (prototype->Quality <= AHB_MAX_DEFAULT_QUALITY)
-            {
-                stackCount = calculateStackSize(prototype);
+                if (prototype->Quality <= AHB_MAX_DEFAULT_QUALITY)
+                {
+                    // Consolidated trade goods are listed in full stacks, each counts as the uniform stacks it holds
+                    if (ConsolidateTradeGoods && prototype->Class == ITEM_CLASS_TRADE_GOODS)
+                        stackCount = GetMaxStackSize(*config, prototype);
+                    else
+                        stackCount = CalculateStackSize(*config, prototype, rng);
 
-                //#TODO when we get rid of this quality check, we don't need tie anymore
-                //#TODO "SellMethod" is a bad variable name
-                std::tie(buyoutPrice, bidPrice) = calculatePrices(prototype, SellMethod ? prototype->BuyPrice : prototype->SellPrice);
-            }
-            else
-            {
-                //#TODO do this at load time
-                // quality is something it shouldn't be, let's get out of here
-                LOG_ERROR("module.ahbot", "AHBuyer: Quality {} not Supported", prototype->Quality);
-                item->RemoveFromUpdateQueueOf(AHBplayer);
-                continue;
-            }
+                    // A price override still takes precedence over the market price
+                    priceBatch.Add(GetSellerBasePrice(prototype), itemIndex->GetPriceOverride(itemID));
+                }
+                else
+                {
+                    //#TODO do this at load time
+                    // quality is something it shouldn't be, let's get out of here
+                    LOG_ERROR("module.ahbot", "AHBuyer: Quality {} not Supported", prototype->Quality);
+                    item->RemoveFromUpdateQueueOf(AHBplayer);
+                    continue;
+                }
+
+                const time_t now = GameTime::GetGameTime().count();
+                const Seconds lifeTime = _expirySchedules[config->GetAuctionHouseID()].Schedule(now, rng);
+
+                item->SetCount(stackCount);
 
-            Seconds lifeTime = randomTime(rng) * 12h;
+                uint32 dep = sAuctionMgr->GetAuctionDeposit(ahEntry, lifeTime.count(), item, stackCount);
 
-            item->SetCount(stackCount);
+                AuctionEntry* auctionEntry = new AuctionEntry();
+                auctionEntry->Id = sObjectMgr->GenerateAuctionID();
+                auctionEntry->houseId = config->GetAuctionHouseID();
+                auctionEntry->item_guid = item->GetGUID();
+                auctionEntry->item_template = item->GetEntry();
+                auctionEntry->itemCount = item->GetCount();
+                auctionEntry->owner = AHBplayer->GetGUID();
+                auctionEntry->bid = 0;
+                auctionEntry->deposit = dep;
+                auctionEntry->expire_time = now + lifeTime.count();
+                auctionEntry->auctionHouseEntry = ahEntry;
 
-            uint32 dep = sAuctionMgr->GetAuctionDeposit(ahEntry, lifeTime.count(), item, stackCount);
+                auctionBatch.emplace_back(item, auctionEntry);
+            }
+        }
+
+        {
+            AHB_PROFILE_SCOPE("AddNewAuctions.price");
 
-            AuctionEntry* auctionEntry = new AuctionEntry();
-            auctionEntry->Id = sObjectMgr->GenerateAuctionID();
-            auctionEntry->houseId = config->GetAuctionHouseID();
-            auctionEntry->item_guid = item->GetGUID();
-            auctionEntry->item_template = item->GetEntry();
-            auctionEntry->itemCount = item->GetCount();
-            auctionEntry->owner = AHBplayer->GetGUID();
-            auctionEntry->startbid = bidPrice * stackCount;
-            auctionEntry->buyout = buyoutPrice * stackCount;
-            auctionEntry->bid = 0;
-            auctionEntry->deposit = dep;
-            auctionEntry->expire_time = lifeTime.count() + GameTime::GetGameTime().count();
-            auctionEntry->auctionHouseEntry = ahEntry;
+            const uint32 priceQuality = quality % AHB_DEFAULT_QUALITY_SIZE;
+            priceBatch.Calculate(config->GetMinPrice(priceQuality), config->GetMaxPrice(priceQuality), config->GetMinBidPrice(priceQuality), config->GetMaxBidPrice(priceQuality), rng);
 
-            auctionBatch.emplace_back(item, auctionEntry);
+            // Same order, items that failed to be created were not added to either
+            for (std::size_t i = 0; i < auctionBatch.size(); ++i)
+            {
+                AuctionEntry* auctionEntry = auctionBatch[i].second;
+                auctionEntry->startbid = priceBatch.GetBid(i) * auctionEntry->itemCount;
+                auctionEntry->buyout = priceBatch.GetBuyout(i) * auctionEntry->itemCount;
+            }
         }
 
         // Insert all auctions
         {
+            AHB_PROFILE_SCOPE("AddNewAuctions.commit");
+
             auto trans = CharacterDatabase.BeginTransaction();
 
             for (auto& [item, auctionEntry] : auctionBatch)
@@ -290,139 +434,674 @@ void AuctionHouseBot::AddNewAuctions(Player* AHBplayer, AHBConfig* config)
                 auctionEntry->SaveToDB(trans);
             }
 
+            for (AuctionEntry* auction : toppedUp)
+            {
+                sAHStatements->Append(trans, AHB_CHAR_UPD_TOP_UP_ITEM, auction->itemCount, auction->item_guid.GetCounter());
+                sAHStatements->Append(trans, AHB_CHAR_UPD_TOP_UP_AUCTION, auction->startbid, auction->buyout, auction->Id);
+            }
+
             CharacterDatabase.CommitTransaction(trans);
+
+            sAHMetrics->Add(AHBCounter::SellerItemsCreated, config->GetAuctionHouseID(), auctionBatch.size());
+            sAHMetrics->Add(AHBCounter::ToppedUp, config->GetAuctionHouseID(), toppedUp.size());
+            sAHMetrics->Add(AHBCounter::DbStatements, config->GetAuctionHouseID(), (auctionBatch.size() + toppedUp.size()) * 2); // item and auction
         }
 
         itemCountToCreate[quality] -= itemBatch.size();
         itemsCount[quality] += itemBatch.size();
         itemsToCreate -= itemBatch.size();
     }
+
+    // Bins that are full again are done, a refill cut short by its share of ItemsPerCycle goes on with the next update
+    for (uint32 i = 0; i < AHB_MAX_QUALITY; ++i)
+        if (config->GetItemCounts(i) >= maxCounts[i])
+            refill.bins.reset(i);
+
+    if (auctionHouse->Getcount() < minItems && GetRefillBins(config).any())
+        refill.pending = true;
+    else
+        refill.removed = 0;
 }
 
-void AuctionHouseBot::AddNewAuctionBuyerBotBid(std::shared_ptr<Player> player, std::shared_ptr<WorldSession> session, AHBConfig* config)
+uint32 AuctionHouseBot::GetSellerDeficit(AHBConfig* config)
 {
-    if (!AHBBuyer)
+    AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(config->GetAuctionHouseFactionID());
+    if (!auctionHouse)
+        return 0;
+
+    const uint32 auctions = auctionHouse->Getcount();
+    if (auctions >= config->GetMinItems() || auctions >= config->GetMaxItems())
+        return 0;
+
+    // What the seller would create without a budget: the bins it refills, up to the house's maximum
+    const std::bitset<AHB_MAX_QUALITY> bins = GetRefillBins(config);
+    uint32 missing = 0;
+    for (uint32 i = 0; i < AHB_MAX_QUALITY; ++i)
+        if (bins[i] && config->GetItemCounts(i) < config->GetMaxCount(i))
+            missing += config->GetMaxCount(i) - config->GetItemCounts(i);
+
+    return std::min(config->GetMaxItems() - auctions, missing);
+}
+
+std::bitset<AHB_MAX_QUALITY> AuctionHouseBot::GetRefillBins(AHBConfig* config)
+{
+    std::bitset<AHB_MAX_QUALITY> withRoom;
+    for (uint32 i = 0; i < AHB_MAX_QUALITY; ++i)
+        if (config->GetItemCounts(i) < config->GetMaxCount(i))
+            withRoom.set(i);
+
+    // Players may have filled the bins that lost auctions in the meantime, a house still below its
+    // minimum then gets every bin with room topped up, like before removals marked them
+    const std::bitset<AHB_MAX_QUALITY> marked = _refills[config->GetAuctionHouseID()].bins & withRoom;
+    return marked.any() ? marked : withRoom;
+}
+
+bool AuctionHouseBot::IsRefillDue(AHBConfig* config, Seconds now)
+{
+    if (!AHBSeller)
+        return false;
+
+    AHBRefill const& refill = _refills[config->GetAuctionHouseID()];
+    return refill.pending && now >= refill.due;
+}
+
+void AuctionHouseBot::RequestRefill(AHBConfig* config)
+{
+    AHBRefill& refill = _refills[config->GetAuctionHouseID()];
+    refill.pending = true;
+    refill.due = 0s;
+    refill.bins.set();
+}
+
+uint64 AuctionHouseBot::GetSellerBasePrice(ItemTemplate const* prototype) const
+{
+    //#TODO "SellMethod" is a bad variable name
+    uint64 basePrice = SellMethod ? prototype->BuyPrice : prototype->SellPrice;
+
+    if (MarketPricesForSeller)
+        if (const auto marketPrice = _priceBook.GetPrice(prototype->ItemId, MarketPricesMinSold))
+            basePrice = *marketPrice;
+
+    return basePrice;
+}
+
+AuctionEntry* AuctionHouseBot::TopUpAuction(AHBConfig* config, AuctionHouseObject* auctionHouse, ItemTemplate const* prototype, uint32 stackCount)
+{
+    const uint32 maxStackSize = GetMaxStackSize(*config, prototype);
+    const time_t now = GameTime::GetGameTime().count();
+    auto const [begin, end] = _botTradeGoods[config->GetAuctionHouseID()].equal_range(prototype->ItemId);
+
+    for (auto itr = begin; itr != end; ++itr)
     {
-        LOG_ERROR("module.ahbot", "AHBuyer: Disabled");
-        return;
-    }
+        // A bidder bid on what was listed, and an auction about to run out would take the new stack with it
+        AuctionEntry* auction = auctionHouse->GetAuction(itr->second);
+        if (!auction || auction->bid || auction->bidder || auction->expire_time <= now + 60 || auction->itemCount >= maxStackSize)
+            continue;
 
-    auto sharedConfig = std::make_shared<AHBConfig>(*config);
+        Item* item = sAuctionMgr->GetAItem(auction->item_guid);
+        if (!item)
+            continue;
 
-    _queryProcessor.AddCallback(CharacterDatabase.AsyncQuery(Acore::StringFormatFmt("SELECT id FROM auctionhouse WHERE itemowner<>{} AND buyguid<>{} AND buyguid=0", AHBplayerGUID, AHBplayerGUID)).
-        WithCallback([this, player, session, sharedConfig](QueryResult result)
-        {
-            AddNewAuctionBuyerBotBidCallback(player, session, sharedConfig, std::move(result));
-        }));
+        const uint32 weight = TrackListingWeight(config, auction, prototype, false);
+        const uint32 count = std::min(auction->itemCount + stackCount, maxStackSize);
+
+        // Same price per item as the listing had
+        auction->startbid = uint64(auction->startbid) * count / auction->itemCount;
+        auction->buyout = uint64(auction->buyout) * count / auction->itemCount;
+        auction->itemCount = count;
+        item->SetCount(count);
+
+        // Lower only if the settings changed since it was counted
+        const uint32 newWeight = TrackListingWeight(config, auction, prototype, true);
+        for (uint32 i = weight; i < newWeight; ++i)
+            config->IncreaseItemCounts(prototype->Class, prototype->Quality);
+        for (uint32 i = newWeight; i < weight; ++i)
+            config->DecreaseItemCounts(prototype->Class, prototype->Quality);
+
+        return auction;
+    }
+
+    return nullptr;
 }
 
-void AuctionHouseBot::AddNewAuctionBuyerBotBidCallback(std::shared_ptr<Player> player, std::shared_ptr<WorldSession> session, std::shared_ptr<AHBConfig> config, QueryResult result)
+uint32 AuctionHouseBot::GetListingWeight(AHBConfig* config, AuctionEntry const* auction, ItemTemplate const* prototype) const
 {
-    if (!result || !result->GetRowCount())
-        return;
+    if (!ConsolidateTradeGoods || prototype->Class != ITEM_CLASS_TRADE_GOODS || auction->owner.GetCounter() != AHBplayerGUID)
+        return 1;
 
-    // Fetches content of selected AH
-    AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(config->GetAuctionHouseFactionID());
-    std::vector<uint32> possibleBids;
+    // The uniform stack size of the seller averages (1 + max) / 2, a stack counts as that many of them rounded
+    const uint32 maxStackSize = GetMaxStackSize(*config, prototype);
+    return std::max(1u, (2 * auction->itemCount + (maxStackSize + 1) / 2) / (maxStackSize + 1));
+}
+
+uint32 AuctionHouseBot::TrackListingWeight(AHBConfig* config, AuctionEntry const* auction, ItemTemplate const* prototype, bool added)
+{
+    // Kept per auction, it is taken back as it was counted even if the settings changed since
+    auto& weights = _listingWeights[config->GetAuctionHouseID()];
 
-    do
+    if (!added)
     {
-        uint32 tmpdata = result->Fetch()->Get<uint32>();
-        possibleBids.push_back(tmpdata);
-    } while (result->NextRow());
+        const auto itr = weights.find(auction->Id);
+        if (itr == weights.end())
+            return 1;
+
+        const uint32 weight = itr->second;
+        weights.erase(itr);
+        return weight;
+    }
 
-    //#TODO std::sample
+    const uint32 weight = GetListingWeight(config, auction, prototype);
+    if (weight > 1)
+        weights[auction->Id] = weight;
 
-    std::vector<uint32> bidTaskList;
+    return weight;
+}
+
+std::array<float, AHB_LEVEL_BRACKETS> AuctionHouseBot::GetBracketWeights(uint32 quality, std::array<uint32, AHB_LEVEL_BRACKETS> const& onlinePlayers) const
+{
+    std::array<float, AHB_LEVEL_BRACKETS> bracketWeights{};
 
-    std::sample(possibleBids.begin(), possibleBids.end(), std::back_inserter(bidTaskList), config->GetBidsPerInterval(), rng);
+    // Restock mostly for the levels of the players that are online, no players online means no preference
+    if (!LevelBracketWeighting || !std::accumulate(onlinePlayers.begin(), onlinePlayers.end(), 0u))
+        return bracketWeights;
 
-    for (const auto randomID : bidTaskList)
+    for (uint32 bracket = 0; bracket < AHB_LEVEL_BRACKETS; ++bracket)
+        if (sAHIndex->CanSampleBracket(quality, bracket))
+            bracketWeights[bracket] = onlinePlayers[bracket] + LevelBracketBaseWeight;
+
+    return bracketWeights;
+}
+
+void AuctionHouseBot::RelistAuctions(AHBConfig* config, AuctionHouseObject* auctionHouse)
+{
+    AHB_PROFILE_SCOPE("RelistAuctions");
+
+    const uint32 houseId = config->GetAuctionHouseID();
+    const time_t now = GameTime::GetGameTime().count();
+    const time_t due = now + RelistWindow.count();
+    auto& queue = _relistQueues[houseId];
+    AHBExpirySchedule& expirySchedule = _expirySchedules[houseId];
+
+    // Every auction of a batch has the same quality, like the seller's
+    std::array<std::vector<AuctionEntry*>, AHB_DEFAULT_QUALITY_SIZE> relisted;
+    uint32 count = 0;
+
+    while (!queue.empty() && queue.front().first <= due)
     {
-        // from auctionhousehandler.cpp, creates auction pointer & player pointer
-        AuctionEntry* auction = auctionHouse->GetAuction(randomID);
+        std::pop_heap(queue.begin(), queue.end(), std::greater<>());
+        const uint32 auctionId = queue.back().second;
+        queue.pop_back();
 
-        if (!auction)
+        // Sold, expired or cancelled since it was pushed
+        AuctionEntry* auction = auctionHouse->GetAuction(auctionId);
+        if (!auction || auction->owner.GetCounter() != AHBplayerGUID)
             continue;
 
-        // get exact item information
-        const Item* pItem = sAuctionMgr->GetAItem(auction->item_guid);
-        if (!pItem)
-        {
-            LOG_DEBUG("module.ahbot", "AHBuyer: Item {} doesn't exist, perhaps bought already?", auction->item_guid.ToString());
+        // Relisted before, it is pushed with every new expire time
+        if (auction->expire_time > due)
             continue;
-        }
 
-        // get item prototype
-        ItemTemplate const* prototype = sObjectMgr->GetItemTemplate(auction->item_template);
+        // Expired by a command, or someone bid on it: left to the core to settle
+        if (auction->expire_time <= now || auction->bidder)
+            continue;
 
-        // check which price we have to use, startbid or if it is bidded already
-        uint32 currentprice;
-        if (auction->bid)
-            currentprice = auction->bid;
-        else
-            currentprice = auction->startbid;
+        ItemTemplate const* prototype = sObjectMgr->GetItemTemplate(auction->item_template);
+        if (!prototype || prototype->Quality >= AHB_DEFAULT_QUALITY_SIZE)
+            continue;
 
-        // Prepare portion from maximum bid
-        float bidrate = frand(0.01f, 1.0f);
-        float bidMax = 0;
+        expirySchedule.Remove(auction->expire_time, now);
+        auction->expire_time = now + expirySchedule.Schedule(now, rng).count();
+        queue.emplace_back(auction->expire_time, auction->Id);
+        std::push_heap(queue.begin(), queue.end(), std::greater<>());
 
-        // check that bid has acceptable value and take bid based on vendorprice, stacksize and quality
+        relisted[prototype->Quality].push_back(auction);
+        ++count;
+    }
 
-        uint32 basePrice = BuyMethod ? prototype->SellPrice : prototype->BuyPrice;
+    if (!count)
+        return;
 
-        if (const auto priceOverride = sAHIndex->GetOverridenPrice(prototype->ItemId, rng))
-            basePrice = *priceOverride;
+    AHBPriceBatch priceBatch;
+    auto trans = CharacterDatabase.BeginTransaction();
 
-        if (prototype->Quality <= AHB_MAX_DEFAULT_QUALITY)
-        {
-            if (currentprice < basePrice * pItem->GetCount() * config->GetBuyerPrice(prototype->Quality))
-                bidMax = basePrice * pItem->GetCount() * config->GetBuyerPrice(prototype->Quality);
-        }
-        else
-        {
-            // quality is something it shouldn't be, let's get out of here
-            LOG_DEBUG("module.ahbot", "AHBuyer: Quality {} not Supported", prototype->Quality);
+    for (uint32 quality = 0; quality < AHB_DEFAULT_QUALITY_SIZE; ++quality)
+    {
+        std::vector<AuctionEntry*> const& auctions = relisted[quality];
+        if (auctions.empty())
             continue;
-        }
 
-        // check some special items, and do recalculating to their prices
-        switch (prototype->Class)
+        if (RelistReprice)
         {
-            // ammo
-        case 6:
-            bidMax = 0;
-            break;
-        default:
-            break;
+            priceBatch.Clear();
+            for (AuctionEntry* auction : auctions)
+                priceBatch.Add(GetSellerBasePrice(sObjectMgr->GetItemTemplate(auction->item_template)), sAHIndex->GetPriceOverride(auction->item_template));
+
+            priceBatch.Calculate(config->GetMinPrice(quality), config->GetMaxPrice(quality), config->GetMinBidPrice(quality), config->GetMaxBidPrice(quality), rng);
+
+            for (std::size_t i = 0; i < auctions.size(); ++i)
+            {
+                auctions[i]->startbid = priceBatch.GetBid(i) * auctions[i]->itemCount;
+                auctions[i]->buyout = priceBatch.GetBuyout(i) * auctions[i]->itemCount;
+            }
         }
 
-        if (bidMax == 0)
+        // The item and the auction stay, one statement instead of an item and an auction deleted and created
+        for (AuctionEntry* auction : auctions)
+            sAHStatements->Append(trans, AHB_CHAR_UPD_RELIST_AUCTION, auction->expire_time, auction->startbid, auction->buyout, auction->Id);
+    }
+
+    CharacterDatabase.CommitTransaction(trans);
+
+    LOG_DEBUG("module.ahbot", "AHSeller: Relisted {} auctions in house {}", count, houseId);
+    sAHMetrics->Add(AHBCounter::Relisted, houseId, count);
+    sAHMetrics->Add(AHBCounter::DbStatements, houseId, count);
+}
+
+bool AuctionHouseBot::IsFilling(uint32 ahMapID) const
+{
+    return std::any_of(_fillJobs.begin(), _fillJobs.end(), [ahMapID](AHBFillJob const& job) { return job.houseId == ahMapID; });
+}
+
+std::string AuctionHouseBot::FillHouse(uint32 ahMapID)
+{
+    for (AHBFillJob const& job : _fillJobs)
+        if (job.houseId == ahMapID)
+            return Acore::StringFormatFmt("Auctionhouse {} is being filled: {}", ahMapID, FormatFillProgress(job));
+
+    if (!AHBSeller)
+        return "The seller is disabled, nothing to fill the auctionhouse with.";
+
+    AHBConfig* config = GetConfig(ahMapID);
+    AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(config->GetAuctionHouseFactionID());
+    const uint32 auctions = auctionHouse->Getcount();
+    const uint32 maxItems = config->GetMaxItems();
+
+    if (auctions >= maxItems)
+        return Acore::StringFormatFmt("Auctionhouse {} already has {} of at most {} auctions.", ahMapID, auctions, maxItems);
+
+    // Like AddNewAuctions() without a per cycle limit: what every bin misses, up to the house's maximum
+    std::array<uint32, AHB_MAX_QUALITY> toCreate{};
+    std::array<std::array<float, AHB_LEVEL_BRACKETS>, AHB_MAX_QUALITY> bracketWeights{};
+    const std::array<uint32, AHB_LEVEL_BRACKETS> onlinePlayers = GetOnlinePlayersPerBracket();
+    uint32 remaining = maxItems - auctions;
+
+    for (uint32 i = 0; i < AHB_MAX_QUALITY && remaining; ++i)
+    {
+        const uint32 have = config->GetItemCounts(i);
+        const uint32 want = (*config->GetMaxCounts())[i];
+        toCreate[i] = std::min(remaining, want > have ? want - have : 0);
+        remaining -= toCreate[i];
+        bracketWeights[i] = GetBracketWeights(i, onlinePlayers);
+    }
+
+    const uint32 total = std::accumulate(toCreate.begin(), toCreate.end(), 0u);
+    if (!total)
+        return Acore::StringFormatFmt("Auctionhouse {} has all the items its settings ask for.", ahMapID);
+
+    AHBFillJob& job = _fillJobs.emplace_back();
+    job.houseId = ahMapID;
+
+    // Drawing the items is all the background does, reloads wait until it is done so the index stays the same
+    job.pendingPlan = std::async(std::launch::async, [config = *config, toCreate, bracketWeights, seed = rng()]() mutable
+    {
+        std::mt19937 planRng(seed);
+
+        std::vector<AHBFillAuction> auctions;
+        auctions.reserve(std::accumulate(toCreate.begin(), toCreate.end(), std::size_t(0)));
+        std::vector<uint32> items;
+
+        for (uint32 quality = 0; quality < AHB_MAX_QUALITY; ++quality)
         {
-            // quality check failed to get bidmax, let's get out of here
-            continue;
+            items.clear();
+            SelectItems(*sAHIndex, quality, toCreate[quality], bracketWeights[quality], items, planRng);
+
+            for (uint32 itemId : items)
+            {
+                ItemTemplate const* prototype = sObjectMgr->GetItemTemplate(itemId);
+                if (!prototype || prototype->Quality > AHB_MAX_DEFAULT_QUALITY)
+                    continue;
+
+                auctions.push_back({ itemId, CalculateStackSize(config, prototype, planRng) });
+            }
         }
 
-        // Calculate our bid
-        float overBidAmount = ((bidMax - currentprice) * bidrate); // How much money we bid, over top of the current price
-        overBidAmount = std::min(overBidAmount, static_cast<float>(currentprice) * 1.2f); // Don't overbid more than 20%, no normal player would do that
-        float bidvalue = static_cast<float>(currentprice) + overBidAmount;
+        // Every chunk gets a bit of every bin, a house filled halfway does not look like one
+        std::shuffle(auctions.begin(), auctions.end(), planRng);
+        return auctions;
+    });
 
-        // Convert to uint32
-        uint32 bidprice = static_cast<uint32>(bidvalue);
+    LOG_INFO("module.ahbot", "AHSeller: Filling auctionhouse {} with {} auctions", ahMapID, total);
+    return Acore::StringFormatFmt("Auctionhouse {} will be filled with {} auctions over the next updates.", ahMapID, total);
+}
 
-        // Check our bid is high enough to be valid. If not, correct it to minimum.
-        if ((currentprice + auction->GetAuctionOutBid()) > bidprice)
-            bidprice = currentprice + auction->GetAuctionOutBid();
+/*static*/ std::string AuctionHouseBot::FormatFillProgress(AHBFillJob const& job)
+{
+    if (job.pendingPlan.valid())
+        return "choosing items";
 
-        LOG_DEBUG("module.ahbot", "-------------------------------------------------");
-        LOG_DEBUG("module.ahbot", "AHBuyer: Info for Auction #{}:", auction->Id);
-        LOG_DEBUG("module.ahbot", "AHBuyer: AuctionHouse: {}", auction->GetHouseId());
-        LOG_DEBUG("module.ahbot", "AHBuyer: Owner: {}", auction->owner.ToString());
-        LOG_DEBUG("module.ahbot", "AHBuyer: Bidder: {}", auction->bidder.ToString());
-        LOG_DEBUG("module.ahbot", "AHBuyer: Starting Bid: {}", auction->startbid);
-        LOG_DEBUG("module.ahbot", "AHBuyer: Current Bid: {}", currentprice);
-        LOG_DEBUG("module.ahbot", "AHBuyer: Buyout: {}", auction->buyout);
+    const std::size_t total = job.auctions.size();
+    if (!job.next)
+        return Acore::StringFormatFmt("0/{} auctions", total);
+
+    // The rate so far, idle time between updates included
+    const auto elapsed = std::chrono::duration_cast<Seconds>(std::chrono::steady_clock::now() - job.started);
+    const uint64 left = uint64(elapsed.count()) * (total - job.next) / job.next;
+
+    return Acore::StringFormatFmt("{}/{} auctions ({}%), about {}m {}s left", job.next, total, job.next * 100 / total, left / 60, left % 60);
+}
+
+void AuctionHouseBot::ProcessFillJobs(Player* AHBplayer)
+{
+    if (_fillJobs.empty())
+        return;
+
+    AHB_PROFILE_SCOPE("ProcessFillJobs");
+
+    constexpr std::size_t auctionsPerStatement = 500;
+
+    const auto start = std::chrono::steady_clock::now();
+    const time_t now = GameTime::GetGameTime().count();
+
+    std::vector<std::pair<Item*, AuctionEntry*>> chunk;
+    chunk.reserve(auctionsPerStatement);
+    std::array<std::vector<std::size_t>, AHB_DEFAULT_QUALITY_SIZE> byQuality;
+    AHBPriceBatch priceBatch;
+    std::string itemValues;
+    std::string auctionValues;
+
+    for (auto job = _fillJobs.begin(); job != _fillJobs.end();)
+    {
+        if (job->pendingPlan.valid())
+        {
+            if (job->pendingPlan.wait_for(0s) != std::future_status::ready)
+            {
+                ++job;
+                continue;
+            }
+
+            job->auctions = job->pendingPlan.get();
+            job->started = std::chrono::steady_clock::now();
+        }
+
+        AHBConfig* config = GetConfig(job->houseId);
+        AuctionHouseEntry const* ahEntry = sAuctionMgr->GetAuctionHouseEntry(config->GetAuctionHouseFactionID());
+        AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(config->GetAuctionHouseFactionID());
+        AHBExpirySchedule& expirySchedule = _expirySchedules[job->houseId];
+        bool outOfTime = false;
+
+        while (job->next < job->auctions.size() && !outOfTime)
+        {
+            chunk.clear();
+            for (auto& indexes : byQuality)
+                indexes.clear();
+
+            const std::size_t end = std::min(job->next + auctionsPerStatement, job->auctions.size());
+
+            for (; job->next < end; ++job->next)
+            {
+                AHBFillAuction const& planned = job->auctions[job->next];
+                ItemTemplate const* prototype = sObjectMgr->GetItemTemplate(planned.itemId);
+                if (!prototype)
+                    continue;
+
+                // Not added to the bot's update queue, the rows are written below and the item is never saved by it
+                Item* item = Item::CreateItem(planned.itemId, 1, AHBplayer);
+                if (!item)
+                    continue;
+
+                const int32 randomPropertyId = Item::GenerateItemRandomPropertyId(planned.itemId);
+                if (randomPropertyId != 0)
+                    item->SetItemRandomProperties(randomPropertyId);
+
+                item->SetCount(planned.stackCount);
+
+                AuctionEntry* auctionEntry = new AuctionEntry();
+                auctionEntry->Id = sObjectMgr->GenerateAuctionID();
+                auctionEntry->houseId = config->GetAuctionHouseID();
+                auctionEntry->item_guid = item->GetGUID();
+                auctionEntry->item_template = item->GetEntry();
+                auctionEntry->itemCount = item->GetCount();
+                auctionEntry->owner = AHBplayer->GetGUID();
+                auctionEntry->bid = 0;
+                // Chosen here rather than in the plan, the histogram is only touched by the world thread
+                const Seconds lifeTime = expirySchedule.Schedule(now, rng);
+
+                auctionEntry->deposit = sAuctionMgr->GetAuctionDeposit(ahEntry, lifeTime.count(), item, planned.stackCount);
+                auctionEntry->expire_time = now + lifeTime.count();
+                auctionEntry->auctionHouseEntry = ahEntry;
+
+                byQuality[prototype->Quality].push_back(chunk.size());
+                chunk.emplace_back(item, auctionEntry);
+            }
+
+            // Priced like the seller's batches, every batch of one quality
+            for (uint32 quality = 0; quality < AHB_DEFAULT_QUALITY_SIZE; ++quality)
+            {
+                if (byQuality[quality].empty())
+                    continue;
+
+                priceBatch.Clear();
+                for (std::size_t index : byQuality[quality])
+                    priceBatch.Add(GetSellerBasePrice(chunk[index].first->GetTemplate()), sAHIndex->GetPriceOverride(chunk[index].first->GetEntry()));
+
+                priceBatch.Calculate(config->GetMinPrice(quality), config->GetMaxPrice(quality), config->GetMinBidPrice(quality), config->GetMaxBidPrice(quality), rng);
+
+                for (std::size_t i = 0; i < byQuality[quality].size(); ++i)
+                {
+                    AuctionEntry* auctionEntry = chunk[byQuality[quality][i]].second;
+                    auctionEntry->startbid = priceBatch.GetBid(i) * auctionEntry->itemCount;
+                    auctionEntry->buyout = priceBatch.GetBuyout(i) * auctionEntry->itemCount;
+                }
+            }
+
+            if (chunk.empty())
+                continue;
+
+            // Two statements for the whole chunk instead of two per auction
+            itemValues.clear();
+            auctionValues.clear();
+            for (auto const& [item, auctionEntry] : chunk)
+            {
+                AppendItemInstanceRow(itemValues, item, AHBplayerGUID);
+                AppendAuctionRow(auctionValues, auctionEntry);
+            }
+
+            auto trans = CharacterDatabase.BeginTransaction();
+            sAHStatements->Append(trans, AHB_CHAR_INS_ITEM_INSTANCES, itemValues);
+            sAHStatements->Append(trans, AHB_CHAR_INS_AUCTIONS, auctionValues);
+            CharacterDatabase.CommitTransaction(trans);
+
+            for (auto& [item, auctionEntry] : chunk)
+            {
+                // In the database already, the item must not be inserted a second time when it is saved next
+                item->FSetState(ITEM_UNCHANGED);
+                sAuctionMgr->AddAItem(item);
+                auctionHouse->AddAuction(auctionEntry);
+            }
+
+            sAHMetrics->Add(AHBCounter::SellerItemsCreated, job->houseId, chunk.size());
+            sAHMetrics->Add(AHBCounter::DbStatements, job->houseId, 2);
+
+            outOfTime = std::chrono::steady_clock::now() - start >= MassOperationBudget;
+        }
+
+        if (job->next < job->auctions.size())
+        {
+            LOG_INFO("module.ahbot", "AHSeller: Filling auctionhouse {}: {}", job->houseId, FormatFillProgress(*job));
+            return;
+        }
+
+        LOG_INFO("module.ahbot", "AHSeller: Filled auctionhouse {} with {} auctions in {}s", job->houseId, job->auctions.size(),
+            std::chrono::duration_cast<Seconds>(std::chrono::steady_clock::now() - job->started).count());
+        job = _fillJobs.erase(job);
+    }
+}
+
+void AuctionHouseBot::AddNewAuctionBuyerBotBid(AHBConfig* config)
+{
+    if (!AHBBuyer)
+    {
+        LOG_ERROR("module.ahbot", "AHBuyer: Disabled");
+        return;
+    }
+
+    // A callback bids for at most this many intervals at once, a long stall of the database is not made up for in one burst
+    constexpr uint32 maxCoalescedIntervals = 4;
+
+    const uint32 houseId = config->GetAuctionHouseID();
+
+    // The result of the latest query still on its way answers for this interval too, a slow database does not pile them up
+    if (GetPendingBuyerQueries(houseId) >= BuyerMaxPendingQueries)
+    {
+        AHBBuyerQuery* latest = nullptr;
+        for (auto& [queryId, query] : _buyerQueries)
+            if (query.houseId == houseId && (!latest || query.sent > latest->sent))
+                latest = &query;
+
+        if (latest->intervals >= maxCoalescedIntervals)
+        {
+            LOG_DEBUG("module.ahbot", "AHBuyer: Query of house {} still pending for {} intervals, interval dropped", houseId, latest->intervals);
+            sAHMetrics->Add(AHBCounter::BuyerIntervalsDropped, houseId);
+            return;
+        }
+
+        ++latest->intervals;
+        LOG_DEBUG("module.ahbot", "AHBuyer: Query of house {} still pending, it bids for {} intervals", houseId, latest->intervals);
+        sAHMetrics->Add(AHBCounter::BuyerQueriesCoalesced, houseId);
+        return;
+    }
+
+    const uint32 queryId = ++_lastBuyerQueryId;
+    _buyerQueries[queryId] = { houseId, 1, std::chrono::steady_clock::now() };
+
+    sAHMetrics->AddGauge(AHBGauge::PendingBuyerQueries, 1);
+    _queryProcessor.AddCallback(sAHStatements->AsyncQuery(AHB_CHAR_SEL_BUYER_AUCTIONS, [this, queryId](QueryResult result)
+        {
+            AddNewAuctionBuyerBotBidCallback(queryId, std::move(result));
+        }, AHBplayerGUID, AHBplayerGUID));
+}
+
+uint32 AuctionHouseBot::GetPendingBuyerQueries(uint32 houseId) const
+{
+    return std::count_if(_buyerQueries.begin(), _buyerQueries.end(), [houseId](auto const& query) { return query.second.houseId == houseId; });
+}
+
+void AuctionHouseBot::AddNewAuctionBuyerBotBidCallback(uint32 queryId, QueryResult result)
+{
+    const auto query = _buyerQueries.find(queryId);
+    if (query == _buyerQueries.end())
+        return;
+
+    const uint32 houseId = query->second.houseId;
+    const uint32 intervals = query->second.intervals;
+    _buyerQueries.erase(query);
+    sAHMetrics->AddGauge(AHBGauge::PendingBuyerQueries, -1);
+
+    if (!result || !result->GetRowCount())
+        return;
+
+    // The settings and the bot's player as they are now, not as they were when the query was sent
+    AHBConfig* config = GetConfig(houseId);
+    Player* player = GetBotPlayer();
+
+    AHBScopedTimer buyerTimer(AHBTimer::BuyerCallback, config->GetAuctionHouseID());
+    AHB_PROFILE_SCOPE("AddNewAuctionBuyerBotBidCallback");
+
+    // Fetches content of selected AH
+    AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(config->GetAuctionHouseFactionID());
+    std::vector<uint32> possibleBids;
+
+    {
+        AHB_PROFILE_SCOPE("AddNewAuctionBuyerBotBidCallback.fetch");
+
+        do
+        {
+            uint32 tmpdata = result->Fetch()->Get<uint32>();
+            possibleBids.push_back(tmpdata);
+        } while (result->NextRow());
+    }
+
+    std::vector<uint32> bidTaskList;
+
+    {
+        AHB_PROFILE_SCOPE("AddNewAuctionBuyerBotBidCallback.sample");
+        std::sample(possibleBids.begin(), possibleBids.end(), std::back_inserter(bidTaskList), config->GetBidsPerInterval() * intervals, rng);
+    }
+
+    for (const auto randomID : bidTaskList)
+    {
+        // Includes persisting the bid, if there is one
+        AHB_PROFILE_SCOPE("AddNewAuctionBuyerBotBidCallback.evaluate");
+
+        // from auctionhousehandler.cpp, creates auction pointer & player pointer
+        AuctionEntry* auction = auctionHouse->GetAuction(randomID);
+
+        if (!auction)
+            continue;
+
+        // get exact item information
+        const Item* pItem = sAuctionMgr->GetAItem(auction->item_guid);
+        if (!pItem)
+        {
+            LOG_DEBUG("module.ahbot", "AHBuyer: Item {} doesn't exist, perhaps bought already?", auction->item_guid.ToString());
+            continue;
+        }
+
+        // get item prototype
+        ItemTemplate const* prototype = sObjectMgr->GetItemTemplate(auction->item_template);
+
+        // check which price we have to use, startbid or if it is bidded already
+        uint32 currentprice;
+        if (auction->bid)
+            currentprice = auction->bid;
+        else
+            currentprice = auction->startbid;
+
+        // Prepare portion from maximum bid
+        float bidrate = frand(0.01f, 1.0f);
+
+        // check that bid has acceptable value and take bid based on vendorprice, stacksize and quality
+
+        uint32 basePrice = BuyMethod ? prototype->SellPrice : prototype->BuyPrice;
+
+        if (MarketPricesForBuyer)
+            if (const auto marketPrice = _priceBook.GetPrice(prototype->ItemId, MarketPricesMinSold))
+                basePrice = *marketPrice;
+
+        if (const auto priceOverride = sAHIndex->GetOverridenPrice(prototype->ItemId, rng))
+            basePrice = *priceOverride;
+
+        if (prototype->Quality > AHB_MAX_DEFAULT_QUALITY)
+        {
+            // quality is something it shouldn't be, let's get out of here
+            LOG_DEBUG("module.ahbot", "AHBuyer: Quality {} not Supported", prototype->Quality);
+            continue;
+        }
+
+        // ammo
+        if (prototype->Class == ITEM_CLASS_PROJECTILE)
+            continue;
+
+        const AHBBuyerBid bid = CalculateBuyerBid(currentprice, basePrice, pItem->GetCount(), config->GetBuyerPrice(prototype->Quality), auction->GetAuctionOutBid(), bidrate);
+
+        if (bid.bidMax == 0)
+        {
+            // quality check failed to get bidmax, let's get out of here
+            continue;
+        }
+
+        const float bidMax = bid.bidMax;
+        const float bidvalue = bid.bidValue;
+        const uint32 bidprice = bid.bidPrice;
+
+        LOG_DEBUG("module.ahbot", "-------------------------------------------------");
+        LOG_DEBUG("module.ahbot", "AHBuyer: Info for Auction #{}:", auction->Id);
+        LOG_DEBUG("module.ahbot", "AHBuyer: AuctionHouse: {}", auction->GetHouseId());
+        LOG_DEBUG("module.ahbot", "AHBuyer: Owner: {}", auction->owner.ToString());
+        LOG_DEBUG("module.ahbot", "AHBuyer: Bidder: {}", auction->bidder.ToString());
+        LOG_DEBUG("module.ahbot", "AHBuyer: Starting Bid: {}", auction->startbid);
+        LOG_DEBUG("module.ahbot", "AHBuyer: Current Bid: {}", currentprice);
+        LOG_DEBUG("module.ahbot", "AHBuyer: Buyout: {}", auction->buyout);
         LOG_DEBUG("module.ahbot", "AHBuyer: Deposit: {}", auction->deposit);
         LOG_DEBUG("module.ahbot", "AHBuyer: Expire Time: {}", uint32(auction->expire_time));
         LOG_DEBUG("module.ahbot", "AHBuyer: Bid Rate: {}", bidrate);
@@ -441,150 +1120,972 @@ void AuctionHouseBot::AddNewAuctionBuyerBotBidCallback(std::shared_ptr<Player> p
         LOG_DEBUG("module.ahbot", "AHBuyer: Ammo Type: {}", prototype->AmmoType);
         LOG_DEBUG("module.ahbot", "-------------------------------------------------");
 
-        // Check whether we do normal bid, or buyout
-        if (bidprice < auction->buyout || !auction->buyout)
-        {
-            if (auction->bidder && auction->bidder != player->GetGUID())
-            {
-                auto trans = CharacterDatabase.BeginTransaction();
-                sAuctionMgr->SendAuctionOutbiddedMail(auction, bidprice, player.get(), trans);
-                CharacterDatabase.CommitTransaction(trans);
-            }
+        AHB_PROFILE_SCOPE("AddNewAuctionBuyerBotBidCallback.persist");
+
+        // Check whether we do normal bid, or buyout
+        if (bidprice < auction->buyout || !auction->buyout)
+        {
+            if (auction->bidder && auction->bidder != player->GetGUID())
+            {
+                auto trans = CharacterDatabase.BeginTransaction();
+                sAuctionMgr->SendAuctionOutbiddedMail(auction, bidprice, player, trans);
+                CharacterDatabase.CommitTransaction(trans);
+                sAHMetrics->Add(AHBCounter::DbStatements, config->GetAuctionHouseID());
+            }
+
+            auction->bidder = player->GetGUID();
+            auction->bid = bidprice;
+
+            // Saving auction into database
+            sAHStatements->Execute(AHB_CHAR_UPD_AUCTION_BID, false, auction->bidder.GetCounter(), auction->bid, auction->Id);
+            sAHMetrics->Add(AHBCounter::BuyerBids, config->GetAuctionHouseID());
+            sAHMetrics->Add(AHBCounter::DbStatements, config->GetAuctionHouseID());
+        }
+        else
+        {
+            auto trans = CharacterDatabase.BeginTransaction();
+
+            // Buyout
+            if (auction->bidder && player->GetGUID() != auction->bidder)
+                sAuctionMgr->SendAuctionOutbiddedMail(auction, auction->buyout, player, trans);
+
+            auction->bidder = player->GetGUID();
+            auction->bid = auction->buyout;
+
+            // Send mails to buyer & seller
+            //sAuctionMgr->SendAuctionSalePendingMail(auction, trans);
+            sAuctionMgr->SendAuctionSuccessfulMail(auction, trans);
+
+            // What we win only goes to our own mailbox to be thrown away, it is destroyed directly instead
+            if (!SettleBotItem(auction))
+                sAuctionMgr->SendAuctionWonMail(auction, trans);
+
+            auction->DeleteFromDB(trans);
+
+            sAuctionMgr->RemoveAItem(auction->item_guid);
+            auctionHouse->RemoveAuction(auction);
+            CharacterDatabase.CommitTransaction(trans);
+
+            // Mails and the delete, counted as one
+            sAHMetrics->Add(AHBCounter::BuyerBuyouts, config->GetAuctionHouseID());
+            sAHMetrics->Add(AHBCounter::DbStatements, config->GetAuctionHouseID());
+        }
+    }
+}
+
+void AuctionHouseBot::Update()
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    {
+        AHBScopedTimer updateTimer(AHBTimer::Update, 0);
+        AHB_PROFILE_SCOPE("Update");
+        UpdateHouses();
+    }
+
+    _tickBudget.Record(std::chrono::duration_cast<Microseconds>(std::chrono::steady_clock::now() - start));
+}
+
+void AuctionHouseBot::UpdateHouses()
+{
+    {
+        AHBScopedTimer maintenanceTimer(AHBTimer::UpdateMaintenance, 0);
+
+        ApplyReload();
+        ProcessExpireJobs();
+        ProcessPurgeJobs();
+        FlushSettlements();
+
+        if (MarketPrices && GameTime::GetGameTime() - _lastMarketPricesFlush >= MarketPricesFlushInterval)
+        {
+            _priceBook.Flush();
+            _lastMarketPricesFlush = GameTime::GetGameTime();
+        }
+    }
+
+    if (!AHBSeller && !AHBBuyer)
+        return;
+
+    if (!AHBplayerAccount || !AHBplayerGUID)
+    {
+        LOG_ERROR("module.ahbot", "{}: Invalid player data. Account {}. Guid {}", __FUNCTION__, AHBplayerAccount, AHBplayerGUID);
+        return;
+    }
+
+    Seconds newUpdate = GameTime::GetGameTime();
+
+    // While over its time budget the bot may defer the buyer and work on one house per update only.
+    // A deferred buyer keeps its last bid time, so it bids as soon as it is allowed to again.
+    const bool twoSide = sWorld->getBoolConfig(CONFIG_ALLOW_TWO_SIDE_INTERACTION_AUCTION);
+    const uint32 houseCount = twoSide ? 1 : 3;
+    const bool buyer = !_tickBudget.IsBuyerDeferred();
+
+    // Houses being filled get nothing from the seller until the fill is done
+    auto sellerDue = [&](uint32 slot, AHBConfig& config)
+    {
+        return !_tickBudget.ShouldSkipHouse(slot, houseCount) && !IsFilling(config.GetAuctionHouseID()) && IsRefillDue(&config, newUpdate);
+    };
+
+    auto buyerDue = [&](AHBConfig& config, Seconds lastUpdate)
+    {
+        return AHBBuyer && buyer && newUpdate - lastUpdate >= config.GetBiddingInterval() && config.GetBidsPerInterval() > 0;
+    };
+
+    const bool allianceSeller = !twoSide && sellerDue(0, AllianceConfig);
+    const bool allianceBuyer = !twoSide && buyerDue(AllianceConfig, _lastUpdateAlliance);
+    const bool hordeSeller = !twoSide && sellerDue(1, HordeConfig);
+    const bool hordeBuyer = !twoSide && buyerDue(HordeConfig, _lastUpdateHorde);
+    const bool neutralSeller = sellerDue(houseCount - 1, NeutralConfig);
+    const bool neutralBuyer = buyerDue(NeutralConfig, _lastUpdateNeutral);
+
+    // Relisting only changes auctions already listed, it does not wait for a refill
+    if (AHBSeller && Relist)
+    {
+        for (AHBConfig* config : { &AllianceConfig, &HordeConfig, &NeutralConfig })
+        {
+            if (twoSide && config != &NeutralConfig)
+                continue;
+
+            if (config->GetMaxItems() && !IsFilling(config->GetAuctionHouseID()))
+                if (AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(config->GetAuctionHouseFactionID()))
+                    RelistAuctions(config, auctionHouse);
+        }
+    }
+
+    // The bot's player is only created if something below needs it, an update with nothing to sell or bid on does not
+    if (!_fillJobs.empty())
+        ProcessFillJobs(GetBotPlayer());
+
+    // One budget for the houses the seller works on in this update
+    const std::vector<uint32> deficits =
+    {
+        allianceSeller ? GetSellerDeficit(&AllianceConfig) : 0,
+        hordeSeller ? GetSellerDeficit(&HordeConfig) : 0,
+        neutralSeller ? GetSellerDeficit(&NeutralConfig) : 0
+    };
+
+    const std::vector<uint32> shares = ShareItemBudget(_tickBudget.GetItemsPerCycle(ItemsPerCycle), deficits, ItemsPerCycleMinShare);
+
+    // A house that misses auctions but got no share waits for the next update, its refill stays pending
+    auto sell = [&](bool due, std::size_t house, AHBConfig& config)
+    {
+        if (due && (shares[house] || !deficits[house]))
+            AddNewAuctions(GetBotPlayer(), &config, shares[house]);
+    };
+
+    // Add New Bids
+    if (!twoSide)
+    {
+        sell(allianceSeller, 0, AllianceConfig);
+
+        if (allianceBuyer)
+        {
+            LOG_DEBUG("module.ahbot", "AHBuyer: {} seconds have passed since last bid", newUpdate.count() - _lastUpdateAlliance.count());
+            LOG_DEBUG("module.ahbot", "AHBuyer: Bidding on Alliance Auctions");
+            AddNewAuctionBuyerBotBid(&AllianceConfig);
+            _lastUpdateAlliance = newUpdate;
+        }
+
+        sell(hordeSeller, 1, HordeConfig);
+
+        if (hordeBuyer)
+        {
+            LOG_DEBUG("module.ahbot", "AHBuyer: {} seconds have passed since last bid", newUpdate.count() - _lastUpdateHorde.count());
+            LOG_DEBUG("module.ahbot", "AHBuyer: Bidding on Horde Auctions");
+            AddNewAuctionBuyerBotBid(&HordeConfig);
+            _lastUpdateHorde = newUpdate;
+        }
+    }
+
+    sell(neutralSeller, 2, NeutralConfig);
+
+    if (neutralBuyer)
+    {
+        LOG_DEBUG("module.ahbot", "AHBuyer: {} seconds have passed since last bid", newUpdate.count() - _lastUpdateNeutral.count());
+        LOG_DEBUG("module.ahbot", "AHBuyer: Bidding on Neutral Auctions");
+        AddNewAuctionBuyerBotBid(&NeutralConfig);
+        _lastUpdateNeutral = newUpdate;
+    }
+
+    ProcessQueryCallbacks();
+    ReleaseBotPlayer();
+}
+
+Player* AuctionHouseBot::GetBotPlayer()
+{
+    if (_botPlayer)
+        return _botPlayer.get();
+
+    std::string accountName = "AuctionHouseBot_" + std::to_string(AHBplayerAccount);
+
+    _botSession = std::make_shared<WorldSession>(AHBplayerAccount, std::move(accountName), nullptr, SEC_PLAYER, sWorld->getIntConfig(CONFIG_EXPANSION), 0, LOCALE_enUS, 0, false, true, 0);
+
+    _botPlayer.reset(new Player(_botSession.get()), [](Player* ptr)
+    {
+        ObjectAccessor::RemoveObject(ptr);
+        delete ptr;
+    });
+
+    _botPlayer->Initialize(AHBplayerGUID);
+
+    ObjectAccessor::AddObject(_botPlayer.get());
+    return _botPlayer.get();
+}
+
+void AuctionHouseBot::ReleaseBotPlayer()
+{
+    // The player refers to its session, it goes first
+    _botPlayer.reset();
+    _botSession.reset();
+}
+
+void AuctionHouseBot::Initialize()
+{
+    sAHIndex->Initialize();
+
+    // Loaded even if tracking is disabled, so enabling it with a reload does not overwrite the stored prices
+    _priceBook.Load();
+    _lastMarketPricesFlush = GameTime::GetGameTime();
+
+    if (AHBSeller)
+        if (!sAHIndex->InitializeItemsToSell())
+            AHBSeller = false;
+
+    if (!sWorld->getBoolConfig(CONFIG_ALLOW_TWO_SIDE_INTERACTION_AUCTION))
+    {
+        LoadValues(&AllianceConfig);
+        LoadValues(&HordeConfig);
+    }
+
+    LoadValues(&NeutralConfig);
+
+    //
+    // check if the AHBot account/GUID in the config actually exists
+    //
+
+    if (AHBplayerAccount || AHBplayerGUID)
+    {
+        QueryResult result = sAHStatements->Query(AHB_CHAR_SEL_BOT_CHARACTER, AHBplayerAccount, AHBplayerGUID);
+        if (!result)
+        {
+            LOG_ERROR("module", "AuctionHouseBot: The account/GUID-information set for your AHBot is incorrect (account: {} guid: {})", AHBplayerAccount, AHBplayerGUID);
+            return;
+        }
+    }
+
+    LOG_INFO("module", "AuctionHouseBot has been loaded.");
+}
+
+bool AuctionHouseBot::ScheduleReload()
+{
+    if (_pendingReload.valid())
+        return false;
+
+    const bool wasSeller = AHBSeller;
+    const bool wasRelisting = Relist;
+    InitializeConfiguration();
+
+    // A seller switched on by the reload waits for its items and the counts of the houses
+    const bool enablesSeller = AHBSeller && !wasSeller;
+    if (enablesSeller)
+        AHBSeller = false;
+
+    // The reload reads the settings back, pending changes have to be in the table by then
+    FlushConfig(true);
+
+    std::vector<AHBConfig> configs;
+
+    if (!sWorld->getBoolConfig(CONFIG_ALLOW_TWO_SIDE_INTERACTION_AUCTION))
+    {
+        configs.emplace_back(AUCTIONHOUSE_ALLIANCE);
+        configs.emplace_back(AUCTIONHOUSE_HORDE);
+    }
+
+    configs.emplace_back(AUCTIONHOUSE_NEUTRAL);
+
+    if (Relist != wasRelisting)
+        for (AHBConfig const& config : configs)
+            RebuildRelistQueue(GetConfig(config.GetAuctionHouseID()));
+
+    // Only touches the database and its own copies, the live index is only read to diff against.
+    // It is not written until ApplyReload(), which waits for this to finish.
+    _pendingReload = std::async(std::launch::async, [this, configs = std::move(configs), seller = AHBSeller || enablesSeller, enablesSeller]() mutable
+    {
+        auto reload = std::make_unique<AHBReloadData>();
+        reload->enablesSeller = enablesSeller;
+
+        reload->index.Initialize();
+
+        if (seller)
+            reload->itemsLoaded = reload->index.InitializeItemsToSell();
+
+        for (AHBConfig& config : configs)
+            LoadSettings(&config);
+
+        reload->configs = std::move(configs);
+        reload->binChanges = reload->index.DiffItemBins(*sAHIndex);
+        return reload;
+    });
+
+    return true;
+}
+
+void AuctionHouseBot::ApplyReload()
+{
+    if (!_pendingReload.valid() || _pendingReload.wait_for(0s) != std::future_status::ready)
+        return;
+
+    // A bulk fill still drawing its items reads the index
+    if (std::any_of(_fillJobs.begin(), _fillJobs.end(), [](AHBFillJob const& job) { return job.pendingPlan.valid(); }))
+        return;
+
+    std::unique_ptr<AHBReloadData> reload = _pendingReload.get();
+
+    uint32 changedBins = 0;
+    for (uint32 i = 0; i < AHB_MAX_QUALITY; ++i)
+    {
+        auto const [added, removed] = reload->binChanges[i];
+        if (!added && !removed)
+            continue;
+
+        ++changedBins;
+        LOG_INFO("module.ahbot", "AuctionHouseBot: Reload changed {}: {} added, {} removed", GetAHBQualityName(i), added, removed);
+    }
+
+    uint32 changedHouses = 0;
+    for (AHBConfig& newConfig : reload->configs)
+    {
+        AHBConfig* config = GetConfig(newConfig.GetAuctionHouseID());
+
+        // Commands run while the settings were read are newer than the table
+        _configStore.KeepChanges(newConfig, *config);
+
+        if (config->HasSameSettings(newConfig))
+            continue;
+
+        // Item counts are kept up to date by the auction hooks, no need to rescan the house
+        config->ApplySettings(newConfig);
+        RequestRefill(config);
+        ++changedHouses;
+        LOG_INFO("module.ahbot", "AuctionHouseBot: Reload changed settings of auctionhouse {}", newConfig.GetAuctionHouseID());
+    }
+
+    if (AHBSeller && !reload->itemsLoaded)
+        AHBSeller = false;
+
+    *sAHIndex = std::move(reload->index);
+
+    // Nothing counted the houses while the seller was off
+    if (reload->enablesSeller && reload->itemsLoaded)
+    {
+        AHBSeller = true;
+        for (AHBConfig const& newConfig : reload->configs)
+            CountItems(GetConfig(newConfig.GetAuctionHouseID()));
+    }
+
+    LOG_INFO("module.ahbot", "AuctionHouseBot: Reload applied, {} bins and {} auctionhouses changed", changedBins, changedHouses);
+}
+
+AHBConfig* AuctionHouseBot::GetConfig(uint32 ahMapID)
+{
+    switch (ahMapID)
+    {
+    case AUCTIONHOUSE_ALLIANCE:
+        return &AllianceConfig;
+    case AUCTIONHOUSE_HORDE:
+        return &HordeConfig;
+    default:
+        return &NeutralConfig;
+    }
+}
+
+AHBConfig* AuctionHouseBot::GetConfig(AuctionEntry const* auction)
+{
+    AuctionHouseEntry const* ahEntry = sAuctionHouseStore.LookupEntry(auction->houseId);
+    if (!ahEntry)
+    {
+        LOG_DEBUG("module.ahbot", "AHBot: {} returned as House Faction. Neutral", auction->houseId);
+        return &NeutralConfig;
+    }
+
+    return GetConfig(ahEntry->houseId);
+}
+
+void AuctionHouseBot::TrackBotAuction(AHBConfig* config, AuctionEntry const* auction, ItemTemplate const* prototype, bool added)
+{
+    if (auction->owner.GetCounter() != AHBplayerGUID)
+        return;
+
+    auto& botAuctions = _botAuctions[config->GetAuctionHouseID()];
+
+    if (added)
+    {
+        botAuctions[auction->Id] = prototype->Class;
+
+        if (prototype->Class == ITEM_CLASS_TRADE_GOODS)
+            _botTradeGoods[config->GetAuctionHouseID()].emplace(auction->item_template, auction->Id);
+
+        // Only RelistAuctions() pops it, a reload that turns relisting on rebuilds it from _botAuctions
+        if (Relist)
+        {
+            auto& queue = _relistQueues[config->GetAuctionHouseID()];
+            queue.emplace_back(auction->expire_time, auction->Id);
+            std::push_heap(queue.begin(), queue.end(), std::greater<>());
+        }
+    }
+    else
+    {
+        botAuctions.erase(auction->Id);
+
+        if (prototype->Class == ITEM_CLASS_TRADE_GOODS)
+        {
+            auto& tradeGoods = _botTradeGoods[config->GetAuctionHouseID()];
+            auto const [begin, end] = tradeGoods.equal_range(auction->item_template);
+            const auto itr = std::find_if(begin, end, [auction](auto const& entry) { return entry.second == auction->Id; });
+            if (itr != end)
+                tradeGoods.erase(itr);
+        }
+
+        // Sold or purged before it ran out, expired ones are in the past of the histogram already
+        _expirySchedules[config->GetAuctionHouseID()].Remove(auction->expire_time, GameTime::GetGameTime().count());
+    }
+}
+
+void AuctionHouseBot::RebuildRelistQueue(AHBConfig* config)
+{
+    auto& queue = _relistQueues[config->GetAuctionHouseID()];
+    queue.clear();
+
+    if (!Relist)
+    {
+        queue.shrink_to_fit();
+        return;
+    }
+
+    AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(config->GetAuctionHouseFactionID());
+    for (auto const& [auctionId, itemClass] : _botAuctions[config->GetAuctionHouseID()])
+        if (AuctionEntry const* auction = auctionHouse->GetAuction(auctionId))
+            queue.emplace_back(auction->expire_time, auctionId);
+
+    std::make_heap(queue.begin(), queue.end(), std::greater<>());
+}
+
+void AuctionHouseBot::QueueExpireJob(uint32 ahMapID, std::optional<uint32> itemClass)
+{
+    AHBExpireJob job;
+    job.houseId = ahMapID;
+    job.byClass = itemClass.has_value();
+
+    // The index only holds our own auctions, no need to look at the whole house or at item templates
+    for (auto const& [auctionId, auctionClass] : _botAuctions[ahMapID])
+        if (!itemClass || auctionClass == *itemClass)
+            job.auctionIds.push_back(auctionId);
+
+    if (job.auctionIds.empty())
+    {
+        LOG_INFO("module.ahbot", "AHSeller: No auctions to expire in house {}", ahMapID);
+        return;
+    }
+
+    // Everything we own in the house, one statement. By class needs the ids, those are written as the job progresses.
+    if (!job.byClass)
+    {
+        sAHStatements->Execute(AHB_CHAR_UPD_EXPIRE_HOUSE, false, GameTime::GetGameTime().count(), AHBplayerGUID, ahMapID);
+        sAHMetrics->Add(AHBCounter::DbStatements, ahMapID);
+    }
+
+    LOG_INFO("module.ahbot", "AHSeller: Expiring {} auctions in house {}", job.auctionIds.size(), ahMapID);
+    _expireJobs.push_back(std::move(job));
+}
+
+void AuctionHouseBot::ProcessExpireJobs()
+{
+    if (_expireJobs.empty())
+        return;
+
+    constexpr std::size_t idsPerStatement = 1000;
+    constexpr std::size_t itemsPerClockCheck = 256;
+
+    const auto start = std::chrono::steady_clock::now();
+    const uint32 now = GameTime::GetGameTime().count();
+
+    while (!_expireJobs.empty())
+    {
+        AHBExpireJob& job = _expireJobs.front();
+        AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(GetConfig(job.houseId)->GetAuctionHouseFactionID());
+        std::string ids;
+
+        auto writeIds = [&]()
+        {
+            if (ids.empty())
+                return;
+
+            sAHStatements->Execute(AHB_CHAR_UPD_EXPIRE_AUCTIONS, false, now, ids);
+            sAHMetrics->Add(AHBCounter::DbStatements, job.houseId);
+            ids.clear();
+        };
+
+        bool outOfTime = false;
+        std::size_t inStatement = 0;
+
+        while (job.next < job.auctionIds.size())
+        {
+            const uint32 auctionId = job.auctionIds[job.next++];
+
+            // Sold or expired since the job was queued
+            if (AuctionEntry* auction = auctionHouse->GetAuction(auctionId))
+            {
+                _expirySchedules[job.houseId].Remove(auction->expire_time, now);
+                auction->expire_time = now;
+                ++job.expired;
+
+                if (job.byClass)
+                {
+                    if (!ids.empty())
+                        ids += ',';
+                    ids += std::to_string(auctionId);
+
+                    if (++inStatement == idsPerStatement)
+                    {
+                        writeIds();
+                        inStatement = 0;
+                    }
+                }
+            }
+
+            if (job.next % itemsPerClockCheck == 0 && std::chrono::steady_clock::now() - start >= MassOperationBudget)
+            {
+                outOfTime = true;
+                break;
+            }
+        }
+
+        writeIds();
+
+        if (outOfTime && job.next < job.auctionIds.size())
+        {
+            LOG_INFO("module.ahbot", "AHSeller: Expiring auctions in house {}: {}/{}", job.houseId, job.next, job.auctionIds.size());
+            return;
+        }
+
+        LOG_INFO("module.ahbot", "AHSeller: Manually expired {} Auctions in house {}", job.expired, job.houseId);
+        _expireJobs.pop_front();
+
+        if (outOfTime)
+            return;
+    }
+}
+
+uint32 AuctionHouseBot::PurgeHouse(uint32 ahMapID, std::optional<uint32> itemClass, std::optional<uint32> quality)
+{
+    AHBPurgeJob job;
+    job.houseId = ahMapID;
+    job.quality = quality;
+
+    // The quality is looked up as the job gets to the auction, the index only knows the class
+    for (auto const& [auctionId, auctionClass] : _botAuctions[ahMapID])
+        if (!itemClass || auctionClass == *itemClass)
+            job.auctionIds.push_back(auctionId);
+
+    const uint32 queued = job.auctionIds.size();
+    if (!queued)
+        return 0;
+
+    LOG_INFO("module.ahbot", "AHSeller: Purging up to {} auctions in house {}", queued, ahMapID);
+    _purgeJobs.push_back(std::move(job));
+    return queued;
+}
+
+void AuctionHouseBot::ProcessPurgeJobs()
+{
+    if (_purgeJobs.empty())
+        return;
+
+    constexpr std::size_t idsPerStatement = 1000;
+    constexpr std::size_t auctionsPerClockCheck = 256;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    while (!_purgeJobs.empty())
+    {
+        AHBPurgeJob& job = _purgeJobs.front();
+        AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(GetConfig(job.houseId)->GetAuctionHouseFactionID());
+        std::string ids;
+        std::string guids;
+        std::vector<Item*> items;
+        std::size_t inStatement = 0;
+
+        // The auctions of a chunk and their items go in one transaction, no item row outlives its auction
+        auto writeIds = [&]()
+        {
+            if (ids.empty())
+                return;
+
+            auto trans = CharacterDatabase.BeginTransaction();
+            sAHStatements->Append(trans, AHB_CHAR_DEL_AUCTIONS, ids);
+            if (!guids.empty())
+                sAHStatements->Append(trans, AHB_CHAR_DEL_ITEM_INSTANCES, guids);
+            CharacterDatabase.CommitTransaction(trans);
+
+            sAHMetrics->Add(AHBCounter::DbStatements, job.houseId, guids.empty() ? 1 : 2);
+
+            for (Item* item : items)
+                delete item;
+
+            ids.clear();
+            guids.clear();
+            items.clear();
+            inStatement = 0;
+        };
+
+        bool outOfTime = false;
+
+        while (job.next < job.auctionIds.size())
+        {
+            const uint32 auctionId = job.auctionIds[job.next++];
+
+            // Sold or expired since the job was queued
+            AuctionEntry* auction = auctionHouse->GetAuction(auctionId);
+            if (auction && auction->owner.GetCounter() == AHBplayerGUID)
+            {
+                ItemTemplate const* prototype = sObjectMgr->GetItemTemplate(auction->item_template);
+
+                // Whoever bid gets the item or the money back through the core, those are left to run out
+                if (auction->bidder)
+                    ++job.withBids;
+                else if (prototype && (!job.quality || prototype->Quality == *job.quality))
+                {
+                    if (Item* item = sAuctionMgr->GetAItem(auction->item_guid))
+                    {
+                        sAuctionMgr->RemoveAItem(auction->item_guid);
+                        items.push_back(item);
+
+                        if (!guids.empty())
+                            guids += ',';
+                        guids += std::to_string(item->GetGUID().GetCounter());
+                    }
+
+                    if (!ids.empty())
+                        ids += ',';
+                    ids += std::to_string(auctionId);
+
+                    auctionHouse->RemoveAuction(auction); // Deletes the auction
+                    ++job.purged;
+
+                    if (++inStatement == idsPerStatement)
+                        writeIds();
+                }
+            }
+
+            if (job.next % auctionsPerClockCheck == 0 && std::chrono::steady_clock::now() - start >= MassOperationBudget)
+            {
+                outOfTime = true;
+                break;
+            }
+        }
+
+        writeIds();
+
+        if (outOfTime && job.next < job.auctionIds.size())
+        {
+            LOG_INFO("module.ahbot", "AHSeller: Purging auctions in house {}: {}/{}", job.houseId, job.next, job.auctionIds.size());
+            return;
+        }
+
+        LOG_INFO("module.ahbot", "AHSeller: Purged {} auctions in house {}, {} with bids left to run out", job.purged, job.houseId, job.withBids);
+        _purgeJobs.pop_front();
+
+        if (outOfTime)
+            return;
+    }
+}
+
+void AuctionHouseBot::InitializeConfiguration()
+{
+    AHBSeller = sConfigMgr->GetOption<bool>("AuctionHouseBot.EnableSeller", false);
+    AHBBuyer = sConfigMgr->GetOption<bool>("AuctionHouseBot.EnableBuyer", false);
+    SellMethod = sConfigMgr->GetOption<bool>("AuctionHouseBot.UseBuyPriceForSeller", false);
+    BuyMethod = sConfigMgr->GetOption<bool>("AuctionHouseBot.UseBuyPriceForBuyer", false);
+
+    AHBplayerAccount = sConfigMgr->GetOption<uint32>("AuctionHouseBot.Account", 0);
+    AHBplayerGUID = sConfigMgr->GetOption<uint32>("AuctionHouseBot.GUID", 0);
+    ItemsPerCycle = sConfigMgr->GetOption<uint32>("AuctionHouseBot.ItemsPerCycle", 200);
+    ItemsPerCycleMinShare = std::clamp(sConfigMgr->GetOption<uint32>("AuctionHouseBot.ItemsPerCycle.MinShare", 20), 0u, 100u) / 100.f;
+    LevelBracketWeighting = sConfigMgr->GetOption<bool>("AuctionHouseBot.LevelBrackets.PlayerWeighting", false);
+    LevelBracketBaseWeight = sConfigMgr->GetOption<float>("AuctionHouseBot.LevelBrackets.BaseWeight", 1.f);
+
+    MarketPrices = sConfigMgr->GetOption<bool>("AuctionHouseBot.MarketPrices.Enable", false);
+    MarketPricesForSeller = MarketPrices && sConfigMgr->GetOption<bool>("AuctionHouseBot.MarketPrices.UseForSeller", false);
+    MarketPricesForBuyer = MarketPrices && sConfigMgr->GetOption<bool>("AuctionHouseBot.MarketPrices.UseForBuyer", false);
+    MarketPricesMinSold = sConfigMgr->GetOption<uint32>("AuctionHouseBot.MarketPrices.MinSold", 5);
+    MarketPricesFlushInterval = Seconds(sConfigMgr->GetOption<uint32>("AuctionHouseBot.MarketPrices.FlushInterval", 300));
+    MassOperationBudget = Milliseconds(sConfigMgr->GetOption<uint32>("AuctionHouseBot.MassOperationBudget", 10));
+    DirectSettlement = sConfigMgr->GetOption<bool>("AuctionHouseBot.DirectSettlement", true);
+    Relist = sConfigMgr->GetOption<bool>("AuctionHouseBot.Relist.Enable", false);
+    RelistReprice = sConfigMgr->GetOption<bool>("AuctionHouseBot.Relist.Reprice", true);
+    RelistWindow = Seconds(std::max(sConfigMgr->GetOption<uint32>("AuctionHouseBot.Relist.Window", 120), 60u));
+    RefillDelay = Seconds(sConfigMgr->GetOption<uint32>("AuctionHouseBot.Refill.Delay", 60));
+    BuyerMaxPendingQueries = std::max(sConfigMgr->GetOption<uint32>("AuctionHouseBot.Buyer.MaxPendingQueries", 1), 1u);
+    ConsolidateTradeGoods = sConfigMgr->GetOption<bool>("AuctionHouseBot.TradeGoods.Consolidate", false);
+    ExpirySmoothing = sConfigMgr->GetOption<bool>("AuctionHouseBot.ExpirySmoothing.Enable", true);
+    ExpiryMaxOffset = std::min<Seconds>(Minutes(sConfigMgr->GetOption<uint32>("AuctionHouseBot.ExpirySmoothing.MaxOffset", 120)), AHB_EXPIRY_MAX_OFFSET);
+
+    for (auto& [houseId, expirySchedule] : _expirySchedules)
+        expirySchedule.Configure(ExpirySmoothing, ExpiryMaxOffset);
+    ConfigFlushDelay = Seconds(sConfigMgr->GetOption<uint32>("AuctionHouseBot.ConfigFlushDelay", 5));
+    _tickBudget.Configure(Milliseconds(sConfigMgr->GetOption<uint32>("AuctionHouseBot.TickBudget.Average", 20)),
+        Milliseconds(sConfigMgr->GetOption<uint32>("AuctionHouseBot.TickBudget.P99", 50)),
+        sConfigMgr->GetOption<uint32>("AuctionHouseBot.TickBudget.Window", 20));
+
+    sAHTrace->Configure(sConfigMgr->GetOption<std::string>("AuctionHouseBot.Trace.File", "ahbot_trace.json"),
+        uint64(sConfigMgr->GetOption<uint32>("AuctionHouseBot.Trace.MaxFileSize", 64)) * 1024 * 1024);
+    sAHTrace->SetEnabled(sConfigMgr->GetOption<bool>("AuctionHouseBot.Trace.Enable", false));
+    _priceBook.SetSmoothing(std::clamp(sConfigMgr->GetOption<float>("AuctionHouseBot.MarketPrices.Smoothing", 0.2f), 0.01f, 1.f));
+}
+
+void AuctionHouseBot::RecordAuctionSale(AuctionEntry* auction)
+{
+    if (!MarketPrices)
+        return;
+
+    // Our own purchases and listings are priced from our own valuation, with the seller's percentages on
+    // top of a market price they would feed it back to itself and inflate it with every round of sales
+    if (auction->bidder.GetCounter() == AHBplayerGUID || auction->owner.GetCounter() == AHBplayerGUID)
+        return;
+
+    _priceBook.RecordSale(auction->item_template, auction->bid, auction->itemCount, GameTime::GetGameTime().count());
+}
+
+void AuctionHouseBot::RecordAuctionRemoved(AuctionEntry* auction)
+{
+    if (!MarketPrices)
+        return;
+
+    // Sales are recorded by RecordAuctionSale(), cancelled auctions say nothing about the price. The bot's
+    // own auctions are left out like in RecordAuctionSale(), ahexpire and purge remove only those.
+    if (auction->owner.GetCounter() == AHBplayerGUID)
+        return;
+
+    const uint32 now = GameTime::GetGameTime().count();
+    if (!auction->bid && auction->expire_time <= now)
+        _priceBook.RecordExpired(auction->item_template, now);
+}
+
+void AuctionHouseBot::FlushMarketPrices(bool direct)
+{
+    if (MarketPrices)
+        _priceBook.Flush(direct);
+}
+
+bool AuctionHouseBot::SettleBotItem(AuctionEntry* auction)
+{
+    if (!DirectSettlement)
+        return false;
+
+    Item* item = sAuctionMgr->GetAItem(auction->item_guid);
+    if (!item)
+        return false;
 
-            auction->bidder = player->GetGUID();
-            auction->bid = bidprice;
+    // Out of the auction house's items, so whatever the core does with the auction after the hook cannot free it
+    sAuctionMgr->RemoveAItem(auction->item_guid);
+    _settledItems.push_back(item);
 
-            // Saving auction into database
-            CharacterDatabase.Execute("UPDATE auctionhouse SET buyguid = '{}', lastbid = '{}' WHERE id = '{}'", auction->bidder.GetCounter(), auction->bid, auction->Id);
-        }
-        else
-        {
-            auto trans = CharacterDatabase.BeginTransaction();
+    sAHMetrics->Add(AHBCounter::SettledItems, GetConfig(auction)->GetAuctionHouseID());
+    return true;
+}
 
-            // Buyout
-            if (auction->bidder && player->GetGUID() != auction->bidder)
-                sAuctionMgr->SendAuctionOutbiddedMail(auction, auction->buyout, player.get(), trans);
+bool AuctionHouseBot::RecordBotProceeds(AuctionEntry* auction, uint32 profit)
+{
+    if (!DirectSettlement)
+        return false;
 
-            auction->bidder = player->GetGUID();
-            auction->bid = auction->buyout;
+    // The bot's money is never spent, what it made is all the mail would have told
+    sAHMetrics->Add(AHBCounter::BotProceeds, GetConfig(auction)->GetAuctionHouseID(), profit);
+    return true;
+}
 
-            // Send mails to buyer & seller
-            //sAuctionMgr->SendAuctionSalePendingMail(auction, trans);
-            sAuctionMgr->SendAuctionSuccessfulMail(auction, trans);
-            sAuctionMgr->SendAuctionWonMail(auction, trans);
-            auction->DeleteFromDB(trans);
+void AuctionHouseBot::FlushSettlements(bool direct)
+{
+    if (_settledItems.empty())
+        return;
 
-            sAuctionMgr->RemoveAItem(auction->item_guid);
-            auctionHouse->RemoveAuction(auction);
-            CharacterDatabase.CommitTransaction(trans);
-        }
+    constexpr std::size_t itemsPerStatement = 1000;
+
+    std::string guids;
+    std::size_t inStatement = 0;
+
+    auto writeGuids = [&]()
+    {
+        if (guids.empty())
+            return;
+
+        sAHStatements->Execute(AHB_CHAR_DEL_ITEM_INSTANCES, direct, guids);
+        sAHMetrics->Add(AHBCounter::DbStatements, 0);
+        guids.clear();
+        inStatement = 0;
+    };
+
+    // Rows and objects of every settled item, instead of an item owner update, a mail and a delete each
+    for (Item* item : _settledItems)
+    {
+        if (!guids.empty())
+            guids += ',';
+        guids += std::to_string(item->GetGUID().GetCounter());
+        delete item;
+
+        if (++inStatement == itemsPerStatement)
+            writeGuids();
     }
+
+    writeGuids();
+    _settledItems.clear();
 }
 
-void AuctionHouseBot::Update()
+void AuctionHouseBot::UpdateConfigStore(uint32 diff)
 {
-    if (!AHBSeller && !AHBBuyer)
+    if (!_configStore.HasChanges())
         return;
 
-    if (!AHBplayerAccount || !AHBplayerGUID)
-    {
-        LOG_ERROR("module.ahbot", "{}: Invalid player data. Account {}. Guid {}", __FUNCTION__, AHBplayerAccount, AHBplayerGUID);
+    // Counts from the first change, so a burst of commands ends up in one UPDATE per house
+    _configFlushTimer += Milliseconds(diff);
+
+    if (_configFlushTimer >= ConfigFlushDelay)
+        FlushConfig();
+}
+
+void AuctionHouseBot::FlushConfig(bool direct)
+{
+    _configFlushTimer = 0ms;
+
+    if (!_configStore.HasChanges())
         return;
-    }
 
-    std::string accountName = "AuctionHouseBot_" + std::to_string(AHBplayerAccount);
+    for (AHBConfig* config : { &AllianceConfig, &HordeConfig, &NeutralConfig })
+        _configStore.Flush(*config, direct);
+}
 
-    auto session = std::make_shared<WorldSession>(AHBplayerAccount, std::move(accountName), nullptr, SEC_PLAYER, sWorld->getIntConfig(CONFIG_EXPANSION), 0, LOCALE_enUS, 0, false, true, 0);
+std::vector<std::string> AuctionHouseBot::FormatStats(uint32 houseId) const
+{
+    const AHBMetricsSnapshot snapshot = sAHMetrics->Read();
+    std::vector<std::string> lines;
 
-    std::shared_ptr<Player> playerBot(new Player(session.get()), [](Player* ptr)
+    auto formatTimer = [&](uint32 slot, AHBTimer timer)
     {
-        ObjectAccessor::RemoveObject(ptr);
-        delete ptr;
-    });
+        AHBMetricsSnapshot::Timer const& stats = snapshot.timers[slot][uint32(timer)];
+        if (!stats.count)
+            return;
 
-    playerBot->Initialize(AHBplayerGUID);
+        lines.push_back(Acore::StringFormatFmt("  {}: {} times, avg {} us, p50 <= {} us, p99 <= {} us, max <= {} us", AHBMetrics::GetTimerName(timer),
+            stats.count, stats.totalMicroseconds / stats.count, stats.Percentile(0.5f), stats.Percentile(0.99f), stats.Percentile(1.f)));
+    };
 
-    ObjectAccessor::AddObject(playerBot.get());
+    auto formatCounters = [&](uint32 slot)
+    {
+        std::string counters;
+        for (uint32 counter = 0; counter < uint32(AHBCounter::Max); ++counter)
+            counters += Acore::StringFormatFmt("{}{}: {}", counters.empty() ? "  " : ", ", AHBMetrics::GetCounterName(AHBCounter(counter)), snapshot.counters[slot][counter]);
 
-    Seconds newUpdate = GameTime::GetGameTime();
+        lines.push_back(counters);
+    };
 
-    // Add New Bids
-    if (!sWorld->getBoolConfig(CONFIG_ALLOW_TWO_SIDE_INTERACTION_AUCTION))
+    uint32 indexedItems = 0;
+    for (uint32 i = 0; i < AHB_MAX_QUALITY; ++i)
+        indexedItems += sAHIndex->GetItemBin(i).size();
+
+    lines.push_back(Acore::StringFormatFmt("AuctionHouseBot: {} items indexed, {} market prices, {} buyer queries pending, oldest {} ms",
+        indexedItems, _priceBook.Size(), snapshot.gauges[uint32(AHBGauge::PendingBuyerQueries)], snapshot.gauges[uint32(AHBGauge::OldestBuyerQueryMs)]));
+
+    lines.push_back(Acore::StringFormatFmt("Tick budget: update avg {} us, p99 {} us, degradation: {}",
+        _tickBudget.GetAverage().count(), _tickBudget.GetP99().count(), AHBTickBudget::GetLevelName(_tickBudget.GetLevel())));
+
+    const uint32 globalSlot = AHBMetrics::GetHouseSlot(0);
+    formatCounters(globalSlot);
+    formatTimer(globalSlot, AHBTimer::Update);
+    formatTimer(globalSlot, AHBTimer::UpdateMaintenance);
+
+    for (uint32 house : { AUCTIONHOUSE_ALLIANCE, AUCTIONHOUSE_HORDE, AUCTIONHOUSE_NEUTRAL })
     {
-        AddNewAuctions(playerBot.get(), &AllianceConfig);
-        if ((newUpdate - _lastUpdateAlliance >= AllianceConfig.GetBiddingInterval()) && AllianceConfig.GetBidsPerInterval() > 0)
+        if (houseId && houseId != house)
+            continue;
+
+        const auto tracked = _botAuctions.find(house);
+        lines.push_back(Acore::StringFormatFmt("Auctionhouse {}: {} bot auctions", house, tracked != _botAuctions.end() ? tracked->second.size() : 0));
+
+        for (AHBFillJob const& job : _fillJobs)
+            if (job.houseId == house)
+                lines.push_back("  fill: " + FormatFillProgress(job));
+
+        const auto refill = _refills.find(house);
+        if (refill != _refills.end())
         {
-            LOG_DEBUG("module.ahbot", "AHBuyer: {} seconds have passed since last bid", newUpdate.count() - _lastUpdateAlliance.count());
-            LOG_DEBUG("module.ahbot", "AHBuyer: Bidding on Alliance Auctions");
-            AddNewAuctionBuyerBotBid(playerBot, session, &AllianceConfig);
-            _lastUpdateAlliance = newUpdate;
+            const int64 dueIn = (refill->second.due - GameTime::GetGameTime()).count();
+            lines.push_back(Acore::StringFormatFmt("  refill: {}, {} auctions removed since the last one, {} bins to refill",
+                !refill->second.pending ? "idle" : dueIn > 0 ? Acore::StringFormatFmt("due in {}s", dueIn) : "due", refill->second.removed, refill->second.bins.count()));
         }
 
-        AddNewAuctions(playerBot.get(), &HordeConfig);
-        if ((newUpdate - _lastUpdateHorde >= HordeConfig.GetBiddingInterval()) && HordeConfig.GetBidsPerInterval() > 0)
+        // What consolidating trade goods saves: the listings of uniform stacks the same supply would have taken
+        const auto tradeGoods = _botTradeGoods.find(house);
+        const auto weights = _listingWeights.find(house);
+        if (ConsolidateTradeGoods && tradeGoods != _botTradeGoods.end() && !tradeGoods->second.empty())
         {
-            LOG_DEBUG("module.ahbot", "AHBuyer: {} seconds have passed since last bid", newUpdate.count() - _lastUpdateHorde.count());
-            LOG_DEBUG("module.ahbot", "AHBuyer: Bidding on Horde Auctions");
-            AddNewAuctionBuyerBotBid(playerBot, session, &HordeConfig);
-            _lastUpdateHorde = newUpdate;
+            const std::size_t auctions = tradeGoods->second.size();
+            std::size_t listings = auctions;
+            if (weights != _listingWeights.end())
+                for (auto const& [auctionId, weight] : weights->second)
+                    listings += weight - 1;
+
+            lines.push_back(Acore::StringFormatFmt("  trade goods: {} auctions hold the supply of {} listings, {} fewer auctions ({}%)",
+                auctions, listings, listings - auctions, (listings - auctions) * 100 / listings));
         }
-    }
-
-    AddNewAuctions(playerBot.get(), &NeutralConfig);
-    if ((newUpdate - _lastUpdateNeutral >= NeutralConfig.GetBiddingInterval()) && NeutralConfig.GetBidsPerInterval() > 0)
-    {
-        LOG_DEBUG("module.ahbot", "AHBuyer: {} seconds have passed since last bid", newUpdate.count() - _lastUpdateNeutral.count());
-        LOG_DEBUG("module.ahbot", "AHBuyer: Bidding on Neutral Auctions");
-        AddNewAuctionBuyerBotBid(playerBot, session, &NeutralConfig);
-        _lastUpdateNeutral = newUpdate;
-    }
 
-    ProcessQueryCallbacks();
-}
+        // Upcoming expiries of the bot's auctions, the seller spreads them to keep these flat
+        const auto expirySchedule = _expirySchedules.find(house);
+        if (expirySchedule != _expirySchedules.end())
+        {
+            std::string histogram;
+            for (uint32 count : expirySchedule->second.GetHistogram(GameTime::GetGameTime().count(), 4h))
+                histogram += Acore::StringFormatFmt("{}{}", histogram.empty() ? "" : " ", count);
 
-void AuctionHouseBot::Initialize()
-{
-    sAHIndex->Initialize();
+            lines.push_back("  expiries per 4h: " + histogram);
+        }
 
-    if (AHBSeller)
-        if (!sAHIndex->InitializeItemsToSell())
-            AHBSeller = false;
+        const uint32 slot = AHBMetrics::GetHouseSlot(house);
+        formatCounters(slot);
+        formatTimer(slot, AHBTimer::Seller);
+        formatTimer(slot, AHBTimer::BuyerCallback);
+    }
 
-    if (!sWorld->getBoolConfig(CONFIG_ALLOW_TWO_SIDE_INTERACTION_AUCTION))
+    // Queries are timed until their result arrived, writes only counted, they run on the database's own threads
+    lines.push_back("Statements, most expensive first:");
+    for (AHBStatementStats const& statement : sAHStatements->GetStats())
     {
-        LoadValues(&AllianceConfig);
-        LoadValues(&HordeConfig);
+        if (statement.timed)
+            lines.push_back(Acore::StringFormatFmt("  {}: {} times, avg {} us, max {} us, total {} ms", AHBStatements::GetName(statement.id),
+                statement.count, statement.totalMicroseconds / statement.timed, statement.maxMicroseconds, statement.totalMicroseconds / 1000));
+        else
+            lines.push_back(Acore::StringFormatFmt("  {}: {} times", AHBStatements::GetName(statement.id), statement.count));
     }
 
-    LoadValues(&NeutralConfig);
-
-    //
-    // check if the AHBot account/GUID in the config actually exists
-    //
+    return lines;
+}
 
-    if (AHBplayerAccount || AHBplayerGUID)
-    {
-        QueryResult result = CharacterDatabase.Query("SELECT 1 FROM characters WHERE account = {} AND guid = {}", AHBplayerAccount, AHBplayerGUID);
-        if (!result)
-        {
-            LOG_ERROR("module", "AuctionHouseBot: The account/GUID-information set for your AHBot is incorrect (account: {} guid: {})", AHBplayerAccount, AHBplayerGUID);
-            return;
-        }
-    }
+void AuctionHouseBot::UpdatePlayerLevel(uint32 oldLevel, uint32 newLevel)
+{
+    if (oldLevel)
+        _onlinePlayersPerBracket[GetAHBLevelBracket(oldLevel)].fetch_sub(1, std::memory_order_relaxed);
 
-    LOG_INFO("module", "AuctionHouseBot has been loaded.");
+    if (newLevel)
+        _onlinePlayersPerBracket[GetAHBLevelBracket(newLevel)].fetch_add(1, std::memory_order_relaxed);
 }
 
-void AuctionHouseBot::InitializeConfiguration()
+std::array<uint32, AHB_LEVEL_BRACKETS> AuctionHouseBot::GetOnlinePlayersPerBracket() const
 {
-    AHBSeller = sConfigMgr->GetOption<bool>("AuctionHouseBot.EnableSeller", false);
-    AHBBuyer = sConfigMgr->GetOption<bool>("AuctionHouseBot.EnableBuyer", false);
-    SellMethod = sConfigMgr->GetOption<bool>("AuctionHouseBot.UseBuyPriceForSeller", false);
-    BuyMethod = sConfigMgr->GetOption<bool>("AuctionHouseBot.UseBuyPriceForBuyer", false);
+    std::array<uint32, AHB_LEVEL_BRACKETS> players{};
 
-    AHBplayerAccount = sConfigMgr->GetOption<uint32>("AuctionHouseBot.Account", 0);
-    AHBplayerGUID = sConfigMgr->GetOption<uint32>("AuctionHouseBot.GUID", 0);
-    ItemsPerCycle = sConfigMgr->GetOption<uint32>("AuctionHouseBot.ItemsPerCycle", 200);
+    for (uint32 bracket = 0; bracket < AHB_LEVEL_BRACKETS; ++bracket)
+        players[bracket] = _onlinePlayersPerBracket[bracket].load(std::memory_order_relaxed);
+
+    return players;
 }
 
 void AuctionHouseBot::IncrementItemCounts(AuctionEntry* ah)
@@ -600,31 +2101,13 @@ void AuctionHouseBot::IncrementItemCounts(AuctionEntry* ah)
     // get item prototype
     ItemTemplate const* prototype = sObjectMgr->GetItemTemplate(ah->item_template);
 
-    AHBConfig* config = nullptr;
+    AHBConfig* config = GetConfig(ah);
 
-    AuctionHouseEntry const* ahEntry = sAuctionHouseStore.LookupEntry(ah->GetHouseId());
-    if (!ahEntry)
-    {
-        LOG_DEBUG("module.ahbot", "AHBot: {} returned as House Faction. Neutral", ah->GetHouseId());
-        config = &NeutralConfig;
-    }
-    else if (ahEntry->houseId == AUCTIONHOUSE_ALLIANCE)
-    {
-        //LOG_DEBUG("module.ahbot", "AHBot: {} returned as House Faction. Alliance", ah->GetHouseId());
-        config = &AllianceConfig;
-    }
-    else if (ahEntry->houseId == AUCTIONHOUSE_HORDE)
-    {
-        //LOG_DEBUG("module.ahbot", "AHBot: {} returned as House Faction. Horde", ah->GetHouseId());
-        config = &HordeConfig;
-    }
-    else
-    {
-        //LOG_DEBUG("module.ahbot", "AHBot: {} returned as House Faction. Neutral", ah->GetHouseId());
-        config = &NeutralConfig;
-    }
+    // A consolidated stack of trade goods counts as the listings it holds the supply of
+    for (uint32 weight = TrackListingWeight(config, ah, prototype, true); weight; --weight)
+        config->IncreaseItemCounts(prototype->Class, prototype->Quality);
 
-    config->IncreaseItemCounts(prototype->Class, prototype->Quality);
+    TrackBotAuction(config, ah, prototype, true);
 }
 
 void AuctionHouseBot::DecrementItemCounts(AuctionEntry* ah, uint32 itemEntry)
@@ -632,31 +2115,31 @@ void AuctionHouseBot::DecrementItemCounts(AuctionEntry* ah, uint32 itemEntry)
     // get item prototype
     ItemTemplate const* prototype = sObjectMgr->GetItemTemplate(itemEntry);
 
-    AHBConfig* config = nullptr;
+    AHBConfig* config = GetConfig(ah);
 
-    AuctionHouseEntry const* ahEntry = sAuctionHouseStore.LookupEntry(ah->GetHouseId());
-    if (!ahEntry)
-    {
-        LOG_DEBUG("module.ahbot", "AHBot: {} returned as House Faction. Neutral", ah->GetHouseId());
-        config = &NeutralConfig;
-    }
-    else if (ahEntry->houseId == AUCTIONHOUSE_ALLIANCE)
-    {
-        //LOG_DEBUG("module.ahbot", "AHBot: {} returned as House Faction. Alliance", ah->GetHouseId());
-        config = &AllianceConfig;
-    }
-    else if (ahEntry->houseId == AUCTIONHOUSE_HORDE)
-    {
-        //LOG_DEBUG("module.ahbot", "AHBot: {} returned as House Faction. Horde", ah->GetHouseId());
-        config = &HordeConfig;
-    }
-    else
+    for (uint32 weight = TrackListingWeight(config, ah, prototype, false); weight; --weight)
+        config->DecreaseItemCounts(prototype->Class, prototype->Quality);
+
+    TrackBotAuction(config, ah, prototype, false);
+
+    // The bin it was counted in is refilled, once the house is below its minimum and removals that come
+    // together (an expiry wave, the buyer's buyouts) had RefillDelay to add up
+    AHBRefill& refill = _refills[config->GetAuctionHouseID()];
+    const uint32 bin = prototype->Class == ITEM_CLASS_TRADE_GOODS ? prototype->Quality : prototype->Quality + AHB_MAX_DEFAULT_QUALITY + 1;
+    if (bin < AHB_MAX_QUALITY)
+        refill.bins.set(bin);
+
+    ++refill.removed;
+
+    if (!refill.pending)
     {
-        //LOG_DEBUG("module.ahbot", "AHBot: {} returned as House Faction. Neutral", ah->GetHouseId());
-        config = &NeutralConfig;
+        AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(config->GetAuctionHouseFactionID());
+        if (auctionHouse && auctionHouse->Getcount() < config->GetMinItems())
+        {
+            refill.pending = true;
+            refill.due = GameTime::GetGameTime() + RefillDelay;
+        }
     }
-
-    config->DecreaseItemCounts(prototype->Class, prototype->Quality);
 }
 
 void AuctionHouseBot::Commands(AHBotCommand command, uint32 ahMapID, uint32 col, char* args)
@@ -675,90 +2158,34 @@ void AuctionHouseBot::Commands(AHBotCommand command, uint32 ahMapID, uint32 col,
         break;
     }
 
-    std::string color;
-    switch (col)
+    // Per quality settings are one column per color, starting at column
+    auto setQualityColumn = [&](uint32 column, char* args)
     {
-    case ITEM_QUALITY_POOR:
-        color = "grey";
-        break;
-    case ITEM_QUALITY_NORMAL:
-        color = "white";
-        break;
-    case ITEM_QUALITY_UNCOMMON:
-        color = "green";
-        break;
-    case ITEM_QUALITY_RARE:
-        color = "blue";
-        break;
-    case ITEM_QUALITY_EPIC:
-        color = "purple";
-        break;
-    case ITEM_QUALITY_LEGENDARY:
-        color = "orange";
-        break;
-    case ITEM_QUALITY_ARTIFACT:
-        color = "yellow";
-        break;
-    default:
-        break;
-    }
+        if (col >= AHB_DEFAULT_QUALITY_SIZE)
+            return;
+
+        char * param1 = strtok(args, " ");
+        _configStore.Set(*config, column + col, (uint32) strtoul(param1, NULL, 0));
+    };
 
     switch (command)
     {
     case AHBotCommand::ahexpire:
-        {
-            AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(config->GetAuctionHouseFactionID());
-
-            for (auto const& [__, auction] : auctionHouse->GetAuctions())
-            {
-                if (auction->owner.GetCounter() == AHBplayerGUID)
-                {
-                    auction->expire_time = GameTime::GetGameTime().count();
-                    uint32 id = auction->Id;
-                    uint32 expire_time = auction->expire_time;
-                    CharacterDatabase.Execute("UPDATE auctionhouse SET time = '{}' WHERE id = '{}'", expire_time, id);
-                }
-            }
-        }
+        QueueExpireJob(ahMapID, std::nullopt);
         break;
     case AHBotCommand::ahexpireclass:
-    {
-        uint32 itemClass = (uint32)strtoul(args, NULL, 0);
-        AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(config->GetAuctionHouseFactionID());
-        uint32 expiredItemsCount = 0;
-
-        for (auto const& [__, auction] : auctionHouse->GetAuctions())
-        {
-            if (auction->owner.GetCounter() == AHBplayerGUID)
-            {
-                ItemTemplate const* prototype = sObjectMgr->GetItemTemplate(auction->item_template);
-                if (!prototype || prototype->Class != itemClass)
-                    continue;
-
-                auction->expire_time = GameTime::GetGameTime().count();
-                uint32 id = auction->Id;
-                uint32 expire_time = auction->expire_time;
-                CharacterDatabase.Execute("UPDATE auctionhouse SET time = '{}' WHERE id = '{}'", expire_time, id);
-                ++expiredItemsCount;
-            }
-        }
-        LOG_INFO("module.ahbot", "AHSeller: Manually expired {} Auctions", expiredItemsCount);
-    }
-    break;
+        QueueExpireJob(ahMapID, (uint32)strtoul(args, NULL, 0));
+        break;
     case AHBotCommand::minitems:
         {
             char * param1 = strtok(args, " ");
-            uint32 minItems = (uint32) strtoul(param1, NULL, 0);
-            WorldDatabase.Execute("UPDATE mod_auctionhousebot SET minitems = '{}' WHERE auctionhouse = '{}'", minItems, ahMapID);
-            config->SetMinItems(minItems);
+            _configStore.Set(*config, AHB_CONFIG_MIN_ITEMS, (uint32) strtoul(param1, NULL, 0));
         }
         break;
     case AHBotCommand::maxitems:
         {
             char * param1 = strtok(args, " ");
-            uint32 maxItems = (uint32) strtoul(param1, NULL, 0);
-			WorldDatabase.Execute("UPDATE mod_auctionhousebot SET maxitems = '{}' WHERE auctionhouse = '{}'", maxItems, ahMapID);
-            config->SetMaxItems(maxItems);
+            _configStore.Set(*config, AHB_CONFIG_MAX_ITEMS, (uint32) strtoul(param1, NULL, 0));
             config->CalculateMaxCounts();
         }
         break;
@@ -798,319 +2225,144 @@ void AuctionHouseBot::Commands(AHBotCommand command, uint32 ahMapID, uint32 col,
                 greytg, whitetg, greentg, bluetg, purpletg, orangetg, yellowtg, greyi, whitei, greeni, bluei, purplei, orangei, yellowi
             };
 
-			auto trans = WorldDatabase.BeginTransaction();
-            trans->Append("UPDATE mod_auctionhousebot SET percentgreytradegoods = '{}' WHERE auctionhouse = '{}'", greytg, ahMapID);
-            trans->Append("UPDATE mod_auctionhousebot SET percentwhitetradegoods = '{}' WHERE auctionhouse = '{}'", whitetg, ahMapID);
-            trans->Append("UPDATE mod_auctionhousebot SET percentgreentradegoods = '{}' WHERE auctionhouse = '{}'", greentg, ahMapID);
-            trans->Append("UPDATE mod_auctionhousebot SET percentbluetradegoods = '{}' WHERE auctionhouse = '{}'", bluetg, ahMapID);
-            trans->Append("UPDATE mod_auctionhousebot SET percentpurpletradegoods = '{}' WHERE auctionhouse = '{}'", purpletg, ahMapID);
-            trans->Append("UPDATE mod_auctionhousebot SET percentorangetradegoods = '{}' WHERE auctionhouse = '{}'", orangetg, ahMapID);
-            trans->Append("UPDATE mod_auctionhousebot SET percentyellowtradegoods = '{}' WHERE auctionhouse = '{}'", yellowtg, ahMapID);
-            trans->Append("UPDATE mod_auctionhousebot SET percentgreyitems = '{}' WHERE auctionhouse = '{}'", greyi, ahMapID);
-            trans->Append("UPDATE mod_auctionhousebot SET percentwhiteitems = '{}' WHERE auctionhouse = '{}'", whitei, ahMapID);
-            trans->Append("UPDATE mod_auctionhousebot SET percentgreenitems = '{}' WHERE auctionhouse = '{}'", greeni, ahMapID);
-            trans->Append("UPDATE mod_auctionhousebot SET percentblueitems = '{}' WHERE auctionhouse = '{}'", bluei, ahMapID);
-            trans->Append("UPDATE mod_auctionhousebot SET percentpurpleitems = '{}' WHERE auctionhouse = '{}'", purplei, ahMapID);
-            trans->Append("UPDATE mod_auctionhousebot SET percentorangeitems = '{}' WHERE auctionhouse = '{}'", orangei, ahMapID);
-            trans->Append("UPDATE mod_auctionhousebot SET percentyellowitems = '{}' WHERE auctionhouse = '{}'", yellowi, ahMapID);
-			WorldDatabase.CommitTransaction(trans);
+            // Normalized first, so the stored percentages are the ones in use
             config->SetPercentages(percentages);
+
+            for (uint32 i = 0; i < AHB_MAX_QUALITY; ++i)
+                _configStore.MarkDirty(ahMapID, AHB_CONFIG_PERCENT + i);
         }
         break;
     case AHBotCommand::minprice:
-        {
-            char * param1 = strtok(args, " ");
-            uint32 minPrice = (uint32) strtoul(param1, NULL, 0);
-			WorldDatabase.Execute("UPDATE mod_auctionhousebot SET minprice{} = '{}' WHERE auctionhouse = '{}'", color, minPrice, ahMapID);
-            config->SetMinPrice(col, minPrice);
-        }
+        setQualityColumn(AHB_CONFIG_MIN_PRICE, args);
         break;
     case AHBotCommand::maxprice:
-        {
-            char * param1 = strtok(args, " ");
-            uint32 maxPrice = (uint32) strtoul(param1, NULL, 0);
-			WorldDatabase.Execute("UPDATE mod_auctionhousebot SET maxprice{} = '{}' WHERE auctionhouse = '{}'", color, maxPrice, ahMapID);
-            config->SetMaxPrice(col, maxPrice);
-        }
+        setQualityColumn(AHB_CONFIG_MAX_PRICE, args);
         break;
     case AHBotCommand::minbidprice:
-        {
-            char * param1 = strtok(args, " ");
-            uint32 minBidPrice = (uint32) strtoul(param1, NULL, 0);
-			WorldDatabase.Execute("UPDATE mod_auctionhousebot SET minbidprice{} = '{}' WHERE auctionhouse = '{}'", color, minBidPrice, ahMapID);
-            config->SetMinBidPrice(col, minBidPrice);
-        }
+        setQualityColumn(AHB_CONFIG_MIN_BID_PRICE, args);
         break;
     case AHBotCommand::maxbidprice:
-        {
-            char * param1 = strtok(args, " ");
-            uint32 maxBidPrice = (uint32) strtoul(param1, NULL, 0);
-			WorldDatabase.Execute("UPDATE mod_auctionhousebot SET maxbidprice{} = '{}' WHERE auctionhouse = '{}'", color, maxBidPrice, ahMapID);
-            config->SetMaxBidPrice(col, maxBidPrice);
-        }
+        setQualityColumn(AHB_CONFIG_MAX_BID_PRICE, args);
         break;
     case AHBotCommand::maxstack:
-        {
-            char * param1 = strtok(args, " ");
-            uint32 maxStack = (uint32) strtoul(param1, NULL, 0);
-			WorldDatabase.Execute("UPDATE mod_auctionhousebot SET maxstack{} = '{}' WHERE auctionhouse = '{}'", color, maxStack, ahMapID);
-            config->SetMaxStack(col, maxStack);
-        }
+        setQualityColumn(AHB_CONFIG_MAX_STACK, args);
         break;
     case AHBotCommand::buyerprice:
-        {
-            char * param1 = strtok(args, " ");
-            uint32 buyerPrice = (uint32) strtoul(param1, NULL, 0);
-			WorldDatabase.Execute("UPDATE mod_auctionhousebot SET buyerprice{} = '{}' WHERE auctionhouse = '{}'", color, buyerPrice, ahMapID);
-            config->SetBuyerPrice(col, buyerPrice);
-        }
+        setQualityColumn(AHB_CONFIG_BUYER_PRICE, args);
         break;
     case AHBotCommand::bidinterval:
         {
             char * param1 = strtok(args, " ");
-            uint32 bidInterval = (uint32) strtoul(param1, NULL, 0);
-			WorldDatabase.Execute("UPDATE mod_auctionhousebot SET buyerbiddinginterval = '{}' WHERE auctionhouse = '{}'", bidInterval, ahMapID);
-            config->SetBiddingInterval(Minutes(bidInterval));
+            _configStore.Set(*config, AHB_CONFIG_BID_INTERVAL, (uint32) strtoul(param1, NULL, 0));
         }
         break;
     case AHBotCommand::bidsperinterval:
         {
             char * param1 = strtok(args, " ");
-            uint32 bidsPerInterval = (uint32) strtoul(param1, NULL, 0);
-			WorldDatabase.Execute("UPDATE mod_auctionhousebot SET buyerbidsperinterval = '{}' WHERE auctionhouse = '{}'", bidsPerInterval, ahMapID);
-            config->SetBidsPerInterval(bidsPerInterval);
+            _configStore.Set(*config, AHB_CONFIG_BIDS_PER_INTERVAL, (uint32) strtoul(param1, NULL, 0));
         }
         break;
     default:
         break;
     }
+
+    // Other limits can leave bins that are not full without any auction removed from them
+    if (config && (command == AHBotCommand::minitems || command == AHBotCommand::maxitems || command == AHBotCommand::percentages))
+        RequestRefill(config);
 }
 
 void AuctionHouseBot::LoadValues(AHBConfig* config)
 {
-    LOG_DEBUG("module.ahbot", "Start Settings for Auctionhouses");
+    AHB_PROFILE_SCOPE("LoadValues");
+
+    if (!LoadSettings(config))
+        return;
 
     if (AHBSeller)
+        CountItems(config);
+}
+
+bool AuctionHouseBot::LoadSettings(AHBConfig* config)
+{
+    LOG_DEBUG("module.ahbot", "Start Settings for Auctionhouse {}", config->GetAuctionHouseID());
+
+    if (!AHBConfigStore::Load(*config))
     {
-        std::string selectColumns = "minitems, maxitems,"; // min/max
-        selectColumns.append("percentgreytradegoods, percentwhitetradegoods, percentgreentradegoods, percentbluetradegoods, percentpurpletradegoods, percentorangetradegoods, percentyellowtradegoods,"); // tg items
-        selectColumns.append("percentgreyitems, percentwhiteitems, percentgreenitems, percentblueitems, percentpurpleitems, percentorangeitems, percentyellowitems,"); // default items
-        selectColumns.append("minpricegrey, minpricewhite, minpricegreen, minpriceblue, minpricepurple, minpriceorange, minpriceyellow,"); // min price
-        selectColumns.append("maxpricegrey, maxpricewhite, maxpricegreen, maxpriceblue, maxpricepurple, maxpriceorange, maxpriceyellow,"); // max price
-        selectColumns.append("minbidpricegrey, minbidpricewhite, minbidpricegreen, minbidpriceblue, minbidpricepurple, minbidpriceorange, minbidpriceyellow,"); // min bid prices
-        selectColumns.append("maxbidpricegrey, maxbidpricewhite, maxbidpricegreen, maxbidpriceblue, maxbidpricepurple, maxbidpriceorange, maxbidpriceyellow,"); // max bid prices
-        selectColumns.append("maxstackgrey, maxstackwhite, maxstackgreen, maxstackblue, maxstackpurple, maxstackorange, maxstackyellow,"); // max bid prices
-        selectColumns.append("name"); // auction name
-
-        auto result = WorldDatabase.Query("SELECT {} FROM mod_auctionhousebot WHERE auctionhouse = {}", selectColumns, config->GetAuctionHouseID());
-        if (!result)
-        {
-            LOG_ERROR("module.ahbot", "> Empty or invalid sql query for Auctionhouse: {}", config->GetAuctionHouseID());
-            return;
-        }
+        LOG_ERROR("module.ahbot", "> Empty or invalid sql query for Auctionhouse: {}", config->GetAuctionHouseID());
+        return false;
+    }
 
-        auto const& [minitems, maxitems,
-            percentgreytradegoods, percentwhitetradegoods, percentgreentradegoods, percentbluetradegoods, percentpurpletradegoods, percentorangetradegoods, percentyellowtradegoods,
-            percentgreyitems, percentwhiteitems, percentgreenitems, percentblueitems, percentpurpleitems, percentorangeitems, percentyellowitems,
-            minpricegrey, minpricewhite, minpricegreen, minpriceblue, minpricepurple, minpriceorange, minpriceyellow,
-            maxpricegrey, maxpricewhite, maxpricegreen, maxpriceblue, maxpricepurple, maxpriceorange, maxpriceyellow,
-            minbidpricegrey, minbidpricewhite, minbidpricegreen, minbidpriceblue, minbidpricepurple, minbidpriceorange, minbidpriceyellow,
-            maxbidpricegrey, maxbidpricewhite, maxbidpricegreen, maxbidpriceblue, maxbidpricepurple, maxbidpriceorange, maxbidpriceyellow,
-            maxstackgrey, maxstackwhite, maxstackgreen, maxstackblue, maxstackpurple, maxstackorange, maxstackyellow,
-            auctionName]
-            = result->FetchTuple<uint32, uint32,
-            float, float, float, float, float, float, float,
-            float, float, float, float, float, float, float,
-            uint32, uint32, uint32, uint32, uint32, uint32, uint32,
-            uint32, uint32, uint32, uint32, uint32, uint32, uint32,
-            uint32, uint32, uint32, uint32, uint32, uint32, uint32,
-            uint32, uint32, uint32, uint32, uint32, uint32, uint32,
-            uint32, uint32, uint32, uint32, uint32, uint32, uint32,
-            std::string_view>();
-
-        // Load min and max items
-		config->SetMinItems(minitems);
-		config->SetMaxItems(maxitems);
-
-        std::array<float, AHB_MAX_QUALITY> percentages = { percentgreytradegoods, percentwhitetradegoods, percentgreentradegoods, percentbluetradegoods, percentpurpletradegoods, percentorangetradegoods, percentyellowtradegoods,
-            percentgreyitems, percentwhiteitems, percentgreenitems, percentblueitems, percentpurpleitems, percentorangeitems, percentyellowitems };
-
-        config->SetPercentages(percentages);
-
-        // Load min and max prices
-		config->SetMinPrice(ITEM_QUALITY_POOR, minpricegrey);
-		config->SetMaxPrice(ITEM_QUALITY_POOR, maxpricegrey);
-        config->SetMinPrice(ITEM_QUALITY_NORMAL, minpricewhite);
-		config->SetMaxPrice(ITEM_QUALITY_NORMAL, maxpricewhite);
-		config->SetMinPrice(ITEM_QUALITY_UNCOMMON, minpricegreen);
-		config->SetMaxPrice(ITEM_QUALITY_UNCOMMON, maxpricegreen);
-		config->SetMinPrice(ITEM_QUALITY_RARE, minpriceblue);
-		config->SetMaxPrice(ITEM_QUALITY_RARE, maxpriceblue);
-		config->SetMinPrice(ITEM_QUALITY_EPIC, minpricepurple);
-		config->SetMaxPrice(ITEM_QUALITY_EPIC, maxpricepurple);
-		config->SetMinPrice(ITEM_QUALITY_LEGENDARY, minpriceorange);
-		config->SetMaxPrice(ITEM_QUALITY_LEGENDARY, maxpriceorange);
-		config->SetMinPrice(ITEM_QUALITY_ARTIFACT, minpriceyellow);
-		config->SetMaxPrice(ITEM_QUALITY_ARTIFACT, maxpriceyellow);
-
-        // Load min and max bid prices
-		config->SetMinBidPrice(ITEM_QUALITY_POOR, minbidpricegrey);
-		config->SetMaxBidPrice(ITEM_QUALITY_POOR, maxbidpricegrey);
-		config->SetMinBidPrice(ITEM_QUALITY_NORMAL, minbidpricewhite);
-		config->SetMaxBidPrice(ITEM_QUALITY_NORMAL, maxbidpricewhite);
-		config->SetMinBidPrice(ITEM_QUALITY_UNCOMMON, minbidpricegreen);
-		config->SetMaxBidPrice(ITEM_QUALITY_UNCOMMON, maxbidpricegreen);
-		config->SetMinBidPrice(ITEM_QUALITY_RARE, minbidpriceblue);
-		config->SetMaxBidPrice(ITEM_QUALITY_RARE, maxbidpriceblue);
-		config->SetMinBidPrice(ITEM_QUALITY_EPIC, minbidpricepurple);
-		config->SetMaxBidPrice(ITEM_QUALITY_EPIC, maxbidpricepurple);
-		config->SetMinBidPrice(ITEM_QUALITY_LEGENDARY, minbidpriceorange);
-		config->SetMaxBidPrice(ITEM_QUALITY_LEGENDARY, maxbidpriceorange);
-		config->SetMinBidPrice(ITEM_QUALITY_ARTIFACT, minbidpriceyellow);
-		config->SetMaxBidPrice(ITEM_QUALITY_ARTIFACT, maxbidpriceyellow);
-
-        // Load max stacks
-		config->SetMaxStack(ITEM_QUALITY_POOR, maxstackgrey);
-		config->SetMaxStack(ITEM_QUALITY_NORMAL, maxstackwhite);
-		config->SetMaxStack(ITEM_QUALITY_UNCOMMON, maxstackgreen);
-		config->SetMaxStack(ITEM_QUALITY_RARE, maxstackblue);
-		config->SetMaxStack(ITEM_QUALITY_EPIC, maxstackpurple);
-		config->SetMaxStack(ITEM_QUALITY_LEGENDARY, maxstackorange);
-		config->SetMaxStack(ITEM_QUALITY_ARTIFACT, maxstackyellow);
-
-        LOG_DEBUG("module.ahbot", "minItems                = {}", config->GetMinItems());
-        LOG_DEBUG("module.ahbot", "maxItems                = {}", config->GetMaxItems());
-        LOG_DEBUG("module.ahbot", "percentGreyTradeGoods   = {}", config->GetPercentages(ITEM_QUALITY_POOR));
-        LOG_DEBUG("module.ahbot", "percentWhiteTradeGoods  = {}", config->GetPercentages(ITEM_QUALITY_NORMAL));
-        LOG_DEBUG("module.ahbot", "percentGreenTradeGoods  = {}", config->GetPercentages(ITEM_QUALITY_UNCOMMON));
-        LOG_DEBUG("module.ahbot", "percentBlueTradeGoods   = {}", config->GetPercentages(ITEM_QUALITY_RARE));
-        LOG_DEBUG("module.ahbot", "percentPurpleTradeGoods = {}", config->GetPercentages(ITEM_QUALITY_EPIC));
-        LOG_DEBUG("module.ahbot", "percentOrangeTradeGoods = {}", config->GetPercentages(ITEM_QUALITY_LEGENDARY));
-        LOG_DEBUG("module.ahbot", "percentYellowTradeGoods = {}", config->GetPercentages(ITEM_QUALITY_ARTIFACT));
-        LOG_DEBUG("module.ahbot", "percentGreyItems        = {}", config->GetPercentages(AHB_ITEM_QUALITY_POOR));
-        LOG_DEBUG("module.ahbot", "percentWhiteItems       = {}", config->GetPercentages(AHB_ITEM_QUALITY_NORMAL));
-        LOG_DEBUG("module.ahbot", "percentGreenItems       = {}", config->GetPercentages(AHB_ITEM_QUALITY_UNCOMMON));
-        LOG_DEBUG("module.ahbot", "percentBlueItems        = {}", config->GetPercentages(AHB_ITEM_QUALITY_RARE));
-        LOG_DEBUG("module.ahbot", "percentPurpleItems      = {}", config->GetPercentages(AHB_ITEM_QUALITY_EPIC));
-        LOG_DEBUG("module.ahbot", "percentOrangeItems      = {}", config->GetPercentages(AHB_ITEM_QUALITY_LEGENDARY));
-        LOG_DEBUG("module.ahbot", "percentYellowItems      = {}", config->GetPercentages(AHB_ITEM_QUALITY_ARTIFACT));
-        LOG_DEBUG("module.ahbot", "minPriceGrey            = {}", config->GetMinPrice(ITEM_QUALITY_POOR));
-        LOG_DEBUG("module.ahbot", "maxPriceGrey            = {}", config->GetMaxPrice(ITEM_QUALITY_POOR));
-        LOG_DEBUG("module.ahbot", "minPriceWhite           = {}", config->GetMinPrice(ITEM_QUALITY_NORMAL));
-        LOG_DEBUG("module.ahbot", "maxPriceWhite           = {}", config->GetMaxPrice(ITEM_QUALITY_NORMAL));
-        LOG_DEBUG("module.ahbot", "minPriceGreen           = {}", config->GetMinPrice(ITEM_QUALITY_UNCOMMON));
-        LOG_DEBUG("module.ahbot", "maxPriceGreen           = {}", config->GetMaxPrice(ITEM_QUALITY_UNCOMMON));
-        LOG_DEBUG("module.ahbot", "minPriceBlue            = {}", config->GetMinPrice(ITEM_QUALITY_RARE));
-        LOG_DEBUG("module.ahbot", "maxPriceBlue            = {}", config->GetMaxPrice(ITEM_QUALITY_RARE));
-        LOG_DEBUG("module.ahbot", "minPricePurple          = {}", config->GetMinPrice(ITEM_QUALITY_EPIC));
-        LOG_DEBUG("module.ahbot", "maxPricePurple          = {}", config->GetMaxPrice(ITEM_QUALITY_EPIC));
-        LOG_DEBUG("module.ahbot", "minPriceOrange          = {}", config->GetMinPrice(ITEM_QUALITY_LEGENDARY));
-        LOG_DEBUG("module.ahbot", "maxPriceOrange          = {}", config->GetMaxPrice(ITEM_QUALITY_LEGENDARY));
-        LOG_DEBUG("module.ahbot", "minPriceYellow          = {}", config->GetMinPrice(ITEM_QUALITY_ARTIFACT));
-        LOG_DEBUG("module.ahbot", "maxPriceYellow          = {}", config->GetMaxPrice(ITEM_QUALITY_ARTIFACT));
-        LOG_DEBUG("module.ahbot", "minBidPriceGrey         = {}", config->GetMinBidPrice(ITEM_QUALITY_POOR));
-        LOG_DEBUG("module.ahbot", "maxBidPriceGrey         = {}", config->GetMaxBidPrice(ITEM_QUALITY_POOR));
-        LOG_DEBUG("module.ahbot", "minBidPriceWhite        = {}", config->GetMinBidPrice(ITEM_QUALITY_NORMAL));
-        LOG_DEBUG("module.ahbot", "maxBidPriceWhite        = {}", config->GetMaxBidPrice(ITEM_QUALITY_NORMAL));
-        LOG_DEBUG("module.ahbot", "minBidPriceGreen        = {}", config->GetMinBidPrice(ITEM_QUALITY_UNCOMMON));
-        LOG_DEBUG("module.ahbot", "maxBidPriceGreen        = {}", config->GetMaxBidPrice(ITEM_QUALITY_UNCOMMON));
-        LOG_DEBUG("module.ahbot", "minBidPriceBlue         = {}", config->GetMinBidPrice(ITEM_QUALITY_RARE));
-        LOG_DEBUG("module.ahbot", "maxBidPriceBlue         = {}", config->GetMinBidPrice(ITEM_QUALITY_RARE));
-        LOG_DEBUG("module.ahbot", "minBidPricePurple       = {}", config->GetMinBidPrice(ITEM_QUALITY_EPIC));
-        LOG_DEBUG("module.ahbot", "maxBidPricePurple       = {}", config->GetMaxBidPrice(ITEM_QUALITY_EPIC));
-        LOG_DEBUG("module.ahbot", "minBidPriceOrange       = {}", config->GetMinBidPrice(ITEM_QUALITY_LEGENDARY));
-        LOG_DEBUG("module.ahbot", "maxBidPriceOrange       = {}", config->GetMaxBidPrice(ITEM_QUALITY_LEGENDARY));
-        LOG_DEBUG("module.ahbot", "minBidPriceYellow       = {}", config->GetMinBidPrice(ITEM_QUALITY_ARTIFACT));
-        LOG_DEBUG("module.ahbot", "maxBidPriceYellow       = {}", config->GetMaxBidPrice(ITEM_QUALITY_ARTIFACT));
-        LOG_DEBUG("module.ahbot", "maxStackGrey            = {}", config->GetMaxStack(ITEM_QUALITY_POOR));
-        LOG_DEBUG("module.ahbot", "maxStackWhite           = {}", config->GetMaxStack(ITEM_QUALITY_NORMAL));
-        LOG_DEBUG("module.ahbot", "maxStackGreen           = {}", config->GetMaxStack(ITEM_QUALITY_UNCOMMON));
-        LOG_DEBUG("module.ahbot", "maxStackBlue            = {}", config->GetMaxStack(ITEM_QUALITY_RARE));
-        LOG_DEBUG("module.ahbot", "maxStackPurple          = {}", config->GetMaxStack(ITEM_QUALITY_EPIC));
-        LOG_DEBUG("module.ahbot", "maxStackOrange          = {}", config->GetMaxStack(ITEM_QUALITY_LEGENDARY));
-        LOG_DEBUG("module.ahbot", "maxStackYellow          = {}", config->GetMaxStack(ITEM_QUALITY_ARTIFACT));
+    LOG_DEBUG("module.ahbot", "End Settings for Auctionhouse {}", config->GetAuctionHouseID());
+    return true;
+}
 
-        AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(config->GetAuctionHouseFactionID());
+void AuctionHouseBot::CountItems(AHBConfig* config)
+{
+    AuctionHouseObject* auctionHouse = sAuctionMgr->GetAuctionsMap(config->GetAuctionHouseFactionID());
+
+    config->ResetItemCounts();
+    _botAuctions[config->GetAuctionHouseID()].clear();
+    _relistQueues[config->GetAuctionHouseID()].clear();
+    _botTradeGoods[config->GetAuctionHouseID()].clear();
+    _listingWeights[config->GetAuctionHouseID()].clear();
+    RequestRefill(config);
 
-        config->ResetItemCounts();
-        uint32 auctions = auctionHouse->Getcount();
+    AHBExpirySchedule& expirySchedule = _expirySchedules[config->GetAuctionHouseID()];
+    expirySchedule.Configure(ExpirySmoothing, ExpiryMaxOffset);
+    expirySchedule.Clear();
+
+    const time_t now = GameTime::GetGameTime().count();
+    uint32 auctions = auctionHouse->Getcount();
 
-        if (auctions)
+    if (auctions)
+    {
+        for (auto const& [__, auction] : auctionHouse->GetAuctions())
         {
-            for (auto const& [__, auction] : auctionHouse->GetAuctions())
-            {
-				Item* item = sAuctionMgr->GetAItem(auction->item_guid);
-                if (!item)
-                    continue;
+            Item* item = sAuctionMgr->GetAItem(auction->item_guid);
+            if (!item)
+                continue;
 
-                ItemTemplate const* prototype = item->GetTemplate();
-                if (!prototype)
-                    continue;
-                if (prototype->Quality >= ITEM_QUALITY_POOR && prototype->Quality <= ITEM_QUALITY_ARTIFACT)
+            ItemTemplate const* prototype = item->GetTemplate();
+            if (!prototype)
+                continue;
+            if (prototype->Quality >= ITEM_QUALITY_POOR && prototype->Quality <= ITEM_QUALITY_ARTIFACT)
+            {
+                if (prototype->Class == ITEM_CLASS_TRADE_GOODS)
                 {
-                    if (prototype->Class == ITEM_CLASS_TRADE_GOODS)
+                    for (uint32 weight = TrackListingWeight(config, auction, prototype, true); weight; --weight)
                         config->IncreaseItemCounts(prototype->Quality);
-                    else
-                        config->IncreaseItemCounts(prototype->Quality + AHB_MAX_DEFAULT_QUALITY); // Convert to AHB_ITEM enum
                 }
+                else
+                    config->IncreaseItemCounts(prototype->Quality + AHB_MAX_DEFAULT_QUALITY); // Convert to AHB_ITEM enum
             }
-        }
-
-        LOG_DEBUG("module.ahbot", "Current Settings for {} Auctionhouses:", auctionName);
-        LOG_DEBUG("module.ahbot", "Grey Trade Goods\t{}\tGrey Items\t{}", config->GetItemCounts(ITEM_QUALITY_POOR), config->GetItemCounts(AHB_ITEM_QUALITY_POOR));
-        LOG_DEBUG("module.ahbot", "White Trade Goods\t{}\tWhite Items\t{}", config->GetItemCounts(ITEM_QUALITY_NORMAL), config->GetItemCounts(AHB_ITEM_QUALITY_NORMAL));
-        LOG_DEBUG("module.ahbot", "Green Trade Goods\t{}\tGreen Items\t{}", config->GetItemCounts(ITEM_QUALITY_UNCOMMON), config->GetItemCounts(AHB_ITEM_QUALITY_UNCOMMON));
-        LOG_DEBUG("module.ahbot", "Blue Trade Goods\t{}\tBlue Items\t{}", config->GetItemCounts(ITEM_QUALITY_RARE), config->GetItemCounts(AHB_ITEM_QUALITY_RARE));
-        LOG_DEBUG("module.ahbot", "Purple Trade Goods\t{}\tPurple Items\t{}", config->GetItemCounts(ITEM_QUALITY_EPIC), config->GetItemCounts(AHB_ITEM_QUALITY_EPIC));
-        LOG_DEBUG("module.ahbot", "Orange Trade Goods\t{}\tOrange Items\t{}", config->GetItemCounts(ITEM_QUALITY_LEGENDARY), config->GetItemCounts(AHB_ITEM_QUALITY_LEGENDARY));
-        LOG_DEBUG("module.ahbot", "Yellow Trade Goods\t{}\tYellow Items\t{}", config->GetItemCounts(ITEM_QUALITY_ARTIFACT), config->GetItemCounts(AHB_ITEM_QUALITY_ARTIFACT));
-    }
 
-    if (AHBBuyer)
-    {
-        auto result = WorldDatabase.Query("SELECT buyerpricegrey, buyerpricewhite, buyerpricegreen, buyerpriceblue, buyerpricepurple, buyerpriceorange, buyerpriceyellow, buyerbiddinginterval, buyerbidsperinterval "
-            "FROM mod_auctionhousebot WHERE auctionhouse = {}", config->GetAuctionHouseID());
+            TrackBotAuction(config, auction, prototype, true);
 
-        if (!result)
-        {
-            LOG_ERROR("module.ahbot", "> Empty or invalid sql query for Auctionhouse: {}", config->GetAuctionHouseID());
-            return;
+            // The seller's own auctions are counted when their lifetime is scheduled, these were listed before
+            if (auction->owner.GetCounter() == AHBplayerGUID)
+                expirySchedule.Add(auction->expire_time, now);
         }
-
-        auto const& [buyerpricegrey, buyerpricewhite, buyerpricegreen, buyerpriceblue, buyerpricepurple, buyerpriceorange, buyerpriceyellow,
-            buyerbiddinginterval, buyerbidsperinterval]
-            = result->FetchTuple<uint32, uint32, uint32, uint32, uint32, uint32, uint32, uint32, uint32>();
-
-        // Load buyer bid prices
-		config->SetBuyerPrice(ITEM_QUALITY_POOR, buyerpricegrey);
-		config->SetBuyerPrice(ITEM_QUALITY_NORMAL, buyerpricewhite);
-		config->SetBuyerPrice(ITEM_QUALITY_UNCOMMON, buyerpricegreen);
-		config->SetBuyerPrice(ITEM_QUALITY_RARE, buyerpriceblue);
-		config->SetBuyerPrice(ITEM_QUALITY_EPIC, buyerpricepurple);
-		config->SetBuyerPrice(ITEM_QUALITY_LEGENDARY, buyerpriceorange);
-		config->SetBuyerPrice(ITEM_QUALITY_ARTIFACT, buyerpriceyellow);
-
-        // Load bidding interval
-		config->SetBiddingInterval(Minutes(buyerbiddinginterval));
-
-        // Load bids per interval
-		config->SetBidsPerInterval(buyerbidsperinterval);
-
-        LOG_DEBUG("module.ahbot", "buyerPriceGrey          = {}", config->GetBuyerPrice(ITEM_QUALITY_POOR));
-        LOG_DEBUG("module.ahbot", "buyerPriceWhite         = {}", config->GetBuyerPrice(ITEM_QUALITY_NORMAL));
-        LOG_DEBUG("module.ahbot", "buyerPriceGreen         = {}", config->GetBuyerPrice(ITEM_QUALITY_UNCOMMON));
-        LOG_DEBUG("module.ahbot", "buyerPriceBlue          = {}", config->GetBuyerPrice(ITEM_QUALITY_RARE));
-        LOG_DEBUG("module.ahbot", "buyerPricePurple        = {}", config->GetBuyerPrice(ITEM_QUALITY_EPIC));
-        LOG_DEBUG("module.ahbot", "buyerPriceOrange        = {}", config->GetBuyerPrice(ITEM_QUALITY_LEGENDARY));
-        LOG_DEBUG("module.ahbot", "buyerPriceYellow        = {}", config->GetBuyerPrice(ITEM_QUALITY_ARTIFACT));
-        LOG_DEBUG("module.ahbot", "buyerBiddingInterval    = {}", config->GetBiddingInterval().count());
-        LOG_DEBUG("module.ahbot", "buyerBidsPerInterval    = {}", config->GetBidsPerInterval());
     }
 
-    LOG_DEBUG("module.ahbot", "End Settings for Auctionhouses");
+    LOG_DEBUG("module.ahbot", "Current Settings for Auctionhouse {}:", config->GetAuctionHouseID());
+    LOG_DEBUG("module.ahbot", "Grey Trade Goods\t{}\tGrey Items\t{}", config->GetItemCounts(ITEM_QUALITY_POOR), config->GetItemCounts(AHB_ITEM_QUALITY_POOR));
+    LOG_DEBUG("module.ahbot", "White Trade Goods\t{}\tWhite Items\t{}", config->GetItemCounts(ITEM_QUALITY_NORMAL), config->GetItemCounts(AHB_ITEM_QUALITY_NORMAL));
+    LOG_DEBUG("module.ahbot", "Green Trade Goods\t{}\tGreen Items\t{}", config->GetItemCounts(ITEM_QUALITY_UNCOMMON), config->GetItemCounts(AHB_ITEM_QUALITY_UNCOMMON));
+    LOG_DEBUG("module.ahbot", "Blue Trade Goods\t{}\tBlue Items\t{}", config->GetItemCounts(ITEM_QUALITY_RARE), config->GetItemCounts(AHB_ITEM_QUALITY_RARE));
+    LOG_DEBUG("module.ahbot", "Purple Trade Goods\t{}\tPurple Items\t{}", config->GetItemCounts(ITEM_QUALITY_EPIC), config->GetItemCounts(AHB_ITEM_QUALITY_EPIC));
+    LOG_DEBUG("module.ahbot", "Orange Trade Goods\t{}\tOrange Items\t{}", config->GetItemCounts(ITEM_QUALITY_LEGENDARY), config->GetItemCounts(AHB_ITEM_QUALITY_LEGENDARY));
+    LOG_DEBUG("module.ahbot", "Yellow Trade Goods\t{}\tYellow Items\t{}", config->GetItemCounts(ITEM_QUALITY_ARTIFACT), config->GetItemCounts(AHB_ITEM_QUALITY_ARTIFACT));
 }
 
 void AuctionHouseBot::ProcessQueryCallbacks()
 {
     _queryProcessor.ProcessReadyCallbacks();
+
+    // Age of the oldest query still waiting, 0 if there is none
+    const auto now = std::chrono::steady_clock::now();
+    auto oldest = now;
+    for (auto const& [queryId, query] : _buyerQueries)
+        oldest = std::min(oldest, query.sent);
+
+    sAHMetrics->SetGauge(AHBGauge::OldestBuyerQueryMs, std::chrono::duration_cast<Milliseconds>(now - oldest).count());
 }
@@ -21,11 +21,26 @@
 #include "ObjectGuid.h"
 #include "ItemTemplate.h"
 #include "AuctionHouseBotConfig.h"
+#include "ConfigStore.h"
+#include "ExpirySchedule.h"
+#include "ItemIndex.h"
+#include "PriceBook.h"
+#include "TickBudget.h"
 #include "DatabaseEnvFwd.h"
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <deque>
+#include <future>
+#include <memory>
+#include <optional>
 #include <vector>
+#include <unordered_map>
 #include <unordered_set>
 
 struct AuctionEntry;
+class AuctionHouseObject;
+class Item;
 class Player;
 class WorldSession;
 
@@ -47,6 +62,74 @@ enum class AHBotCommand : uint32
     bidsperinterval
 };
 
+// Everything a reload loads from the database, built off the world thread and applied by Update()
+struct AHBReloadData
+{
+    AuctionHouseIndex index;
+    bool itemsLoaded{ false };
+    bool enablesSeller{ false };    // the seller was off and is switched on once the houses are counted
+    std::vector<AHBConfig> configs;
+
+    // Items added to and removed from every bin compared to the live index
+    std::array<std::pair<uint32, uint32>, AHB_MAX_QUALITY> binChanges{};
+};
+
+// Manual expiration of bot auctions, the in-memory part is spread over several updates
+struct AHBExpireJob
+{
+    uint32 houseId{ 0 };
+    bool byClass{ false };  // otherwise the database was already updated by a single statement
+    std::vector<uint32> auctionIds;
+    std::size_t next{ 0 };
+    uint32 expired{ 0 };
+};
+
+// "ahbotoptions purge", bot auctions removed without the expiry and its mails, spread over several updates
+struct AHBPurgeJob
+{
+    uint32 houseId{ 0 };
+    std::optional<uint32> quality;
+    std::vector<uint32> auctionIds;
+    std::size_t next{ 0 };
+    uint32 purged{ 0 };
+    uint32 withBids{ 0 };
+};
+
+// When the seller refills a house. Removals mark the bins they took from and wake it once the house
+// is below its minimum, it does not look at the house in between.
+struct AHBRefill
+{
+    bool pending{ true };       // a house is refilled with the first update after it was counted
+    Seconds due{ 0s };
+    uint32 removed{ 0 };        // auctions removed since the last refill
+    std::bitset<AHB_MAX_QUALITY> bins{ ~0ull };
+};
+
+// What a buyer query's callback needs, everything else is looked up when it runs
+struct AHBBuyerQuery
+{
+    uint32 houseId{ 0 };
+    uint32 intervals{ 1 };      // bid intervals it answers for, the ones that came while it was pending included
+    std::chrono::steady_clock::time_point sent;
+};
+
+// Auction of a bulk fill, drawn in the background and created by the updates after
+struct AHBFillAuction
+{
+    uint32 itemId{ 0 };
+    uint32 stackCount{ 0 };
+};
+
+// "ahbotoptions fill", a house filled up to its maximum in chunks of multi-row INSERTs
+struct AHBFillJob
+{
+    uint32 houseId{ 0 };
+    std::future<std::vector<AHBFillAuction>> pendingPlan;
+    std::vector<AHBFillAuction> auctions;
+    std::size_t next{ 0 };
+    std::chrono::steady_clock::time_point started;
+};
+
 class AuctionHouseBot
 {
 public:
@@ -59,11 +142,43 @@ public:
     void Initialize();
     void InitializeConfiguration();
     void LoadValues(AHBConfig*);
+    bool ScheduleReload();
     void DecrementItemCounts(AuctionEntry* ah, uint32 itemEntry);
     void IncrementItemCounts(AuctionEntry* ah);
     void Commands(AHBotCommand, uint32, uint32, char*);
     ObjectGuid::LowType GetAHBplayerGUID() { return AHBplayerGUID; };
 
+    // Online player level histogram, a level of 0 means not online. Can be called from map threads.
+    void UpdatePlayerLevel(uint32 oldLevel, uint32 newLevel);
+    std::array<uint32, AHB_LEVEL_BRACKETS> GetOnlinePlayersPerBracket() const;
+
+    // Market price book, fed by the auction house hooks
+    void RecordAuctionSale(AuctionEntry* auction);
+    void RecordAuctionRemoved(AuctionEntry* auction);
+    void FlushMarketPrices(bool direct = false);
+
+    // Settlement of what the bot wins or gets back without the core's mails to itself. SettleBotItem()
+    // takes the auction's item out of the auction house, it is destroyed by the next FlushSettlements().
+    // Both return false with AuctionHouseBot.DirectSettlement off, the mail is sent then.
+    bool SettleBotItem(AuctionEntry* auction);
+    bool RecordBotProceeds(AuctionEntry* auction, uint32 profit);
+    bool IsDirectSettlement() const { return DirectSettlement; }
+    void FlushSettlements(bool direct = false);
+
+    // Writes settings changed by commands once they were left alone for ConfigFlushDelay
+    void UpdateConfigStore(uint32 diff);
+    void FlushConfig(bool direct = false);
+
+    // Queues the removal of the bot's auctions in the house, of one item class and quality if given.
+    // Returns the number of auctions queued, auctions with a bid are skipped when the job gets to them.
+    uint32 PurgeHouse(uint32 ahMapID, std::optional<uint32> itemClass, std::optional<uint32> quality);
+
+    // Starts a bulk fill of the house, or reports the progress of the one running. Returns the reply for the command.
+    std::string FillHouse(uint32 ahMapID);
+
+    // Metrics of one house, or of all of them for houseId 0, for "ahbotoptions stats"
+    std::vector<std::string> FormatStats(uint32 houseId) const;
+
 private:
     bool AHBSeller{ false };
     bool AHBBuyer{ false };
@@ -73,6 +188,33 @@ private:
     uint32 AHBplayerAccount;
     ObjectGuid::LowType AHBplayerGUID;
     uint32 ItemsPerCycle;
+    float ItemsPerCycleMinShare{ 0.2f };
+    bool LevelBracketWeighting{ false };
+    float LevelBracketBaseWeight{ 1.f };
+
+    std::array<std::atomic<uint32>, AHB_LEVEL_BRACKETS> _onlinePlayersPerBracket{};
+
+    bool MarketPrices{ false };
+    bool MarketPricesForSeller{ false };
+    bool MarketPricesForBuyer{ false };
+    uint32 MarketPricesMinSold{ 5 };
+    Seconds MarketPricesFlushInterval{ 300s };
+    Milliseconds MassOperationBudget{ 10ms };
+    bool DirectSettlement{ true };
+    bool Relist{ false };
+    bool RelistReprice{ true };
+    Seconds RelistWindow{ 120s };
+    Seconds RefillDelay{ 60s };
+    uint32 BuyerMaxPendingQueries{ 1 };
+    bool ConsolidateTradeGoods{ false };
+    bool ExpirySmoothing{ true };
+    Seconds ExpiryMaxOffset{ 2h };
+    Seconds _lastMarketPricesFlush{ 0s };
+    AHBPriceBook _priceBook;
+    Milliseconds ConfigFlushDelay{ 5s };
+    Milliseconds _configFlushTimer{ 0ms };
+    AHBConfigStore _configStore;
+    AHBTickBudget _tickBudget;
 
     AHBConfig AllianceConfig;
     AHBConfig HordeConfig;
@@ -83,13 +225,67 @@ private:
     Seconds _lastUpdateNeutral{ 0s };
 
     inline uint32 minValue(uint32 a, uint32 b) { return a <= b ? a : b; };
-    void AddNewAuctions(Player* AHBplayer, AHBConfig* config);
-    void AddNewAuctionBuyerBotBid(std::shared_ptr<Player> player, std::shared_ptr<WorldSession> session, AHBConfig* config);
-    void AddNewAuctionBuyerBotBidCallback(std::shared_ptr<Player> player, std::shared_ptr<WorldSession> session, std::shared_ptr<AHBConfig> config, QueryResult result);
+    void UpdateHouses();
+    void AddNewAuctions(Player* AHBplayer, AHBConfig* config, uint32 itemBudget);
+    void RelistAuctions(AHBConfig* config, AuctionHouseObject* auctionHouse);
+    bool IsRefillDue(AHBConfig* config, Seconds now);
+    uint32 GetSellerDeficit(AHBConfig* config);
+    std::bitset<AHB_MAX_QUALITY> GetRefillBins(AHBConfig* config);
+    void RequestRefill(AHBConfig* config);
+    uint64 GetSellerBasePrice(ItemTemplate const* prototype) const;
+    AuctionEntry* TopUpAuction(AHBConfig* config, AuctionHouseObject* auctionHouse, ItemTemplate const* prototype, uint32 stackCount);
+    uint32 GetListingWeight(AHBConfig* config, AuctionEntry const* auction, ItemTemplate const* prototype) const;
+    uint32 TrackListingWeight(AHBConfig* config, AuctionEntry const* auction, ItemTemplate const* prototype, bool added);
+    std::array<float, AHB_LEVEL_BRACKETS> GetBracketWeights(uint32 quality, std::array<uint32, AHB_LEVEL_BRACKETS> const& onlinePlayers) const;
+    void ProcessFillJobs(Player* AHBplayer);
+    bool IsFilling(uint32 ahMapID) const;
+    static std::string FormatFillProgress(AHBFillJob const& job);
+    void AddNewAuctionBuyerBotBid(AHBConfig* config);
+    void AddNewAuctionBuyerBotBidCallback(uint32 queryId, QueryResult result);
+    uint32 GetPendingBuyerQueries(uint32 houseId) const;
+
+    // The bot's player, created by the first part of an update that needs it and gone at its end
+    Player* GetBotPlayer();
+    void ReleaseBotPlayer();
 
     void ProcessQueryCallbacks();
 
+    bool LoadSettings(AHBConfig* config);
+    void CountItems(AHBConfig* config);
+    AHBConfig* GetConfig(uint32 ahMapID);
+    AHBConfig* GetConfig(AuctionEntry const* auction);
+    void TrackBotAuction(AHBConfig* config, AuctionEntry const* auction, ItemTemplate const* prototype, bool added);
+    void RebuildRelistQueue(AHBConfig* config);
+    void QueueExpireJob(uint32 ahMapID, std::optional<uint32> itemClass);
+    void ProcessExpireJobs();
+    void ProcessPurgeJobs();
+    void ApplyReload();
+
     QueryCallbackProcessor _queryProcessor;
+    std::shared_ptr<WorldSession> _botSession;
+    std::shared_ptr<Player> _botPlayer;
+
+    // Buyer queries waiting for their result, by the id their callback holds
+    std::unordered_map<uint32, AHBBuyerQuery> _buyerQueries;
+    uint32 _lastBuyerQueryId{ 0 };
+    std::future<std::unique_ptr<AHBReloadData>> _pendingReload;
+
+    // house id -> bot owned auction id -> item class
+    std::unordered_map<uint32, std::unordered_map<uint32, uint8>> _botAuctions;
+    std::deque<AHBExpireJob> _expireJobs;
+    std::deque<AHBFillJob> _fillJobs;
+    std::deque<AHBPurgeJob> _purgeJobs;
+
+    // house id -> min heap of bot owned auctions by the expire time they had when pushed, empty with relisting off
+    std::unordered_map<uint32, std::vector<std::pair<time_t, uint32>>> _relistQueues;
+    std::unordered_map<uint32, AHBExpirySchedule> _expirySchedules;
+    std::unordered_map<uint32, AHBRefill> _refills;
+
+    // house id -> item id -> bot owned auctions of trade goods, the ones new stacks can go on top of
+    std::unordered_map<uint32, std::unordered_multimap<uint32, uint32>> _botTradeGoods;
+    // house id -> auction id -> listings a consolidated stack counts as, only those above 1
+    std::unordered_map<uint32, std::unordered_map<uint32, uint32>> _listingWeights;
+    std::vector<Item*> _settledItems;
 };
 
 #define sAHBot AuctionHouseBot::instance()
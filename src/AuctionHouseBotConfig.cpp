@@ -18,10 +18,60 @@
 #include "AuctionHouseBotConfig.h"
 #include "AuctionHouseMgr.h"
 #include "ItemTemplate.h"
+#include <algorithm>
+#include <cmath>
 #include <numeric>
+#include <string>
 
 #include "Log.h"
 
+char const* GetAHBQualityName(uint32 color)
+{
+    static constexpr std::array<char const*, AHB_MAX_QUALITY> names =
+    {
+        "grey trade goods", "white trade goods", "green trade goods", "blue trade goods", "purple trade goods", "orange trade goods", "yellow trade goods",
+        "grey items", "white items", "green items", "blue items", "purple items", "orange items", "yellow items"
+    };
+
+    if (color >= AHB_MAX_QUALITY)
+        return "unknown";
+
+    return names[color];
+}
+
+char const* GetAHBConfigColumnName(uint32 column)
+{
+    static const std::array<std::string, AHB_CONFIG_COLUMN_MAX> names = []()
+    {
+        static constexpr std::array<char const*, AHB_DEFAULT_QUALITY_SIZE> colors = { "grey", "white", "green", "blue", "purple", "orange", "yellow" };
+
+        std::array<std::string, AHB_CONFIG_COLUMN_MAX> columns;
+        columns[AHB_CONFIG_MIN_ITEMS] = "minitems";
+        columns[AHB_CONFIG_MAX_ITEMS] = "maxitems";
+        columns[AHB_CONFIG_BID_INTERVAL] = "buyerbiddinginterval";
+        columns[AHB_CONFIG_BIDS_PER_INTERVAL] = "buyerbidsperinterval";
+
+        for (uint32 color = 0; color < AHB_DEFAULT_QUALITY_SIZE; ++color)
+        {
+            columns[AHB_CONFIG_PERCENT + color] = std::string("percent") + colors[color] + "tradegoods";
+            columns[AHB_CONFIG_PERCENT + AHB_DEFAULT_QUALITY_SIZE + color] = std::string("percent") + colors[color] + "items";
+            columns[AHB_CONFIG_MIN_PRICE + color] = std::string("minprice") + colors[color];
+            columns[AHB_CONFIG_MAX_PRICE + color] = std::string("maxprice") + colors[color];
+            columns[AHB_CONFIG_MIN_BID_PRICE + color] = std::string("minbidprice") + colors[color];
+            columns[AHB_CONFIG_MAX_BID_PRICE + color] = std::string("maxbidprice") + colors[color];
+            columns[AHB_CONFIG_MAX_STACK + color] = std::string("maxstack") + colors[color];
+            columns[AHB_CONFIG_BUYER_PRICE + color] = std::string("buyerprice") + colors[color];
+        }
+
+        return columns;
+    }();
+
+    if (column >= AHB_CONFIG_COLUMN_MAX)
+        return "unknown";
+
+    return names[column].c_str();
+}
+
 AHBConfig::AHBConfig(uint32 ahid)
 {
     _auctionHouseID = ahid;
@@ -310,3 +360,86 @@ uint32 AHBConfig::GetItemCounts(uint32 color)
 
     return _itemsCount[color];
 }
+
+bool AHBConfig::HasSameSettings(AHBConfig const& other) const
+{
+    return _auctionHouseID == other._auctionHouseID &&
+        _minItems == other._minItems &&
+        _maxItems == other._maxItems &&
+        _buyerBiddingInterval == other._buyerBiddingInterval &&
+        _buyerBidsPerInterval == other._buyerBidsPerInterval &&
+        _itemsPercent == other._itemsPercent &&
+        _qualityInfo == other._qualityInfo;
+}
+
+void AHBConfig::ApplySettings(AHBConfig const& other)
+{
+    const std::array<uint32, AHB_MAX_QUALITY> itemsCount = _itemsCount;
+    *this = other;
+    _itemsCount = itemsCount;
+}
+
+double AHBConfig::GetColumn(uint32 column) const
+{
+    if (column == AHB_CONFIG_MIN_ITEMS)
+        return _minItems;
+    if (column == AHB_CONFIG_MAX_ITEMS)
+        return _maxItems;
+    if (column == AHB_CONFIG_BID_INTERVAL)
+        return _buyerBiddingInterval.count();
+    if (column == AHB_CONFIG_BIDS_PER_INTERVAL)
+        return _buyerBidsPerInterval;
+    if (column < AHB_CONFIG_MIN_PRICE)
+        return _itemsPercent[column - AHB_CONFIG_PERCENT];
+
+    QualityInfo const& info = _qualityInfo[(column - AHB_CONFIG_MIN_PRICE) % AHB_DEFAULT_QUALITY_SIZE];
+
+    if (column < AHB_CONFIG_MAX_PRICE)
+        return info._minPrice;
+    if (column < AHB_CONFIG_MIN_BID_PRICE)
+        return info._maxPrice;
+    if (column < AHB_CONFIG_MAX_BID_PRICE)
+        return info._minBidPrice;
+    if (column < AHB_CONFIG_MAX_STACK)
+        return info._maxBidPrice;
+    if (column < AHB_CONFIG_BUYER_PRICE)
+        return info._maxStack;
+    if (column < AHB_CONFIG_BID_INTERVAL)
+        return info._buyerPrice;
+
+    return 0;
+}
+
+void AHBConfig::SetColumn(uint32 column, double value)
+{
+    if (column >= AHB_CONFIG_COLUMN_MAX)
+        return;
+
+    if (column == AHB_CONFIG_MIN_ITEMS)
+        _minItems = value;
+    else if (column == AHB_CONFIG_MAX_ITEMS)
+        _maxItems = value;
+    else if (column == AHB_CONFIG_BID_INTERVAL)
+        _buyerBiddingInterval = Minutes(uint32(value));
+    else if (column == AHB_CONFIG_BIDS_PER_INTERVAL)
+        _buyerBidsPerInterval = value;
+    else if (column < AHB_CONFIG_MIN_PRICE)
+        _itemsPercent[column - AHB_CONFIG_PERCENT] = value;
+    else
+    {
+        QualityInfo& info = _qualityInfo[(column - AHB_CONFIG_MIN_PRICE) % AHB_DEFAULT_QUALITY_SIZE];
+
+        if (column < AHB_CONFIG_MAX_PRICE)
+            info._minPrice = value;
+        else if (column < AHB_CONFIG_MIN_BID_PRICE)
+            info._maxPrice = value;
+        else if (column < AHB_CONFIG_MAX_BID_PRICE)
+            info._minBidPrice = value;
+        else if (column < AHB_CONFIG_MAX_STACK)
+            info._maxBidPrice = value;
+        else if (column < AHB_CONFIG_BUYER_PRICE)
+            info._maxStack = value;
+        else
+            info._buyerPrice = value;
+    }
+}
@@ -38,6 +38,34 @@ constexpr uint32 AHB_MAX_DEFAULT_QUALITY = ITEM_QUALITY_ARTIFACT;
 constexpr uint32 AHB_DEFAULT_QUALITY_SIZE = AHB_MAX_DEFAULT_QUALITY + 1;
 constexpr uint32 AHB_MAX_QUALITY = AHB_ITEM_QUALITY_ARTIFACT + 1;
 
+// Human readable name of an AHB quality (trade goods and items), used by logs and chat output
+char const* GetAHBQualityName(uint32 color);
+
+// Columns of mod_auctionhousebot that hold settings, per quality columns are first column + quality
+enum AHBConfigColumn : uint8
+{
+    AHB_CONFIG_MIN_ITEMS,
+    AHB_CONFIG_MAX_ITEMS,
+    AHB_CONFIG_PERCENT,
+    AHB_CONFIG_MIN_PRICE = AHB_CONFIG_PERCENT + AHB_MAX_QUALITY,
+    AHB_CONFIG_MAX_PRICE = AHB_CONFIG_MIN_PRICE + AHB_DEFAULT_QUALITY_SIZE,
+    AHB_CONFIG_MIN_BID_PRICE = AHB_CONFIG_MAX_PRICE + AHB_DEFAULT_QUALITY_SIZE,
+    AHB_CONFIG_MAX_BID_PRICE = AHB_CONFIG_MIN_BID_PRICE + AHB_DEFAULT_QUALITY_SIZE,
+    AHB_CONFIG_MAX_STACK = AHB_CONFIG_MAX_BID_PRICE + AHB_DEFAULT_QUALITY_SIZE,
+    AHB_CONFIG_BUYER_PRICE = AHB_CONFIG_MAX_STACK + AHB_DEFAULT_QUALITY_SIZE,
+    AHB_CONFIG_BID_INTERVAL = AHB_CONFIG_BUYER_PRICE + AHB_DEFAULT_QUALITY_SIZE,
+    AHB_CONFIG_BIDS_PER_INTERVAL,
+    AHB_CONFIG_COLUMN_MAX
+};
+
+char const* GetAHBConfigColumnName(uint32 column);
+
+// Percentages are the only float columns
+inline bool IsAHBConfigColumnFloat(uint32 column)
+{
+    return column >= AHB_CONFIG_PERCENT && column < AHB_CONFIG_MIN_PRICE;
+}
+
 class AHBConfig
 {
 public:
@@ -46,7 +74,7 @@ public:
 
     AHBConfig(uint32 ahid);
 
-    inline uint32 GetAuctionHouseID()
+    inline uint32 GetAuctionHouseID() const
     {
         return _auctionHouseID;
     }
@@ -151,6 +179,18 @@ public:
         return _buyerBidsPerInterval;
     }
 
+    // Compares everything that is loaded from the database, but not the live item counts
+    bool HasSameSettings(AHBConfig const& other) const;
+
+    // Takes over all settings of other, but keeps our own live item counts
+    void ApplySettings(AHBConfig const& other);
+
+    // Raw value of a mod_auctionhousebot column, without the defaults the getters fall back to
+    double GetColumn(uint32 column) const;
+
+    // Percentages are taken as they are, SetPercentages() normalizes them and updates the max counts
+    void SetColumn(uint32 column, double value);
+
 private:
     uint32 _auctionHouseID{ 0 };
     uint32 _auctionHouseFactionID{ 0 };
@@ -173,6 +213,8 @@ private:
         uint32_t _minPrice {};
         uint32_t _maxPrice {};
         uint32_t _itemsCount {};
+
+        bool operator==(QualityInfo const&) const = default;
     };
 
     std::array<QualityInfo, AHB_DEFAULT_QUALITY_SIZE> _qualityInfo{};
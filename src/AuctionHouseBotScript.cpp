@@ -20,6 +20,7 @@
 #include "Log.h"
 #include "Mail.h"
 #include "Player.h"
+#include "TraceWriter.h"
 #include "WorldSession.h"
 
 class AHBot_WorldScript : public WorldScript
@@ -37,6 +38,19 @@ public:
         LOG_INFO("server.loading", "Initialize AuctionHouseBot...");
         sAHBot->Initialize();
     }
+
+    void OnUpdate(uint32 diff) override
+    {
+        sAHBot->UpdateConfigStore(diff);
+    }
+
+    void OnShutdown() override
+    {
+        sAHBot->FlushMarketPrices(true);
+        sAHBot->FlushConfig(true);
+        sAHBot->FlushSettlements(true);
+        sAHTrace->Shutdown();
+    }
 };
 
 class AHBot_AuctionHouseScript : public AuctionHouseScript
@@ -44,25 +58,51 @@ class AHBot_AuctionHouseScript : public AuctionHouseScript
 public:
     AHBot_AuctionHouseScript() : AuctionHouseScript("AHBot_AuctionHouseScript") { }
 
-    void OnBeforeAuctionHouseMgrSendAuctionSuccessfulMail(AuctionHouseMgr* /*auctionHouseMgr*/, AuctionEntry* /*auction*/, Player* owner, uint32& /*owner_accId*/, uint32& /*profit*/, bool& sendNotification, bool& updateAchievementCriteria, bool& /*sendMail*/) override
+    void OnBeforeAuctionHouseMgrSendAuctionSuccessfulMail(AuctionHouseMgr* /*auctionHouseMgr*/, AuctionEntry* auction, Player* /*owner*/, uint32& /*owner_accId*/, uint32& profit, bool& sendNotification, bool& updateAchievementCriteria, bool& sendMail) override
     {
-        if (owner && owner->GetGUID().GetCounter() == sAHBot->GetAHBplayerGUID())
+        sAHBot->RecordAuctionSale(auction);
+
+        if (auction->owner.GetCounter() == sAHBot->GetAHBplayerGUID())
         {
             sendNotification = false;
             updateAchievementCriteria = false;
+
+            if (sAHBot->RecordBotProceeds(auction, profit))
+                sendMail = false;
         }
     }
 
-    void OnBeforeAuctionHouseMgrSendAuctionExpiredMail(AuctionHouseMgr* /*auctionHouseMgr*/, AuctionEntry* /*auction*/, Player* owner, uint32& /*owner_accId*/, bool& sendNotification, bool& /*sendMail*/) override
+    void OnBeforeAuctionHouseMgrSendAuctionExpiredMail(AuctionHouseMgr* /*auctionHouseMgr*/, AuctionEntry* auction, Player* /*owner*/, uint32& /*owner_accId*/, bool& sendNotification, bool& sendMail) override
     {
-        if (owner && owner->GetGUID().GetCounter() == sAHBot->GetAHBplayerGUID())
+        if (auction->owner.GetCounter() == sAHBot->GetAHBplayerGUID())
+        {
             sendNotification = false;
+
+            if (sAHBot->SettleBotItem(auction))
+                sendMail = false;
+        }
     }
 
-    void OnBeforeAuctionHouseMgrSendAuctionOutbiddedMail(AuctionHouseMgr* /*auctionHouseMgr*/, AuctionEntry* auction, Player* oldBidder, uint32& /*oldBidder_accId*/, Player* newBidder, uint32& newPrice, bool& /*sendNotification*/, bool& /*sendMail*/) override
+    void OnBeforeAuctionHouseMgrSendAuctionWonMail(AuctionHouseMgr* /*auctionHouseMgr*/, AuctionEntry* auction, Player* /*bidder*/, uint32& /*bidder_accId*/, bool& sendNotification, bool& updateAchievementCriteria, bool& sendMail) override
+    {
+        if (auction->bidder.GetCounter() == sAHBot->GetAHBplayerGUID())
+        {
+            sendNotification = false;
+            updateAchievementCriteria = false;
+
+            if (sAHBot->SettleBotItem(auction))
+                sendMail = false;
+        }
+    }
+
+    void OnBeforeAuctionHouseMgrSendAuctionOutbiddedMail(AuctionHouseMgr* /*auctionHouseMgr*/, AuctionEntry* auction, Player* oldBidder, uint32& /*oldBidder_accId*/, Player* newBidder, uint32& newPrice, bool& /*sendNotification*/, bool& sendMail) override
     {
         if (oldBidder && !newBidder)
             oldBidder->GetSession()->SendAuctionBidderNotification(auction->GetHouseId(), auction->Id, ObjectGuid::Create<HighGuid::Player>(sAHBot->GetAHBplayerGUID()), newPrice, auction->GetAuctionOutBid(), auction->item_template);
+
+        // The bot's bid coming back, it has no use for the money
+        if (auction->bidder.GetCounter() == sAHBot->GetAHBplayerGUID() && sAHBot->IsDirectSettlement())
+            sendMail = false;
     }
 
     void OnAuctionAdd(AuctionHouseObject* /*ah*/, AuctionEntry* auction) override
@@ -73,11 +113,36 @@ public:
     void OnAuctionRemove(AuctionHouseObject* /*ah*/, AuctionEntry* auction) override
     {
         sAHBot->DecrementItemCounts(auction, auction->item_template);
+        sAHBot->RecordAuctionRemoved(auction);
     }
 
     void OnBeforeAuctionHouseMgrUpdate() override
     {
         sAHBot->Update();
+
+        // The core's own update runs right after this hook
+        sAHTrace->Instant("AuctionHouseMgr::Update", 0, 0);
+    }
+};
+
+class AHBot_PlayerScript : public PlayerScript
+{
+public:
+    AHBot_PlayerScript() : PlayerScript("AHBot_PlayerScript") { }
+
+    void OnLogin(Player* player) override
+    {
+        sAHBot->UpdatePlayerLevel(0, player->GetLevel());
+    }
+
+    void OnLogout(Player* player) override
+    {
+        sAHBot->UpdatePlayerLevel(player->GetLevel(), 0);
+    }
+
+    void OnLevelChanged(Player* player, uint8 oldLevel) override
+    {
+        sAHBot->UpdatePlayerLevel(oldLevel, player->GetLevel());
     }
 };
 
@@ -88,6 +153,7 @@ public:
 
     void OnBeforeMailDraftSendMailTo(MailDraft* /*mailDraft*/, MailReceiver const& receiver, MailSender const& sender, MailCheckMask& /*checked*/, uint32& /*deliver_delay*/, uint32& /*custom_expiration*/, bool& deleteMailItemsFromDB, bool& sendMail) override
     {
+        // Mails to the bot the auction house hooks did not stop, all of them with DirectSettlement off
         if (receiver.GetPlayerGUIDLow() == sAHBot->GetAHBplayerGUID())
         {
             if (sender.GetMailMessageType() == MAIL_AUCTION)        // auction mail with items
@@ -101,5 +167,6 @@ void AddAHBotScripts()
 {
     new AHBot_WorldScript();
     new AHBot_AuctionHouseScript();
+    new AHBot_PlayerScript();
     new AHBot_MailScript();
 }
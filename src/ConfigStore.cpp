@@ -0,0 +1,115 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ConfigStore.h"
+
+#include "DatabaseEnv.h"
+#include "Log.h"
+#include "Metrics.h"
+#include "Statements.h"
+#include "StringFormat.h"
+
+bool AHBConfigStore::Load(AHBConfig& config)
+{
+    std::string columns;
+    for (uint32 column = 0; column < AHB_CONFIG_COLUMN_MAX; ++column)
+    {
+        if (column)
+            columns += ", ";
+
+        columns += GetAHBConfigColumnName(column);
+    }
+
+    QueryResult result = sAHStatements->Query(AHB_WORLD_SEL_SETTINGS, columns, config.GetAuctionHouseID());
+
+    if (!result)
+        return false;
+
+    const Field* fields = result->Fetch();
+
+    for (uint32 column = 0; column < AHB_CONFIG_COLUMN_MAX; ++column)
+    {
+        if (IsAHBConfigColumnFloat(column))
+            config.SetColumn(column, fields[column].Get<float>());
+        else
+            config.SetColumn(column, fields[column].Get<uint32>());
+
+        LOG_DEBUG("module.ahbot", "AuctionHouseBot: {} = {}", GetAHBConfigColumnName(column), config.GetColumn(column));
+    }
+
+    // Normalizes them and recalculates the max counts, which also takes the loaded maxitems into account
+    std::array<float, AHB_MAX_QUALITY> percentages{};
+    for (uint32 i = 0; i < AHB_MAX_QUALITY; ++i)
+        percentages[i] = config.GetColumn(AHB_CONFIG_PERCENT + i);
+
+    config.SetPercentages(percentages);
+    return true;
+}
+
+void AHBConfigStore::Set(AHBConfig& config, uint32 column, double value)
+{
+    config.SetColumn(column, value);
+    MarkDirty(config.GetAuctionHouseID(), column);
+}
+
+void AHBConfigStore::MarkDirty(uint32 houseId, uint32 column)
+{
+    if (column < AHB_CONFIG_COLUMN_MAX)
+        _dirty[houseId].set(column);
+}
+
+void AHBConfigStore::KeepChanges(AHBConfig& loaded, AHBConfig const& live) const
+{
+    const auto found = _dirty.find(live.GetAuctionHouseID());
+
+    if (found == _dirty.end())
+        return;
+
+    for (uint32 column = 0; column < AHB_CONFIG_COLUMN_MAX; ++column)
+        if (found->second.test(column))
+            loaded.SetColumn(column, live.GetColumn(column));
+
+    // The max counts follow maxitems and the percentages
+    loaded.CalculateMaxCounts();
+}
+
+void AHBConfigStore::Flush(AHBConfig const& config, bool direct)
+{
+    const auto found = _dirty.find(config.GetAuctionHouseID());
+
+    if (found == _dirty.end())
+        return;
+
+    std::string assignments;
+    for (uint32 column = 0; column < AHB_CONFIG_COLUMN_MAX; ++column)
+    {
+        if (!found->second.test(column))
+            continue;
+
+        if (!assignments.empty())
+            assignments += ", ";
+
+        assignments += Acore::StringFormatFmt("{} = {}", GetAHBConfigColumnName(column), config.GetColumn(column));
+    }
+
+    LOG_DEBUG("module.ahbot", "AuctionHouseBot: Writing {} changed settings of house {}", found->second.count(), config.GetAuctionHouseID());
+    _dirty.erase(found);
+
+    sAHStatements->Execute(AHB_WORLD_UPD_SETTINGS, direct, assignments, config.GetAuctionHouseID());
+
+    sAHMetrics->Add(AHBCounter::DbStatements, config.GetAuctionHouseID());
+}
@@ -0,0 +1,53 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AHB_CONFIG_STORE_H
+#define AHB_CONFIG_STORE_H
+
+#include "AuctionHouseBotConfig.h"
+#include <bitset>
+#include <unordered_map>
+
+// Reads and writes the settings of mod_auctionhousebot.
+// Changes made by commands are applied in memory right away and only marked dirty, all dirty columns
+// of a house are written by a single UPDATE on the next Flush(), however many settings were changed.
+class AHBConfigStore
+{
+public:
+    using ColumnMask = std::bitset<AHB_CONFIG_COLUMN_MAX>;
+
+    // Reads all columns of config's house into it, touches no store state and can run on any thread
+    static bool Load(AHBConfig& config);
+
+    void Set(AHBConfig& config, uint32 column, double value);
+
+    // For columns a setter of AHBConfig changed itself
+    void MarkDirty(uint32 houseId, uint32 column);
+
+    bool HasChanges() const { return !_dirty.empty(); }
+
+    // Copies the dirty columns of live into loaded, so settings read while they were changed do not undo the changes
+    void KeepChanges(AHBConfig& loaded, AHBConfig const& live) const;
+
+    // Writes the dirty columns of config's house, directly before a reload or at shutdown
+    void Flush(AHBConfig const& config, bool direct = false);
+
+private:
+    std::unordered_map<uint32, ColumnMask> _dirty;
+};
+
+#endif
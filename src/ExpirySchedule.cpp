@@ -0,0 +1,142 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ExpirySchedule.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+    constexpr int64 bucketLength = AHBExpirySchedule::BucketLength.count();
+
+    // One bucket more than the horizon needs, the last one is never cut in half
+    constexpr std::size_t bucketCount = AHBExpirySchedule::GetHorizon().count() / bucketLength + 2;
+}
+
+void AHBExpirySchedule::Configure(bool smoothing, Seconds maxOffset)
+{
+    _smoothing = smoothing;
+    _maxOffset = std::min(maxOffset, AHB_EXPIRY_MAX_OFFSET);
+}
+
+void AHBExpirySchedule::Clear()
+{
+    _buckets.assign(bucketCount, { -1, 0 });
+}
+
+void AHBExpirySchedule::Add(time_t expireTime, time_t now)
+{
+    if (expireTime <= now || expireTime > now + GetHorizon().count())
+        return;
+
+    const int64 bucket = expireTime / bucketLength;
+    auto& [number, count] = _buckets[bucket % _buckets.size()];
+
+    // The slot still holds a bucket of the past, that one is over
+    if (number < bucket)
+    {
+        number = bucket;
+        count = 0;
+    }
+
+    if (number == bucket)
+        ++count;
+}
+
+void AHBExpirySchedule::Remove(time_t expireTime, time_t now)
+{
+    if (expireTime <= now)
+        return;
+
+    const int64 bucket = expireTime / bucketLength;
+    auto& [number, count] = _buckets[bucket % _buckets.size()];
+    if (number == bucket && count)
+        --count;
+}
+
+uint32 AHBExpirySchedule::GetCount(int64 bucket) const
+{
+    auto const& [number, count] = _buckets[bucket % _buckets.size()];
+    return number == bucket ? count : 0;
+}
+
+Seconds AHBExpirySchedule::Schedule(time_t now, std::mt19937& rng)
+{
+    time_t expireTime;
+
+    if (!_smoothing)
+    {
+        std::uniform_int_distribution<std::size_t> randomTime(0, AHB_AUCTION_LIFETIMES.size() - 1);
+        expireTime = now + Seconds(AHB_AUCTION_LIFETIMES[randomTime(rng)]).count();
+    }
+    else
+    {
+        // Every bucket the auction could expire in with any of the durations, the least loaded ones win.
+        // First and last bucket of a duration only partly are in its range, from and to are what is.
+        struct Candidate
+        {
+            time_t from;
+            time_t to;
+        };
+
+        std::array<Candidate, AHB_AUCTION_LIFETIMES.size() * (AHB_EXPIRY_MAX_OFFSET.count() / bucketLength + 2)> candidates;
+        std::size_t candidateCount = 0;
+        uint32 leastCount = std::numeric_limits<uint32>::max();
+
+        for (Hours duration : AHB_AUCTION_LIFETIMES)
+        {
+            const time_t earliest = now + Seconds(duration).count();
+            const time_t latest = earliest + _maxOffset.count();
+
+            for (int64 bucket = earliest / bucketLength; bucket <= latest / bucketLength; ++bucket)
+            {
+                const uint32 count = GetCount(bucket);
+                if (count > leastCount)
+                    continue;
+
+                if (count < leastCount)
+                {
+                    leastCount = count;
+                    candidateCount = 0;
+                }
+
+                candidates[candidateCount++] = { std::max<time_t>(earliest, bucket * bucketLength), std::min<time_t>(latest, (bucket + 1) * bucketLength - 1) };
+            }
+        }
+
+        Candidate const& candidate = candidates[std::uniform_int_distribution<std::size_t>(0, candidateCount - 1)(rng)];
+        expireTime = std::uniform_int_distribution<time_t>(candidate.from, candidate.to)(rng);
+    }
+
+    Add(expireTime, now);
+    return Seconds(expireTime - now);
+}
+
+std::vector<uint32> AHBExpirySchedule::GetHistogram(time_t now, Seconds span) const
+{
+    const time_t end = now + GetHorizon().count();
+    std::vector<uint32> histogram((GetHorizon().count() + span.count() - 1) / span.count(), 0);
+
+    for (int64 bucket = now / bucketLength; bucket <= end / bucketLength; ++bucket)
+    {
+        const time_t start = std::max<time_t>(now, bucket * bucketLength);
+        histogram[std::min<std::size_t>((start - now) / span.count(), histogram.size() - 1)] += GetCount(bucket);
+    }
+
+    return histogram;
+}
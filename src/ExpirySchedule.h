@@ -0,0 +1,69 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AHB_EXPIRY_SCHEDULE_H
+#define AHB_EXPIRY_SCHEDULE_H
+
+#include "Define.h"
+#include "Duration.h"
+#include <array>
+#include <ctime>
+#include <random>
+#include <utility>
+#include <vector>
+
+// The durations a player can list an auction for
+constexpr std::array<Hours, 3> AHB_AUCTION_LIFETIMES = { 12h, 24h, 48h };
+constexpr Seconds AHB_EXPIRY_MAX_OFFSET{ 6h };
+
+// Histogram of the upcoming expiries of the bot's auctions in one house, in buckets of 15 minutes.
+// Picks the lifetime of new auctions so their expiries land in the least loaded bucket, a house
+// filled in one go does not all run out in the same minute 12, 24 or 48 hours later.
+class AHBExpirySchedule
+{
+public:
+    static constexpr Seconds BucketLength{ 15min };
+
+    AHBExpirySchedule() { Clear(); }
+
+    // Without smoothing a lifetime is one of the durations at random, maxOffset is how much
+    // longer than its duration an auction may run
+    void Configure(bool smoothing, Seconds maxOffset);
+    void Clear();
+
+    // Expire times of the past are not counted
+    void Add(time_t expireTime, time_t now);
+    void Remove(time_t expireTime, time_t now);
+
+    // Lifetime of an auction listed now, already counted in the histogram
+    Seconds Schedule(time_t now, std::mt19937& rng);
+
+    // Expiries from now on, summed per span over the whole horizon
+    std::vector<uint32> GetHistogram(time_t now, Seconds span) const;
+    static constexpr Seconds GetHorizon() { return Hours(AHB_AUCTION_LIFETIMES.back()) + AHB_EXPIRY_MAX_OFFSET + BucketLength; }
+
+private:
+    uint32 GetCount(int64 bucket) const;
+
+    bool _smoothing{ true };
+    Seconds _maxOffset{ 2h };
+
+    // Ring buffer over the horizon, bucket number (expire time / bucket length) -> expiries
+    std::vector<std::pair<int64, uint32>> _buckets;
+};
+
+#endif
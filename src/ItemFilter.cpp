@@ -0,0 +1,344 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ItemFilter.h"
+
+#include "ItemTemplate.h"
+#include "Log.h"
+#include "SharedDefines.h"
+#include "SmartEnum.h"
+
+AHBFilterRule ItemFilter::GetRejectingRule(const ItemTemplate& itemTemplate) const
+{
+    switch (itemTemplate.Bonding)
+    {
+    case NO_BIND:
+        if (!No_Bind)
+            return AHB_FILTER_RULE_BONDING;
+        break;
+    case BIND_WHEN_PICKED_UP:
+        if (!Bind_When_Picked_Up)
+            return AHB_FILTER_RULE_BONDING;
+        break;
+    case BIND_WHEN_EQUIPED:
+        if (!Bind_When_Equipped)
+            return AHB_FILTER_RULE_BONDING;
+        break;
+    case BIND_WHEN_USE:
+        if (!Bind_When_Use)
+            return AHB_FILTER_RULE_BONDING;
+        break;
+    case BIND_QUEST_ITEM:
+        if (!Bind_Quest_Item)
+            return AHB_FILTER_RULE_BONDING;
+        break;
+    default:
+        return AHB_FILTER_RULE_BONDING;
+    }
+
+    uint32 basePrice = SellMethod ? itemTemplate.BuyPrice : itemTemplate.SellPrice;
+
+    {
+        const auto foundOverride = itemPriceOverride.find(itemTemplate.ItemId);
+
+        if (foundOverride != itemPriceOverride.end())
+            basePrice = foundOverride->second.mean;
+    }
+
+    // has no price
+    if (!basePrice)
+    {
+        LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} has no price", itemTemplate.ItemId);
+        return AHB_FILTER_RULE_NO_PRICE;
+    }
+
+    if (itemTemplate.Quality > ITEM_QUALITY_ARTIFACT)
+        return AHB_FILTER_RULE_QUALITY;
+
+    auto isVendorItem = [this](const ItemTemplate& itemTemplate)
+        {
+            return npcItems.contains(itemTemplate.ItemId);
+        };
+
+    auto isLootItem = [this](const ItemTemplate& itemTemplate)
+        {
+            return lootItems.contains(itemTemplate.ItemId);
+        };
+
+    if (itemTemplate.Class != ITEM_CLASS_TRADE_GOODS)
+    {
+        // Item checks
+
+        if (!Vendor_Items)
+        {
+            if (isVendorItem(itemTemplate))
+                return AHB_FILTER_RULE_VENDOR_ITEMS;
+        }
+
+        if (!Loot_Items)
+        {
+            if (isLootItem(itemTemplate))
+                return AHB_FILTER_RULE_LOOT_ITEMS;
+        }
+
+        if (!Other_Items)
+        {
+            if (!isLootItem(itemTemplate) && !isVendorItem(itemTemplate))
+                return AHB_FILTER_RULE_OTHER_ITEMS;
+        }
+    }
+    else if (itemTemplate.Class == ITEM_CLASS_TRADE_GOODS)
+    {
+        // Tradegood checks
+
+        if (!Vendor_TGs)
+        {
+            if (isVendorItem(itemTemplate))
+                return AHB_FILTER_RULE_VENDOR_TGS;
+        }
+
+        if (!Loot_TGs)
+        {
+            if (isLootItem(itemTemplate))
+                return AHB_FILTER_RULE_LOOT_TGS;
+        }
+
+        if (!Other_TGs)
+        {
+            if (!isLootItem(itemTemplate) && !isVendorItem(itemTemplate))
+                return AHB_FILTER_RULE_OTHER_TGS;
+        }
+    }
+
+
+    // Disable items by Id
+    if (disabledItems.contains(itemTemplate.ItemId))
+    {
+        LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (PTR/Beta/Unused Item)", itemTemplate.ItemId);
+        return AHB_FILTER_RULE_DISABLED_ITEMS;
+    }
+
+    // Disable permanent enchants items
+    if (DisablePermEnchant && itemTemplate.Class == ITEM_CLASS_PERMANENT)
+    {
+        LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (Permanent Enchant Item)", itemTemplate.ItemId);
+        return AHB_FILTER_RULE_PERM_ENCHANT;
+    }
+
+    // Disable conjured items
+    if (DisableConjured && itemTemplate.IsConjuredConsumable())
+    {
+        LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (Conjured Consumable)", itemTemplate.ItemId);
+        return AHB_FILTER_RULE_CONJURED;
+    }
+
+    // Disable gems
+    if (DisableGems && itemTemplate.Class == ITEM_CLASS_GEM)
+    {
+        LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (Gem)", itemTemplate.ItemId);
+        return AHB_FILTER_RULE_GEMS;
+    }
+
+    // Disable money
+    if (DisableMoney && itemTemplate.Class == ITEM_CLASS_MONEY)
+    {
+        LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (Money)", itemTemplate.ItemId);
+        return AHB_FILTER_RULE_MONEY;
+    }
+
+    // Disable moneyloot
+    if (DisableMoneyLoot && itemTemplate.MinMoneyLoot)
+    {
+        LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (MoneyLoot)", itemTemplate.ItemId);
+        return AHB_FILTER_RULE_MONEY_LOOT;
+    }
+
+    // Disable lootable items
+    if (DisableLootable && itemTemplate.Flags & 4)
+    {
+        LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (Lootable Item)", itemTemplate.ItemId);
+        return AHB_FILTER_RULE_LOOTABLE;
+    }
+
+    // Disable Keys
+    if (DisableKeys && itemTemplate.Class == ITEM_CLASS_KEY)
+    {
+        LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (Quest Item)", itemTemplate.ItemId);
+        return AHB_FILTER_RULE_KEYS;
+    }
+
+    // Disable items with duration
+    if (DisableDuration && itemTemplate.Duration)
+    {
+        LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (Has a Duration)", itemTemplate.ItemId);
+        return AHB_FILTER_RULE_DURATION;
+    }
+
+    // Disable items which are BOP or Quest Items and have a required level lower than the item level
+    if (DisableBOP_Or_Quest_NoReqLevel && ((itemTemplate.Bonding == BIND_WHEN_PICKED_UP || itemTemplate.Bonding == BIND_QUEST_ITEM) && (itemTemplate.RequiredLevel < itemTemplate.ItemLevel)))
+    {
+        LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (BOP or BQI and Required Level is less than Item Level)", itemTemplate.ItemId);
+        return AHB_FILTER_RULE_BOP_OR_QUEST_NO_REQ_LEVEL;
+    }
+
+
+    // We have disabled some class-specific items, lets see if this is one of them
+    if (DisableClassItemsMask.any())
+    {
+        const std::bitset<32> allowableClass(itemTemplate.AllowableClass);
+
+        // If this item is specific for just one class (as opposed to multiple classes), then check if its a class that we have disabled
+        if (allowableClass.count() == 1)
+        {
+            if ((DisableClassItemsMask & allowableClass).any())
+            {
+                // slightly ugly, find index of first bit that is set, to find out which class this is
+
+                Classes itemAllowClass = Classes::CLASS_NONE;
+                for (uint8 classBit = 0; classBit < MAX_CLASSES; ++classBit)
+                    if (allowableClass.test(classBit))
+                        itemAllowClass = static_cast<Classes>(classBit + 1); // Zero based index back to 1 based
+
+                LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled ({} Item)", itemTemplate.ItemId, Acore::Impl::EnumUtilsImpl::EnumUtils<Classes>::ToString(itemAllowClass).Title);
+                return AHB_FILTER_RULE_CLASS_ITEMS;
+            }
+        }
+    }
+
+    if (itemTemplate.Class != ITEM_CLASS_TRADE_GOODS)
+    {
+        // Item filters
+
+        // Disable Items below level X
+        if (DisableItemsBelowLevel && itemTemplate.ItemLevel < DisableItemsBelowLevel)
+        {
+            LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (Item Level = {})", itemTemplate.ItemId, itemTemplate.ItemLevel);
+            return AHB_FILTER_RULE_ITEMS_BELOW_LEVEL;
+        }
+
+        // Disable Items above level X
+        if (DisableItemsAboveLevel && itemTemplate.ItemLevel > DisableItemsAboveLevel)
+        {
+            LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (Item Level = {})", itemTemplate.ItemId, itemTemplate.ItemLevel);
+            return AHB_FILTER_RULE_ITEMS_ABOVE_LEVEL;
+        }
+
+        // Disable Items below GUID X
+        if (DisableItemsBelowGUID && itemTemplate.ItemId < DisableItemsBelowGUID)
+        {
+            LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (Item Level = {})", itemTemplate.ItemId, itemTemplate.ItemLevel);
+            return AHB_FILTER_RULE_ITEMS_BELOW_GUID;
+        }
+
+        // Disable Items above GUID X
+        if (DisableItemsAboveGUID && itemTemplate.ItemId > DisableItemsAboveGUID)
+        {
+            LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (Item Level = {})", itemTemplate.ItemId, itemTemplate.ItemLevel);
+            return AHB_FILTER_RULE_ITEMS_ABOVE_GUID;
+        }
+    }
+    else
+    {
+        // TradeGood filters
+
+        // Disable Trade Goods below level X
+        if (DisableTGsBelowLevel && itemTemplate.ItemLevel < DisableTGsBelowLevel)
+        {
+            LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Trade Good {} disabled (Trade Good Level = {})", itemTemplate.ItemId, itemTemplate.ItemLevel);
+            return AHB_FILTER_RULE_TGS_BELOW_LEVEL;
+        }
+
+        // Disable Trade Goods above level X
+        if (DisableTGsAboveLevel && itemTemplate.ItemLevel > DisableTGsAboveLevel)
+        {
+            LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Trade Good {} disabled (Trade Good Level = {})", itemTemplate.ItemId, itemTemplate.ItemLevel);
+            return AHB_FILTER_RULE_TGS_ABOVE_LEVEL;
+        }
+
+        // Disable Trade Goods below GUID X
+        if (DisableTGsBelowGUID && itemTemplate.ItemId < DisableTGsBelowGUID)
+        {
+            LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (Trade Good Level = {})", itemTemplate.ItemId, itemTemplate.ItemLevel);
+            return AHB_FILTER_RULE_TGS_BELOW_GUID;
+        }
+
+        // Disable Trade Goods above GUID X
+        if (DisableTGsAboveGUID && itemTemplate.ItemId > DisableTGsAboveGUID)
+        {
+            LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (Trade Good Level = {})", itemTemplate.ItemId, itemTemplate.ItemLevel);
+            return AHB_FILTER_RULE_TGS_ABOVE_GUID;
+        }
+    }
+
+    // Disable Items for level lower than X
+    if (DisableItemsBelowReqLevel && itemTemplate.RequiredLevel < DisableItemsBelowReqLevel)
+    {
+        LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (RequiredLevel = {})", itemTemplate.ItemId, itemTemplate.RequiredLevel);
+        return AHB_FILTER_RULE_ITEMS_BELOW_REQ_LEVEL;
+    }
+
+    // Disable Items for level higher than X
+    if (DisableItemsAboveReqLevel && itemTemplate.RequiredLevel > DisableItemsAboveReqLevel)
+    {
+        LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (RequiredLevel = {})", itemTemplate.ItemId, itemTemplate.RequiredLevel);
+        return AHB_FILTER_RULE_ITEMS_ABOVE_REQ_LEVEL;
+    }
+
+    // Disable Trade Goods for level lower than X
+    if (DisableTGsBelowReqLevel && itemTemplate.RequiredLevel < DisableTGsBelowReqLevel)
+    {
+        LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Trade Good {} disabled (RequiredLevel = {})", itemTemplate.ItemId, itemTemplate.RequiredLevel);
+        return AHB_FILTER_RULE_TGS_BELOW_REQ_LEVEL;
+    }
+
+    // Disable Trade Goods for level higher than X
+    if (DisableTGsAboveReqLevel && itemTemplate.RequiredLevel > DisableTGsAboveReqLevel)
+    {
+        LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Trade Good {} disabled (RequiredLevel = {})", itemTemplate.ItemId, itemTemplate.RequiredLevel);
+        return AHB_FILTER_RULE_TGS_ABOVE_REQ_LEVEL;
+    }
+
+    // Disable Items that require skill lower than X
+    if (DisableItemsBelowReqSkillRank && itemTemplate.RequiredSkillRank < DisableItemsBelowReqSkillRank)
+    {
+        LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (RequiredSkillRank = {})", itemTemplate.ItemId, itemTemplate.RequiredSkillRank);
+        return AHB_FILTER_RULE_ITEMS_BELOW_REQ_SKILL_RANK;
+    }
+
+    // Disable Items that require skill higher than X
+    if (DisableItemsAboveReqSkillRank && itemTemplate.RequiredSkillRank > DisableItemsAboveReqSkillRank)
+    {
+        LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (RequiredSkillRank = {})", itemTemplate.ItemId, itemTemplate.RequiredSkillRank);
+        return AHB_FILTER_RULE_ITEMS_ABOVE_REQ_SKILL_RANK;
+    }
+
+    // Disable Trade Goods that require skill lower than X
+    if (DisableTGsBelowReqSkillRank && itemTemplate.RequiredSkillRank < DisableTGsBelowReqSkillRank)
+    {
+        LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (RequiredSkillRank = {})", itemTemplate.ItemId, itemTemplate.RequiredSkillRank);
+        return AHB_FILTER_RULE_TGS_BELOW_REQ_SKILL_RANK;
+    }
+
+    // Disable Trade Goods that require skill higher than X
+    if (DisableTGsAboveReqSkillRank && itemTemplate.RequiredSkillRank > DisableTGsAboveReqSkillRank)
+    {
+        LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (RequiredSkillRank = {})", itemTemplate.ItemId, itemTemplate.RequiredSkillRank);
+        return AHB_FILTER_RULE_TGS_ABOVE_REQ_SKILL_RANK;
+    }
+
+    return AHB_FILTER_ACCEPTED;
+}
@@ -0,0 +1,94 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AHB_ITEM_FILTER_H
+#define AHB_ITEM_FILTER_H
+
+#include "ItemIndex.h"
+#include <bitset>
+#include <unordered_map>
+#include <unordered_set>
+
+struct ItemTemplate;
+
+// Decides which item templates the seller may list. Only the rules, the settings and item lists
+// are filled in by the index (from the config and the world database) before it is used.
+struct ItemFilter
+{
+    bool SellMethod{ false };
+
+    bool Vendor_Items{ false };
+    bool Loot_Items{ false };
+    bool Other_Items{ false };
+    bool Vendor_TGs{ false };
+    bool Loot_TGs{ false };
+    bool Other_TGs{ false };
+
+    bool No_Bind{ false };
+    bool Bind_When_Picked_Up{ false };
+    bool Bind_When_Equipped{ false };
+    bool Bind_When_Use{ false };
+    bool Bind_Quest_Item{ false };
+
+    bool DisablePermEnchant{ false };
+    bool DisableConjured{ false };
+    bool DisableGems{ false };
+    bool DisableMoney{ false };
+    bool DisableMoneyLoot{ false };
+    bool DisableLootable{ false };;
+    bool DisableKeys{ false };
+    bool DisableDuration{ false };
+    bool DisableBOP_Or_Quest_NoReqLevel{ false };
+
+    std::bitset<32> DisableClassItemsMask;
+
+    uint32 DisableItemsBelowLevel{ 0 };
+    uint32 DisableItemsAboveLevel{ 0 };
+    uint32 DisableTGsBelowLevel{ 0 };
+    uint32 DisableTGsAboveLevel{ 0 };
+    uint32 DisableItemsBelowGUID{ 0 };
+    uint32 DisableItemsAboveGUID{ 0 };
+    uint32 DisableTGsBelowGUID{ 0 };
+    uint32 DisableTGsAboveGUID{ 0 };
+    uint32 DisableItemsBelowReqLevel{ 0 };
+    uint32 DisableItemsAboveReqLevel{ 0 };
+    uint32 DisableTGsBelowReqLevel{ 0 };
+    uint32 DisableTGsAboveReqLevel{ 0 };
+    uint32 DisableItemsBelowReqSkillRank{ 0 };
+    uint32 DisableItemsAboveReqSkillRank{ 0 };
+    uint32 DisableTGsBelowReqSkillRank{ 0 };
+    uint32 DisableTGsAboveReqSkillRank{ 0 };
+
+    std::unordered_set<uint32> disabledItems{};
+    std::unordered_set<uint32> npcItems{};
+    std::unordered_set<uint32> lootItems{};
+
+    // Overrides of the index that is being built, which is not necessarily sAHIndex during a reload
+    std::unordered_map<uint32, AHBPriceOverride> const& itemPriceOverride;
+
+    explicit ItemFilter(std::unordered_map<uint32, AHBPriceOverride> const& priceOverrides) : itemPriceOverride(priceOverrides) { }
+
+    // Returns the first rule that rejects the item, rules are checked in the order they are declared in AHBFilterRule
+    AHBFilterRule GetRejectingRule(const ItemTemplate& itemTemplate) const;
+
+    bool IsAccepted(const ItemTemplate& itemTemplate) const
+    {
+        return GetRejectingRule(itemTemplate) == AHB_FILTER_ACCEPTED;
+    }
+};
+
+#endif
@@ -16,7 +16,9 @@
  */
 
 #include "ItemIndex.h"
+#include "ItemFilter.h"
 
+#include <chrono>
 #include <numeric>
 #include <random>
 
@@ -25,531 +27,247 @@
 #include "DatabaseEnv.h"
 #include "Log.h"
 #include "ObjectMgr.h"
-#include "SmartEnum.h"
+#include "Profiler.h"
+#include "Statements.h"
+#include "StringFormat.h"
 
-void AuctionHouseIndex::Initialize()
+namespace
 {
-    // Load price overrides
-    itemPriceOverride.clear(); // in case of reload
+    // Measures the time until it goes out of scope
+    class PhaseTimer
     {
-        QueryResult results = WorldDatabase.Query("SELECT item, avgPrice, minPrice FROM mod_auctionhousebot_priceOverride");
+    public:
+        PhaseTimer(Microseconds& target) : _target(target), _start(std::chrono::steady_clock::now()) { }
+        ~PhaseTimer() { _target = std::chrono::duration_cast<Microseconds>(std::chrono::steady_clock::now() - _start); }
 
-        if (results)
-        {
-            do
-            {
-                const Field* fields = results->Fetch();
-                itemPriceOverride.emplace(fields[0].Get<uint32>(), std::pair{ fields[1].Get<uint32>() , fields[2].Get<uint32>() });
-            } while (results->NextRow());
-        }
-    }
-}
+    private:
+        Microseconds& _target;
+        std::chrono::steady_clock::time_point _start;
+    };
 
-struct ItemFilter
-{
-    bool SellMethod{ false };
-
-    bool Vendor_Items{ false };
-    bool Loot_Items{ false };
-    bool Other_Items{ false };
-    bool Vendor_TGs{ false };
-    bool Loot_TGs{ false };
-    bool Other_TGs{ false };
-
-    bool No_Bind{ false };
-    bool Bind_When_Picked_Up{ false };
-    bool Bind_When_Equipped{ false };
-    bool Bind_When_Use{ false };
-    bool Bind_Quest_Item{ false };
-
-    bool DisablePermEnchant{ false };
-    bool DisableConjured{ false };
-    bool DisableGems{ false };
-    bool DisableMoney{ false };
-    bool DisableMoneyLoot{ false };
-    bool DisableLootable{ false };;
-    bool DisableKeys{ false };
-    bool DisableDuration{ false };
-    bool DisableBOP_Or_Quest_NoReqLevel{ false };
-
-    std::bitset<32> DisableClassItemsMask;
-
-    uint32 DisableItemsBelowLevel{ 0 };
-    uint32 DisableItemsAboveLevel{ 0 };
-    uint32 DisableTGsBelowLevel{ 0 };
-    uint32 DisableTGsAboveLevel{ 0 };
-    uint32 DisableItemsBelowGUID{ 0 };
-    uint32 DisableItemsAboveGUID{ 0 };
-    uint32 DisableTGsBelowGUID{ 0 };
-    uint32 DisableTGsAboveGUID{ 0 };
-    uint32 DisableItemsBelowReqLevel{ 0 };
-    uint32 DisableItemsAboveReqLevel{ 0 };
-    uint32 DisableTGsBelowReqLevel{ 0 };
-    uint32 DisableTGsAboveReqLevel{ 0 };
-    uint32 DisableItemsBelowReqSkillRank{ 0 };
-    uint32 DisableItemsAboveReqSkillRank{ 0 };
-    uint32 DisableTGsBelowReqSkillRank{ 0 };
-    uint32 DisableTGsAboveReqSkillRank{ 0 };
-
-    std::unordered_set<uint32> disabledItems{};
-    std::unordered_set<uint32> npcItems{};
-    std::unordered_set<uint32> lootItems{};
-
-    ItemFilter()
+    // Item lists from the world database and the filter settings from the config
+    void LoadItemFilter(ItemFilter& filter, AHBFilterStats& stats)
     {
-        QueryResult results = WorldDatabase.Query("SELECT item FROM mod_auctionhousebot_disabled_items");
+        QueryResult results;
 
-        if (results)
         {
-            do
+            PhaseTimer timer(stats.phaseTime[AHB_INDEX_PHASE_DISABLED_ITEMS]);
+            results = sAHStatements->Query(AHB_WORLD_SEL_DISABLED_ITEMS);
+
+            if (results)
             {
-                const Field* fields = results->Fetch();
-                disabledItems.emplace(fields[0].Get<uint32>());
-            } while (results->NextRow());
+                do
+                {
+                    const Field* fields = results->Fetch();
+                    filter.disabledItems.emplace(fields[0].Get<uint32>());
+                } while (results->NextRow());
+            }
         }
 
-        std::string npcQuery = "SELECT distinct item FROM npc_vendor";
-        results = WorldDatabase.Query(npcQuery);
-        if (results)
         {
-            do
+            PhaseTimer timer(stats.phaseTime[AHB_INDEX_PHASE_VENDOR_ITEMS]);
+            results = sAHStatements->Query(AHB_WORLD_SEL_VENDOR_ITEMS);
+            if (results)
             {
-                const Field* fields = results->Fetch();
-                npcItems.emplace(fields[0].Get<int32>());
-            } while (results->NextRow());
+                do
+                {
+                    const Field* fields = results->Fetch();
+                    filter.npcItems.emplace(fields[0].Get<int32>());
+                } while (results->NextRow());
+            }
+            else
+                LOG_ERROR("module.ahbot", "AuctionHouseBot: \"{}\" failed", AHBStatements::GetSql(AHB_WORLD_SEL_VENDOR_ITEMS));
         }
-        else
-            LOG_ERROR("module.ahbot", "AuctionHouseBot: \"{}\" failed", npcQuery);
-
-        std::string lootQuery = "SELECT item FROM creature_loot_template UNION "
-            "SELECT item FROM reference_loot_template UNION "
-            "SELECT item FROM disenchant_loot_template UNION "
-            "SELECT item FROM fishing_loot_template UNION "
-            "SELECT item FROM gameobject_loot_template UNION "
-            "SELECT item FROM item_loot_template UNION "
-            "SELECT item FROM milling_loot_template UNION "
-            "SELECT item FROM pickpocketing_loot_template UNION "
-            "SELECT item FROM prospecting_loot_template UNION "
-            "SELECT item FROM skinning_loot_template";
-
-        results = WorldDatabase.Query(lootQuery);
-        if (results)
+
         {
-            do
+            PhaseTimer timer(stats.phaseTime[AHB_INDEX_PHASE_LOOT_ITEMS]);
+            results = sAHStatements->Query(AHB_WORLD_SEL_LOOT_ITEMS);
+            if (results)
             {
-                const Field* fields = results->Fetch();
-                lootItems.emplace(fields[0].Get<uint32>());
-            } while (results->NextRow());
+                do
+                {
+                    const Field* fields = results->Fetch();
+                    filter.lootItems.emplace(fields[0].Get<uint32>());
+                } while (results->NextRow());
+            }
+            else
+                LOG_ERROR("module.ahbot", "AuctionHouseBot: \"{}\" failed", AHBStatements::GetSql(AHB_WORLD_SEL_LOOT_ITEMS));
         }
-        else
-            LOG_ERROR("module.ahbot", "AuctionHouseBot: \"{}\" failed", lootQuery);
-
 
-
-        SellMethod = sConfigMgr->GetOption<bool>("AuctionHouseBot.UseBuyPriceForSeller", false);
+        filter.SellMethod = sConfigMgr->GetOption<bool>("AuctionHouseBot.UseBuyPriceForSeller", false);
 
         // Begin Filters
 
-        Vendor_Items = sConfigMgr->GetOption<bool>("AuctionHouseBot.VendorItems", false);
-        Loot_Items = sConfigMgr->GetOption<bool>("AuctionHouseBot.LootItems", true);
-        Other_Items = sConfigMgr->GetOption<bool>("AuctionHouseBot.OtherItems", false);
-        Vendor_TGs = sConfigMgr->GetOption<bool>("AuctionHouseBot.VendorTradeGoods", false);
-        Loot_TGs = sConfigMgr->GetOption<bool>("AuctionHouseBot.LootTradeGoods", true);
-        Other_TGs = sConfigMgr->GetOption<bool>("AuctionHouseBot.OtherTradeGoods", false);
-
-        No_Bind = sConfigMgr->GetOption<bool>("AuctionHouseBot.No_Bind", true);
-        Bind_When_Picked_Up = sConfigMgr->GetOption<bool>("AuctionHouseBot.Bind_When_Picked_Up", false);
-        Bind_When_Equipped = sConfigMgr->GetOption<bool>("AuctionHouseBot.Bind_When_Equipped", true);
-        Bind_When_Use = sConfigMgr->GetOption<bool>("AuctionHouseBot.Bind_When_Use", true);
-        Bind_Quest_Item = sConfigMgr->GetOption<bool>("AuctionHouseBot.Bind_Quest_Item", false);
-
-        DisablePermEnchant = sConfigMgr->GetOption<bool>("AuctionHouseBot.DisablePermEnchant", false);
-        DisableConjured = sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableConjured", false);
-        DisableGems = sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableGems", false);
-        DisableMoney = sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableMoney", false);
-        DisableMoneyLoot = sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableMoneyLoot", false);
-        DisableLootable = sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableLootable", false);
-        DisableKeys = sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableKeys", false);
-        DisableDuration = sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableDuration", false);
-        DisableBOP_Or_Quest_NoReqLevel = sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableBOP_Or_Quest_NoReqLevel", false);
+        filter.Vendor_Items = sConfigMgr->GetOption<bool>("AuctionHouseBot.VendorItems", false);
+        filter.Loot_Items = sConfigMgr->GetOption<bool>("AuctionHouseBot.LootItems", true);
+        filter.Other_Items = sConfigMgr->GetOption<bool>("AuctionHouseBot.OtherItems", false);
+        filter.Vendor_TGs = sConfigMgr->GetOption<bool>("AuctionHouseBot.VendorTradeGoods", false);
+        filter.Loot_TGs = sConfigMgr->GetOption<bool>("AuctionHouseBot.LootTradeGoods", true);
+        filter.Other_TGs = sConfigMgr->GetOption<bool>("AuctionHouseBot.OtherTradeGoods", false);
+
+        filter.No_Bind = sConfigMgr->GetOption<bool>("AuctionHouseBot.No_Bind", true);
+        filter.Bind_When_Picked_Up = sConfigMgr->GetOption<bool>("AuctionHouseBot.Bind_When_Picked_Up", false);
+        filter.Bind_When_Equipped = sConfigMgr->GetOption<bool>("AuctionHouseBot.Bind_When_Equipped", true);
+        filter.Bind_When_Use = sConfigMgr->GetOption<bool>("AuctionHouseBot.Bind_When_Use", true);
+        filter.Bind_Quest_Item = sConfigMgr->GetOption<bool>("AuctionHouseBot.Bind_Quest_Item", false);
+
+        filter.DisablePermEnchant = sConfigMgr->GetOption<bool>("AuctionHouseBot.DisablePermEnchant", false);
+        filter.DisableConjured = sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableConjured", false);
+        filter.DisableGems = sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableGems", false);
+        filter.DisableMoney = sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableMoney", false);
+        filter.DisableMoneyLoot = sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableMoneyLoot", false);
+        filter.DisableLootable = sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableLootable", false);
+        filter.DisableKeys = sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableKeys", false);
+        filter.DisableDuration = sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableDuration", false);
+        filter.DisableBOP_Or_Quest_NoReqLevel = sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableBOP_Or_Quest_NoReqLevel", false);
 
         // Classes are 1 based index, to get their flag bit we need zero based, so -1
-        DisableClassItemsMask.set(Classes::CLASS_WARRIOR - 1, sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableWarriorItems", false));
-        DisableClassItemsMask.set(Classes::CLASS_PALADIN - 1, sConfigMgr->GetOption<bool>("AuctionHouseBot.DisablePaladinItems", false));
-        DisableClassItemsMask.set(Classes::CLASS_HUNTER - 1, sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableHunterItems", false));
-        DisableClassItemsMask.set(Classes::CLASS_ROGUE - 1, sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableRogueItems", false));
-        DisableClassItemsMask.set(Classes::CLASS_PRIEST - 1, sConfigMgr->GetOption<bool>("AuctionHouseBot.DisablePriestItems", false));
-        DisableClassItemsMask.set(Classes::CLASS_DEATH_KNIGHT - 1, sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableDKItems", false));
-        DisableClassItemsMask.set(Classes::CLASS_SHAMAN - 1, sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableShamanItems", false));
-        DisableClassItemsMask.set(Classes::CLASS_MAGE - 1, sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableMageItems", false));
-        DisableClassItemsMask.set(Classes::CLASS_WARLOCK - 1, sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableWarlockItems", false));
-        DisableClassItemsMask.set(10 - 1, sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableUnusedClassItems", false));
-        DisableClassItemsMask.set(Classes::CLASS_DRUID - 1, sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableDruidItems", false));
-        DisableClassItemsMask.set(Classes::CLASS_WARRIOR - 1, sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableWarriorItems", false));
-
-        DisableItemsBelowLevel = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsBelowLevel", 0);
-        DisableItemsAboveLevel = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsAboveLevel", 0);
-        DisableTGsBelowLevel = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsBelowLevel", 0);
-        DisableTGsAboveLevel = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsAboveLevel", 0);
-        DisableItemsBelowGUID = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsBelowGUID", 0);
-        DisableItemsAboveGUID = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsAboveGUID", 0);
-        DisableTGsBelowGUID = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsBelowGUID", 0);
-        DisableTGsAboveGUID = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsAboveGUID", 0);
-        DisableItemsBelowReqLevel = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsBelowReqLevel", 0);
-        DisableItemsAboveReqLevel = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsAboveReqLevel", 0);
-        DisableTGsBelowReqLevel = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsBelowReqLevel", 0);
-        DisableTGsAboveReqLevel = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsAboveReqLevel", 0);
-        DisableItemsBelowReqSkillRank = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsBelowReqSkillRank", 0);
-        DisableItemsAboveReqSkillRank = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsAboveReqSkillRank", 0);
-        DisableTGsBelowReqSkillRank = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsBelowReqSkillRank", 0);
-        DisableTGsAboveReqSkillRank = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsAboveReqSkillRank", 0);
+        filter.DisableClassItemsMask.set(Classes::CLASS_WARRIOR - 1, sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableWarriorItems", false));
+        filter.DisableClassItemsMask.set(Classes::CLASS_PALADIN - 1, sConfigMgr->GetOption<bool>("AuctionHouseBot.DisablePaladinItems", false));
+        filter.DisableClassItemsMask.set(Classes::CLASS_HUNTER - 1, sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableHunterItems", false));
+        filter.DisableClassItemsMask.set(Classes::CLASS_ROGUE - 1, sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableRogueItems", false));
+        filter.DisableClassItemsMask.set(Classes::CLASS_PRIEST - 1, sConfigMgr->GetOption<bool>("AuctionHouseBot.DisablePriestItems", false));
+        filter.DisableClassItemsMask.set(Classes::CLASS_DEATH_KNIGHT - 1, sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableDKItems", false));
+        filter.DisableClassItemsMask.set(Classes::CLASS_SHAMAN - 1, sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableShamanItems", false));
+        filter.DisableClassItemsMask.set(Classes::CLASS_MAGE - 1, sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableMageItems", false));
+        filter.DisableClassItemsMask.set(Classes::CLASS_WARLOCK - 1, sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableWarlockItems", false));
+        filter.DisableClassItemsMask.set(10 - 1, sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableUnusedClassItems", false));
+        filter.DisableClassItemsMask.set(Classes::CLASS_DRUID - 1, sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableDruidItems", false));
+        filter.DisableClassItemsMask.set(Classes::CLASS_WARRIOR - 1, sConfigMgr->GetOption<bool>("AuctionHouseBot.DisableWarriorItems", false));
+
+        filter.DisableItemsBelowLevel = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsBelowLevel", 0);
+        filter.DisableItemsAboveLevel = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsAboveLevel", 0);
+        filter.DisableTGsBelowLevel = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsBelowLevel", 0);
+        filter.DisableTGsAboveLevel = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsAboveLevel", 0);
+        filter.DisableItemsBelowGUID = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsBelowGUID", 0);
+        filter.DisableItemsAboveGUID = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsAboveGUID", 0);
+        filter.DisableTGsBelowGUID = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsBelowGUID", 0);
+        filter.DisableTGsAboveGUID = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsAboveGUID", 0);
+        filter.DisableItemsBelowReqLevel = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsBelowReqLevel", 0);
+        filter.DisableItemsAboveReqLevel = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsAboveReqLevel", 0);
+        filter.DisableTGsBelowReqLevel = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsBelowReqLevel", 0);
+        filter.DisableTGsAboveReqLevel = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsAboveReqLevel", 0);
+        filter.DisableItemsBelowReqSkillRank = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsBelowReqSkillRank", 0);
+        filter.DisableItemsAboveReqSkillRank = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableItemsAboveReqSkillRank", 0);
+        filter.DisableTGsBelowReqSkillRank = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsBelowReqSkillRank", 0);
+        filter.DisableTGsAboveReqSkillRank = sConfigMgr->GetOption<uint32>("AuctionHouseBot.DisableTGsAboveReqSkillRank", 0);
     }
+}
 
-    bool IsAccepted(const ItemTemplate& itemTemplate) const
+std::vector<std::string> AHBFilterStats::Format() const
+{
+    // Named after the config options (or table) that control the rule
+    static constexpr std::array<char const*, AHB_FILTER_RULE_MAX> ruleNames =
     {
-        switch (itemTemplate.Bonding)
-        {
-        case NO_BIND:
-            if (!No_Bind)
-                return false;
-            break;
-        case BIND_WHEN_PICKED_UP:
-            if (!Bind_When_Picked_Up)
-                return false;
-            break;
-        case BIND_WHEN_EQUIPED:
-            if (!Bind_When_Equipped)
-                return false;
-            break;
-        case BIND_WHEN_USE:
-            if (!Bind_When_Use)
-                return false;
-            break;
-        case BIND_QUEST_ITEM:
-            if (!Bind_Quest_Item)
-                return false;
-            break;
-        default:
-            return false;
-        }
-
-        uint32 basePrice = SellMethod ? itemTemplate.BuyPrice : itemTemplate.SellPrice;
-
-        {
-            auto& itemPriceOverride = sAHIndex->GetPriceOverrides();
-            const auto foundOverride = itemPriceOverride.find(itemTemplate.ItemId);
-
-            if (foundOverride != itemPriceOverride.end())
-            {
-                auto [meanPrice, minPrice] = foundOverride->second;
-                basePrice = meanPrice;
-            }
-        }
-
-        // has no price
-        if (!basePrice)
-        {
-            LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} has no price", itemTemplate.ItemId);
-            return false;
-        }
+        "(accepted)", "Bonding types", "No price", "Quality above artifact",
+        "VendorItems", "LootItems", "OtherItems", "VendorTradeGoods", "LootTradeGoods", "OtherTradeGoods",
+        "mod_auctionhousebot_disabled_items", "DisablePermEnchant", "DisableConjured", "DisableGems", "DisableMoney", "DisableMoneyLoot",
+        "DisableLootable", "DisableKeys", "DisableDuration", "DisableBOP_Or_Quest_NoReqLevel", "Disable<Class>Items",
+        "DisableItemsBelowLevel", "DisableItemsAboveLevel", "DisableItemsBelowGUID", "DisableItemsAboveGUID",
+        "DisableTGsBelowLevel", "DisableTGsAboveLevel", "DisableTGsBelowGUID", "DisableTGsAboveGUID",
+        "DisableItemsBelowReqLevel", "DisableItemsAboveReqLevel", "DisableTGsBelowReqLevel", "DisableTGsAboveReqLevel",
+        "DisableItemsBelowReqSkillRank", "DisableItemsAboveReqSkillRank", "DisableTGsBelowReqSkillRank", "DisableTGsAboveReqSkillRank"
+    };
+
+    static constexpr std::array<char const*, AHB_INDEX_PHASE_MAX> phaseNames =
+    {
+        "load disabled items", "load vendor items", "load loot items", "filter item templates", "level brackets", "item weights"
+    };
 
-        if (itemTemplate.Quality > ITEM_QUALITY_ARTIFACT)
-            return false;
+    std::vector<std::string> lines;
+    lines.push_back(Acore::StringFormatFmt("AuctionHouseBot filters: {} item templates, {} accepted", scanned, accepted));
+    lines.push_back(Acore::StringFormatFmt("  {:<36} {:>8}", "Rule", "Rejected"));
 
-        auto isVendorItem = [this](const ItemTemplate& itemTemplate)
-            {
-                return npcItems.contains(itemTemplate.ItemId);
-            };
+    for (uint32 rule = AHB_FILTER_ACCEPTED + 1; rule < AHB_FILTER_RULE_MAX; ++rule)
+        if (rejected[rule])
+            lines.push_back(Acore::StringFormatFmt("  {:<36} {:>8}", ruleNames[rule], rejected[rule]));
 
-        auto isLootItem = [this](const ItemTemplate& itemTemplate)
-            {
-                return lootItems.contains(itemTemplate.ItemId);
-            };
+    lines.push_back(Acore::StringFormatFmt("  {:<36} {:>8}", "Phase", "ms"));
 
-        if (itemTemplate.Class != ITEM_CLASS_TRADE_GOODS)
-        {
-            // Item checks
+    for (uint32 phase = 0; phase < AHB_INDEX_PHASE_MAX; ++phase)
+        lines.push_back(Acore::StringFormatFmt("  {:<36} {:>8.1f}", phaseNames[phase], phaseTime[phase].count() / 1000.0));
 
-            if (!Vendor_Items)
-            {
-                if (isVendorItem(itemTemplate))
-                    return false;
-            }
+    return lines;
+}
 
-            if (!Loot_Items)
-            {
-                if (isLootItem(itemTemplate))
-                    return false;
-            }
+void AuctionHouseIndex::Initialize()
+{
+    // Load price overrides
+    itemPriceOverride.clear(); // in case of reload
+    {
+        QueryResult results = sAHStatements->Query(AHB_WORLD_SEL_PRICE_OVERRIDES);
 
-            if (!Other_Items)
-            {
-                if (!isLootItem(itemTemplate) && !isVendorItem(itemTemplate))
-                    return false;
-            }
-        }
-        else if (itemTemplate.Class == ITEM_CLASS_TRADE_GOODS)
+        if (results)
         {
-            // Tradegood checks
-
-            if (!Vendor_TGs)
-            {
-                if (isVendorItem(itemTemplate))
-                    return false;
-            }
-
-            if (!Loot_TGs)
-            {
-                if (isLootItem(itemTemplate))
-                    return false;
-            }
-
-            if (!Other_TGs)
+            do
             {
-                if (!isLootItem(itemTemplate) && !isVendorItem(itemTemplate))
-                    return false;
-            }
-        }
-
-
-        // Disable items by Id
-        if (disabledItems.contains(itemTemplate.ItemId))
-        {
-            LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (PTR/Beta/Unused Item)", itemTemplate.ItemId);
-            return false;
-        }
-
-        // Disable permanent enchants items
-        if (DisablePermEnchant && itemTemplate.Class == ITEM_CLASS_PERMANENT)
-        {
-            LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (Permanent Enchant Item)", itemTemplate.ItemId);
-            return false;
-        }
+                const Field* fields = results->Fetch();
+                const uint32 itemId = fields[0].Get<uint32>();
+                const uint32 meanPrice = fields[1].Get<uint32>();
+                const uint32 minPrice = fields[2].Get<uint32>();
 
-        // Disable conjured items
-        if (DisableConjured && itemTemplate.IsConjuredConsumable())
-        {
-            LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (Conjured Consumable)", itemTemplate.ItemId);
-            return false;
-        }
+                if (minPrice > meanPrice)
+                    LOG_WARN("module.ahbot", "Price override has higher min price than mean for item {}", itemId);
 
-        // Disable gems
-        if (DisableGems && itemTemplate.Class == ITEM_CLASS_GEM)
-        {
-            LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (Gem)", itemTemplate.ItemId);
-            return false;
+                itemPriceOverride.emplace(itemId, AHBPriceOverride::Make(meanPrice, minPrice));
+            } while (results->NextRow());
         }
+    }
+}
 
-        // Disable money
-        if (DisableMoney && itemTemplate.Class == ITEM_CLASS_MONEY)
-        {
-            LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (Money)", itemTemplate.ItemId);
-            return false;
-        }
+bool AuctionHouseIndex::InitializeItemsToSell()
+{
+    AHB_PROFILE_SCOPE("InitializeItemsToSell");
 
-        // Disable moneyloot
-        if (DisableMoneyLoot && itemTemplate.MinMoneyLoot)
-        {
-            LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (MoneyLoot)", itemTemplate.ItemId);
-            return false;
-        }
+    _filterStats = {};
+    ItemFilter filter(itemPriceOverride);
+    LoadItemFilter(filter, _filterStats);
 
-        // Disable lootable items
-        if (DisableLootable && itemTemplate.Flags & 4)
-        {
-            LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (Lootable Item)", itemTemplate.ItemId);
-            return false;
-        }
+    // in case of reload
+    for (auto& it : _itemsBin)
+        it.clear();
 
-        // Disable Keys
-        if (DisableKeys && itemTemplate.Class == ITEM_CLASS_KEY)
-        {
-            LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (Quest Item)", itemTemplate.ItemId);
-            return false;
-        }
+    std::array<std::array<std::vector<uint32>, AHB_LEVEL_BRACKETS>, AHB_MAX_QUALITY> bracketBins;
 
-        // Disable items with duration
-        if (DisableDuration && itemTemplate.Duration)
-        {
-            LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (Has a Duration)", itemTemplate.ItemId);
-            return false;
-        }
+    {
+        PhaseTimer timer(_filterStats.phaseTime[AHB_INDEX_PHASE_FILTER_TEMPLATES]);
 
-        // Disable items which are BOP or Quest Items and have a required level lower than the item level
-        if (DisableBOP_Or_Quest_NoReqLevel && ((itemTemplate.Bonding == BIND_WHEN_PICKED_UP || itemTemplate.Bonding == BIND_QUEST_ITEM) && (itemTemplate.RequiredLevel < itemTemplate.ItemLevel)))
+        for (auto const& [itemID, itemTemplate] : *sObjectMgr->GetItemTemplateStore())
         {
-            LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (BOP or BQI and Required Level is less than Item Level)", itemTemplate.ItemId);
-            return false;
-        }
+            WPAssert(itemTemplate.ItemId, "ItemID cannot be zero");
 
+            ++_filterStats.scanned;
 
-        // We have disabled some class-specific items, lets see if this is one of them
-        if (DisableClassItemsMask.any())
-        {
-            const std::bitset<32> allowableClass(itemTemplate.AllowableClass);
+            const AHBFilterRule rule = filter.GetRejectingRule(itemTemplate);
+            ++_filterStats.rejected[rule];
 
-            // If this item is specific for just one class (as opposed to multiple classes), then check if its a class that we have disabled
-            if (allowableClass.count() == 1)
-            {
-                if ((DisableClassItemsMask & allowableClass).any())
-                {
-                    // slightly ugly, find index of first bit that is set, to find out which class this is
+            if (rule != AHB_FILTER_ACCEPTED)
+                continue;
 
-                    Classes itemAllowClass = Classes::CLASS_NONE;
-                    for (uint8 classBit = 0; classBit < MAX_CLASSES; ++classBit)
-                        if (allowableClass.test(classBit))
-                            itemAllowClass = static_cast<Classes>(classBit + 1); // Zero based index back to 1 based
+            // Trade goods and most consumables have no required level, their item level is close to the level they are used at
+            const uint32 level = itemTemplate.RequiredLevel ? itemTemplate.RequiredLevel : itemTemplate.ItemLevel;
 
-                    LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled ({} Item)", itemTemplate.ItemId, Acore::Impl::EnumUtilsImpl::EnumUtils<Classes>::ToString(itemAllowClass).Title);
-                    return false;
-                }
-            }
+            const uint32 itemQualityIndexStart = itemTemplate.Class == ITEM_CLASS_TRADE_GOODS ? 0 : AHB_DEFAULT_QUALITY_SIZE;
+            bracketBins[itemQualityIndexStart + itemTemplate.Quality][GetAHBLevelBracket(level)].emplace_back(itemTemplate.ItemId);
         }
 
-        if (itemTemplate.Class != ITEM_CLASS_TRADE_GOODS)
-        {
-            // Item filters
-
-            // Disable Items below level X
-            if (DisableItemsBelowLevel && itemTemplate.ItemLevel < DisableItemsBelowLevel)
-            {
-                LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (Item Level = {})", itemTemplate.ItemId, itemTemplate.ItemLevel);
-                return false;
-            }
-
-            // Disable Items above level X
-            if (DisableItemsAboveLevel && itemTemplate.ItemLevel > DisableItemsAboveLevel)
-            {
-                LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (Item Level = {})", itemTemplate.ItemId, itemTemplate.ItemLevel);
-                return false;
-            }
+        _filterStats.accepted = _filterStats.rejected[AHB_FILTER_ACCEPTED];
+    }
 
-            // Disable Items below GUID X
-            if (DisableItemsBelowGUID && itemTemplate.ItemId < DisableItemsBelowGUID)
-            {
-                LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (Item Level = {})", itemTemplate.ItemId, itemTemplate.ItemLevel);
-                return false;
-            }
+    {
+        PhaseTimer timer(_filterStats.phaseTime[AHB_INDEX_PHASE_LEVEL_BRACKETS]);
 
-            // Disable Items above GUID X
-            if (DisableItemsAboveGUID && itemTemplate.ItemId > DisableItemsAboveGUID)
-            {
-                LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (Item Level = {})", itemTemplate.ItemId, itemTemplate.ItemLevel);
-                return false;
-            }
-        }
-        else
+        // Concatenate the brackets, so every bracket is a contiguous range of its bin
+        for (uint32 i = 0; i < AHB_MAX_QUALITY; ++i)
         {
-            // TradeGood filters
-
-            // Disable Trade Goods below level X
-            if (DisableTGsBelowLevel && itemTemplate.ItemLevel < DisableTGsBelowLevel)
-            {
-                LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Trade Good {} disabled (Trade Good Level = {})", itemTemplate.ItemId, itemTemplate.ItemLevel);
-                return false;
-            }
-
-            // Disable Trade Goods above level X
-            if (DisableTGsAboveLevel && itemTemplate.ItemLevel > DisableTGsAboveLevel)
-            {
-                LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Trade Good {} disabled (Trade Good Level = {})", itemTemplate.ItemId, itemTemplate.ItemLevel);
-                return false;
-            }
-
-            // Disable Trade Goods below GUID X
-            if (DisableTGsBelowGUID && itemTemplate.ItemId < DisableTGsBelowGUID)
+            for (uint32 bracket = 0; bracket < AHB_LEVEL_BRACKETS; ++bracket)
             {
-                LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (Trade Good Level = {})", itemTemplate.ItemId, itemTemplate.ItemLevel);
-                return false;
+                _bracketStart[i][bracket] = _itemsBin[i].size();
+                _itemsBin[i].insert(_itemsBin[i].end(), bracketBins[i][bracket].begin(), bracketBins[i][bracket].end());
             }
 
-            // Disable Trade Goods above GUID X
-            if (DisableTGsAboveGUID && itemTemplate.ItemId > DisableTGsAboveGUID)
-            {
-                LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (Trade Good Level = {})", itemTemplate.ItemId, itemTemplate.ItemLevel);
-                return false;
-            }
+            _bracketStart[i][AHB_LEVEL_BRACKETS] = _itemsBin[i].size();
         }
-
-        // Disable Items for level lower than X
-        if (DisableItemsBelowReqLevel && itemTemplate.RequiredLevel < DisableItemsBelowReqLevel)
-        {
-            LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (RequiredLevel = {})", itemTemplate.ItemId, itemTemplate.RequiredLevel);
-            return false;
-        }
-
-        // Disable Items for level higher than X
-        if (DisableItemsAboveReqLevel && itemTemplate.RequiredLevel > DisableItemsAboveReqLevel)
-        {
-            LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (RequiredLevel = {})", itemTemplate.ItemId, itemTemplate.RequiredLevel);
-            return false;
-        }
-
-        // Disable Trade Goods for level lower than X
-        if (DisableTGsBelowReqLevel && itemTemplate.RequiredLevel < DisableTGsBelowReqLevel)
-        {
-            LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Trade Good {} disabled (RequiredLevel = {})", itemTemplate.ItemId, itemTemplate.RequiredLevel);
-            return false;
-        }
-
-        // Disable Trade Goods for level higher than X
-        if (DisableTGsAboveReqLevel && itemTemplate.RequiredLevel > DisableTGsAboveReqLevel)
-        {
-            LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Trade Good {} disabled (RequiredLevel = {})", itemTemplate.ItemId, itemTemplate.RequiredLevel);
-            return false;
-        }
-
-        // Disable Items that require skill lower than X
-        if (DisableItemsBelowReqSkillRank && itemTemplate.RequiredSkillRank < DisableItemsBelowReqSkillRank)
-        {
-            LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (RequiredSkillRank = {})", itemTemplate.ItemId, itemTemplate.RequiredSkillRank);
-            return false;
-        }
-
-        // Disable Items that require skill higher than X
-        if (DisableItemsAboveReqSkillRank && itemTemplate.RequiredSkillRank > DisableItemsAboveReqSkillRank)
-        {
-            LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (RequiredSkillRank = {})", itemTemplate.ItemId, itemTemplate.RequiredSkillRank);
-            return false;
-        }
-
-        // Disable Trade Goods that require skill lower than X
-        if (DisableTGsBelowReqSkillRank && itemTemplate.RequiredSkillRank < DisableTGsBelowReqSkillRank)
-        {
-            LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (RequiredSkillRank = {})", itemTemplate.ItemId, itemTemplate.RequiredSkillRank);
-            return false;
-        }
-
-        // Disable Trade Goods that require skill higher than X
-        if (DisableTGsAboveReqSkillRank && itemTemplate.RequiredSkillRank > DisableTGsAboveReqSkillRank)
-        {
-            LOG_DEBUG("module.ahbot.filters", "AuctionHouseBot: Item {} disabled (RequiredSkillRank = {})", itemTemplate.ItemId, itemTemplate.RequiredSkillRank);
-            return false;
-        }
-
-        return true;
-    }
-};
-
-
-
-bool AuctionHouseIndex::InitializeItemsToSell()
-{
-    const ItemFilter filter;
-
-    // in case of reload
-    for (auto& it : _itemsBin)
-        it.clear();
-
-    for (auto const& [itemID, itemTemplate] : *sObjectMgr->GetItemTemplateStore())
-    {
-        WPAssert(itemTemplate.ItemId, "ItemID cannot be zero");
-
-        if (!filter.IsAccepted(itemTemplate))
-            continue;
-
-        const uint32 itemQualityIndexStart = itemTemplate.Class == ITEM_CLASS_TRADE_GOODS ? 0 : AHB_DEFAULT_QUALITY_SIZE;
-        _itemsBin[itemQualityIndexStart + itemTemplate.Quality].emplace_back(itemTemplate.ItemId);
     }
 
     std::size_t totalItems = std::accumulate(_itemsBin.begin(), _itemsBin.end(), 0u, [](const std::size_t c, const std::vector<uint32>& v) {return c + v.size(); });
@@ -577,6 +295,11 @@ bool AuctionHouseIndex::InitializeItemsToSell()
     LOG_INFO("module.ahbot", "Loaded {} orange items", _itemsBin[AHB_ITEM_QUALITY_LEGENDARY].size());
     LOG_INFO("module.ahbot", "Loaded {} yellow items", _itemsBin[AHB_ITEM_QUALITY_ARTIFACT].size());
 
+    LoadItemWeights();
+
+    for (std::string const& line : FormatStats())
+        LOG_INFO("module.ahbot", "{}", line);
+
     return true;
     /*
      AuctionHouseBot:
@@ -601,25 +324,132 @@ bool AuctionHouseIndex::InitializeItemsToSell()
 
 std::optional<uint32> AuctionHouseIndex::GetOverridenPrice(uint32 itemId, std::mt19937& rng)
 {
-    const auto foundOverride = itemPriceOverride.find(itemId);
+    if (AHBPriceOverride const* priceOverride = GetPriceOverride(itemId))
+        return priceOverride->Sample(rng);
 
-    if (foundOverride != itemPriceOverride.end())
+    return std::nullopt;
+}
+
+std::array<std::pair<uint32, uint32>, AHB_MAX_QUALITY> AuctionHouseIndex::DiffItemBins(AuctionHouseIndex const& other) const
+{
+    std::array<std::pair<uint32, uint32>, AHB_MAX_QUALITY> changes{};
+
+    for (uint32 i = 0; i < AHB_MAX_QUALITY; ++i)
     {
-        auto [meanPrice, minPrice] = foundOverride->second;
+        // Bins are filled in item template store order, that order is not guaranteed between two loads
+        std::vector<uint32> ours = _itemsBin[i];
+        std::vector<uint32> theirs = other._itemsBin[i];
+        std::sort(ours.begin(), ours.end());
+        std::sort(theirs.begin(), theirs.end());
+
+        std::vector<uint32> difference;
+        std::set_difference(ours.begin(), ours.end(), theirs.begin(), theirs.end(), std::back_inserter(difference));
+        changes[i].first = difference.size();
+
+        difference.clear();
+        std::set_difference(theirs.begin(), theirs.end(), ours.begin(), ours.end(), std::back_inserter(difference));
+        changes[i].second = difference.size();
+    }
 
-        if (minPrice > meanPrice)
+    return changes;
+}
+
+void AuctionHouseIndex::LoadItemWeights()
+{
+    PhaseTimer timer(_filterStats.phaseTime[AHB_INDEX_PHASE_ITEM_WEIGHTS]);
+
+    // in case of reload
+    _itemsAlias = {};
+    _bracketWeights = {};
+    _binWeights = {};
+    _samplingStats = {};
+
+    const uint32 mode = sConfigMgr->GetOption<uint32>("AuctionHouseBot.ItemWeights", AHB_ITEM_WEIGHTS_UNIFORM);
+    if (mode != AHB_ITEM_WEIGHTS_TABLE && mode != AHB_ITEM_WEIGHTS_LOOT_CHANCE)
+        return;
+
+    const float defaultWeight = sConfigMgr->GetOption<float>("AuctionHouseBot.ItemWeights.Default", 1.f);
+    std::unordered_map<uint32, float> itemWeights;
+
+    if (mode == AHB_ITEM_WEIGHTS_LOOT_CHANCE)
+    {
+        QueryResult results = sAHStatements->Query(AHB_WORLD_SEL_LOOT_CHANCES);
+
+        if (results)
         {
-            LOG_WARN("module.ahbot", "Price override has higher min price than mean for item {}", itemId);
-            minPrice = meanPrice * 0.8;
+            do
+            {
+                const Field* fields = results->Fetch();
+                const float chance = fields[1].Get<float>();
+
+                // A chance of 0 is an equal share of a loot group, we don't know how large that is
+                if (chance > 0)
+                    itemWeights[fields[0].Get<uint32>()] = chance;
+            } while (results->NextRow());
         }
+    }
 
-        float meanPriceF = meanPrice;
-        float minPriceF = minPrice;
-        float stdDev = std::max(1.f, meanPriceF - minPriceF) * 0.2f; // results will be about mean-3*stddev and mean+3*stddev
-        std::normal_distribution<float> x(meanPriceF, stdDev);
-        float randVal = x(rng);
-        return std::max(randVal, minPriceF); // Never fall below minPrice, we cannot deal with negative numbers, which sometimes can happen
+    if (QueryResult results = sAHStatements->Query(AHB_WORLD_SEL_ITEM_WEIGHTS))
+    {
+        do
+        {
+            const Field* fields = results->Fetch();
+            itemWeights[fields[0].Get<uint32>()] = fields[1].Get<float>();
+        } while (results->NextRow());
+    }
+
+    std::vector<float> weights;
+
+    for (uint32 i = 0; i < AHB_MAX_QUALITY; ++i)
+    {
+        weights.clear();
+        weights.reserve(_itemsBin[i].size());
+
+        for (const uint32 itemId : _itemsBin[i])
+        {
+            const auto found = itemWeights.find(itemId);
+            weights.push_back(found != itemWeights.end() ? found->second : defaultWeight);
+        }
+
+        for (uint32 bracket = 0; bracket < AHB_LEVEL_BRACKETS; ++bracket)
+        {
+            const auto first = weights.begin() + _bracketStart[i][bracket];
+            const auto last = weights.begin() + _bracketStart[i][bracket + 1];
+
+            // All weights zero leaves the table empty, the bracket is then never drawn by weight
+            _itemsAlias[i][bracket].Build(std::vector<float>(first, last));
+            _samplingStats.aliasTableBytes += _itemsAlias[i][bracket].GetMemoryUsage();
+
+            if (!_itemsAlias[i][bracket].IsEmpty())
+                _bracketWeights[i][bracket] = std::accumulate(first, last, 0.f, [](const float total, const float weight) { return total + std::max(weight, 0.f); });
+
+            _binWeights[i] += _bracketWeights[i][bracket];
+        }
     }
-    return std::nullopt;
 }
 
+std::vector<std::string> AuctionHouseIndex::FormatStats() const
+{
+    std::vector<std::string> lines = _filterStats.Format();
+
+    std::string brackets;
+    for (uint32 bracket = 0; bracket < AHB_LEVEL_BRACKETS; ++bracket)
+    {
+        uint32 items = 0;
+        for (uint32 i = 0; i < AHB_MAX_QUALITY; ++i)
+            items += GetBracketSize(i, bracket);
+
+        const uint32 minLevel = bracket * AHB_LEVEL_BRACKET_SIZE;
+        if (bracket + 1 < AHB_LEVEL_BRACKETS)
+            brackets += Acore::StringFormatFmt(" {}-{}: {}", minLevel, minLevel + AHB_LEVEL_BRACKET_SIZE - 1, items);
+        else
+            brackets += Acore::StringFormatFmt(" {}+: {}", minLevel, items);
+    }
+
+    lines.push_back("AuctionHouseBot items per level bracket:" + brackets);
+
+    if (_samplingStats.aliasTableBytes)
+        lines.push_back(Acore::StringFormatFmt("AuctionHouseBot item weights: alias tables use {} KiB", _samplingStats.aliasTableBytes / 1024));
+
+    return lines;
+}
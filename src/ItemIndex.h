@@ -23,10 +23,106 @@
 #include "ObjectGuid.h"
 #include "ItemTemplate.h"
 #include "AuctionHouseBotConfig.h"
+#include "AliasTable.h"
+#include "PriceKernel.h"
 #include "DatabaseEnvFwd.h"
+#include "Duration.h"
+#include <algorithm>
+#include <optional>
+#include <string>
 #include <vector>
 #include <unordered_set>
 
+// Every bin is split into level brackets of AHB_LEVEL_BRACKET_SIZE levels, the last bracket also holds everything above it
+constexpr uint32 AHB_LEVEL_BRACKET_SIZE = 10;
+constexpr uint32 AHB_LEVEL_BRACKETS = 9;
+
+inline uint32 GetAHBLevelBracket(uint32 level)
+{
+    return std::min(level / AHB_LEVEL_BRACKET_SIZE, AHB_LEVEL_BRACKETS - 1);
+}
+
+// Every rule of the item filter that can reject an item, in the order they are checked
+enum AHBFilterRule : uint8
+{
+    AHB_FILTER_ACCEPTED,
+    AHB_FILTER_RULE_BONDING,
+    AHB_FILTER_RULE_NO_PRICE,
+    AHB_FILTER_RULE_QUALITY,
+    AHB_FILTER_RULE_VENDOR_ITEMS,
+    AHB_FILTER_RULE_LOOT_ITEMS,
+    AHB_FILTER_RULE_OTHER_ITEMS,
+    AHB_FILTER_RULE_VENDOR_TGS,
+    AHB_FILTER_RULE_LOOT_TGS,
+    AHB_FILTER_RULE_OTHER_TGS,
+    AHB_FILTER_RULE_DISABLED_ITEMS,
+    AHB_FILTER_RULE_PERM_ENCHANT,
+    AHB_FILTER_RULE_CONJURED,
+    AHB_FILTER_RULE_GEMS,
+    AHB_FILTER_RULE_MONEY,
+    AHB_FILTER_RULE_MONEY_LOOT,
+    AHB_FILTER_RULE_LOOTABLE,
+    AHB_FILTER_RULE_KEYS,
+    AHB_FILTER_RULE_DURATION,
+    AHB_FILTER_RULE_BOP_OR_QUEST_NO_REQ_LEVEL,
+    AHB_FILTER_RULE_CLASS_ITEMS,
+    AHB_FILTER_RULE_ITEMS_BELOW_LEVEL,
+    AHB_FILTER_RULE_ITEMS_ABOVE_LEVEL,
+    AHB_FILTER_RULE_ITEMS_BELOW_GUID,
+    AHB_FILTER_RULE_ITEMS_ABOVE_GUID,
+    AHB_FILTER_RULE_TGS_BELOW_LEVEL,
+    AHB_FILTER_RULE_TGS_ABOVE_LEVEL,
+    AHB_FILTER_RULE_TGS_BELOW_GUID,
+    AHB_FILTER_RULE_TGS_ABOVE_GUID,
+    AHB_FILTER_RULE_ITEMS_BELOW_REQ_LEVEL,
+    AHB_FILTER_RULE_ITEMS_ABOVE_REQ_LEVEL,
+    AHB_FILTER_RULE_TGS_BELOW_REQ_LEVEL,
+    AHB_FILTER_RULE_TGS_ABOVE_REQ_LEVEL,
+    AHB_FILTER_RULE_ITEMS_BELOW_REQ_SKILL_RANK,
+    AHB_FILTER_RULE_ITEMS_ABOVE_REQ_SKILL_RANK,
+    AHB_FILTER_RULE_TGS_BELOW_REQ_SKILL_RANK,
+    AHB_FILTER_RULE_TGS_ABOVE_REQ_SKILL_RANK,
+    AHB_FILTER_RULE_MAX
+};
+
+// Phases of InitializeItemsToSell()
+enum AHBIndexPhase : uint8
+{
+    AHB_INDEX_PHASE_DISABLED_ITEMS,
+    AHB_INDEX_PHASE_VENDOR_ITEMS,
+    AHB_INDEX_PHASE_LOOT_ITEMS,
+    AHB_INDEX_PHASE_FILTER_TEMPLATES,
+    AHB_INDEX_PHASE_LEVEL_BRACKETS,
+    AHB_INDEX_PHASE_ITEM_WEIGHTS,
+    AHB_INDEX_PHASE_MAX
+};
+
+// Where the weights used to pick items within a bin come from
+enum AHBItemWeightMode : uint8
+{
+    AHB_ITEM_WEIGHTS_UNIFORM,       // every item has the same chance
+    AHB_ITEM_WEIGHTS_TABLE,         // mod_auctionhousebot_item_weights
+    AHB_ITEM_WEIGHTS_LOOT_CHANCE,   // highest loot drop chance, mod_auctionhousebot_item_weights takes precedence
+};
+
+struct AHBSamplingStats
+{
+    std::size_t aliasTableBytes{ 0 };
+};
+
+struct AHBFilterStats
+{
+    uint32 scanned{ 0 };
+    uint32 accepted{ 0 };
+
+    // An item is only counted for the first rule that rejected it
+    std::array<uint32, AHB_FILTER_RULE_MAX> rejected{};
+    std::array<Microseconds, AHB_INDEX_PHASE_MAX> phaseTime{};
+
+    // Compact table of every rule that rejected anything and the time spent in every phase
+    std::vector<std::string> Format() const;
+};
+
 class AuctionHouseIndex
 {
 public:
@@ -47,21 +143,110 @@ public:
         return _itemsBin[quality];
     }
 
-    const std::unordered_map<uint32, std::pair<uint32, uint32>>& GetPriceOverrides() const
+    const std::unordered_map<uint32, AHBPriceOverride>& GetPriceOverrides() const
     {
         return itemPriceOverride;
     }
 
+    AHBPriceOverride const* GetPriceOverride(uint32 itemId) const
+    {
+        const auto found = itemPriceOverride.find(itemId);
+        return found != itemPriceOverride.end() ? &found->second : nullptr;
+    }
+
+    const AHBFilterStats& GetFilterStats() const
+    {
+        return _filterStats;
+    }
+
+    // Filter statistics, and the sampling statistics if items are weighted
+    std::vector<std::string> FormatStats() const;
+
+    bool IsWeighted(uint32 quality) const
+    {
+        return _binWeights[quality] > 0;
+    }
+
+    uint32 GetBracketSize(uint32 quality, uint32 bracket) const
+    {
+        return _bracketStart[quality][bracket + 1] - _bracketStart[quality][bracket];
+    }
+
+    // Whether SampleItemInBracket() can draw anything, items with a weight of 0 can't be drawn
+    bool CanSampleBracket(uint32 quality, uint32 bracket) const
+    {
+        if (IsWeighted(quality))
+            return !_itemsAlias[quality][bracket].IsEmpty();
+
+        return GetBracketSize(quality, bracket) != 0;
+    }
+
+    // O(1) draw of an item id within one level bracket, weighted if the bin is. Only valid if CanSampleBracket()
+    template<class Rng>
+    uint32 SampleItemInBracket(uint32 quality, uint32 bracket, Rng& rng) const
+    {
+        const uint32 start = _bracketStart[quality][bracket];
+        AHBAliasTable const& alias = _itemsAlias[quality][bracket];
+
+        if (!alias.IsEmpty())
+            return _itemsBin[quality][start + alias.Sample(rng)];
+
+        std::uniform_int_distribution<uint32> offset(start, _bracketStart[quality][bracket + 1] - 1);
+        return _itemsBin[quality][offset(rng)];
+    }
+
+    // O(1) weighted draw of an item id over the whole bin, only valid if IsWeighted(quality)
+    template<class Rng>
+    uint32 SampleWeightedItem(uint32 quality, Rng& rng) const
+    {
+        // Pick the bracket by its total weight first, a linear pass over a handful of brackets
+        std::uniform_real_distribution<float> pick(0.f, _binWeights[quality]);
+        float remaining = pick(rng);
+        uint32 lastBracket = 0;
+
+        for (uint32 bracket = 0; bracket < AHB_LEVEL_BRACKETS; ++bracket)
+        {
+            const float weight = _bracketWeights[quality][bracket];
+            if (weight <= 0)
+                continue;
+
+            if (remaining < weight)
+                return SampleItemInBracket(quality, bracket, rng);
+
+            remaining -= weight;
+            lastBracket = bracket;
+        }
+
+        // Rounding errors
+        return SampleItemInBracket(quality, lastBracket, rng);
+    }
+
     std::optional<uint32> GetOverridenPrice(uint32 itemId, std::mt19937& rng);
 
+    // Per bin count of item ids that are in this index but not in other (first) and the other way around (second)
+    std::array<std::pair<uint32, uint32>, AHB_MAX_QUALITY> DiffItemBins(AuctionHouseIndex const& other) const;
+
 private:
 
 
     std::array<std::vector<uint32>, AHB_MAX_QUALITY> _itemsBin{};
 
+    // Every bin is sorted by level bracket, bracket b of bin q is [_bracketStart[q][b], _bracketStart[q][b + 1])
+    std::array<std::array<uint32, AHB_LEVEL_BRACKETS + 1>, AHB_MAX_QUALITY> _bracketStart{};
+
+    AHBFilterStats _filterStats{};
+
+    // One table per bracket, indexed relative to the bracket start, empty when items are not weighted
+    std::array<std::array<AHBAliasTable, AHB_LEVEL_BRACKETS>, AHB_MAX_QUALITY> _itemsAlias{};
+    std::array<std::array<float, AHB_LEVEL_BRACKETS>, AHB_MAX_QUALITY> _bracketWeights{};
+    std::array<float, AHB_MAX_QUALITY> _binWeights{};
+    AHBSamplingStats _samplingStats{};
+
+    void LoadItemWeights();
+
 
-    // itemID, avgPrice, minPrice
-    std::unordered_map<uint32, std::pair<uint32, uint32>> itemPriceOverride{};
+    // itemID, override resolved from avgPrice and minPrice
+    std::unordered_map<uint32, AHBPriceOverride> itemPriceOverride{};
 
 };
 
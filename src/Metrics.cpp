@@ -0,0 +1,158 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Metrics.h"
+
+#include "AuctionHouseMgr.h"
+#include "TraceWriter.h"
+#include <algorithm>
+#include <bit>
+
+uint64 AHBMetricsSnapshot::Timer::Percentile(float percentile) const
+{
+    if (!count)
+        return 0;
+
+    const uint64 rank = std::max<uint64>(1, uint64(count * percentile));
+    uint64 seen = 0;
+
+    for (uint32 bucket = 0; bucket < AHB_LATENCY_BUCKETS; ++bucket)
+    {
+        seen += buckets[bucket];
+        if (seen >= rank)
+            return uint64(1) << (bucket + 1);
+    }
+
+    return uint64(1) << AHB_LATENCY_BUCKETS;
+}
+
+/*static*/ AHBMetrics* AHBMetrics::instance()
+{
+    static AHBMetrics instance;
+    return &instance;
+}
+
+/*static*/ uint32 AHBMetrics::GetHouseSlot(uint32 houseId)
+{
+    switch (houseId)
+    {
+    case AUCTIONHOUSE_ALLIANCE:
+        return 0;
+    case AUCTIONHOUSE_HORDE:
+        return 1;
+    case AUCTIONHOUSE_NEUTRAL:
+        return 2;
+    default:
+        return 3;
+    }
+}
+
+/*static*/ char const* AHBMetrics::GetCounterName(AHBCounter counter)
+{
+    static constexpr std::array<char const*, uint32(AHBCounter::Max)> names =
+    {
+        "seller items created", "buyer bids", "buyer buyouts", "db statements", "settled items", "bot proceeds", "relisted", "topped up", "buyer queries coalesced", "buyer intervals dropped"
+    };
+
+    return names[uint32(counter)];
+}
+
+/*static*/ char const* AHBMetrics::GetTimerName(AHBTimer timer)
+{
+    static constexpr std::array<char const*, uint32(AHBTimer::Max)> names =
+    {
+        "update", "update maintenance", "seller", "buyer callback"
+    };
+
+    return names[uint32(timer)];
+}
+
+AHBMetrics::Shard& AHBMetrics::GetLocalShard()
+{
+    thread_local Shard* shard = nullptr;
+
+    if (!shard)
+    {
+        std::lock_guard<std::mutex> guard(_shardsLock);
+        shard = _shards.emplace_back(std::make_unique<Shard>()).get();
+    }
+
+    return *shard;
+}
+
+void AHBMetrics::Add(AHBCounter counter, uint32 houseId, uint64 value)
+{
+    GetLocalShard().counters[GetHouseSlot(houseId) * uint32(AHBCounter::Max) + uint32(counter)].fetch_add(value, std::memory_order_relaxed);
+
+    if (counter == AHBCounter::DbStatements)
+        sAHTrace->Instant("db write", houseId, value);
+}
+
+void AHBMetrics::Record(AHBTimer timer, uint32 houseId, Microseconds elapsed)
+{
+    const uint64 microseconds = std::max<int64>(0, elapsed.count());
+    const uint32 bucket = std::min<uint32>(AHB_LATENCY_BUCKETS - 1, microseconds ? std::bit_width(microseconds) - 1 : 0);
+    const uint32 slot = GetHouseSlot(houseId) * uint32(AHBTimer::Max) + uint32(timer);
+
+    Shard& shard = GetLocalShard();
+    shard.buckets[slot * AHB_LATENCY_BUCKETS + bucket].fetch_add(1, std::memory_order_relaxed);
+    shard.totals[slot].fetch_add(microseconds, std::memory_order_relaxed);
+}
+
+AHBMetricsSnapshot AHBMetrics::Read() const
+{
+    AHBMetricsSnapshot snapshot;
+
+    std::lock_guard<std::mutex> guard(_shardsLock);
+
+    for (auto const& shard : _shards)
+    {
+        for (uint32 house = 0; house < AHB_METRIC_HOUSES; ++house)
+        {
+            for (uint32 counter = 0; counter < uint32(AHBCounter::Max); ++counter)
+                snapshot.counters[house][counter] += shard->counters[house * uint32(AHBCounter::Max) + counter].load(std::memory_order_relaxed);
+
+            for (uint32 timer = 0; timer < uint32(AHBTimer::Max); ++timer)
+            {
+                const uint32 slot = house * uint32(AHBTimer::Max) + timer;
+                AHBMetricsSnapshot::Timer& out = snapshot.timers[house][timer];
+
+                for (uint32 bucket = 0; bucket < AHB_LATENCY_BUCKETS; ++bucket)
+                {
+                    const uint64 hits = shard->buckets[slot * AHB_LATENCY_BUCKETS + bucket].load(std::memory_order_relaxed);
+                    out.buckets[bucket] += hits;
+                    out.count += hits;
+                }
+
+                out.totalMicroseconds += shard->totals[slot].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    for (uint32 gauge = 0; gauge < uint32(AHBGauge::Max); ++gauge)
+        snapshot.gauges[gauge] = _gauges[gauge].load(std::memory_order_relaxed);
+
+    return snapshot;
+}
+
+AHBScopedTimer::~AHBScopedTimer()
+{
+    const auto end = std::chrono::steady_clock::now();
+
+    sAHMetrics->Record(_timer, _houseId, std::chrono::duration_cast<Microseconds>(end - _start));
+    sAHTrace->Complete(AHBMetrics::GetTimerName(_timer), _houseId, _start, end);
+}
@@ -0,0 +1,140 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AHB_METRICS_H
+#define AHB_METRICS_H
+
+#include "Define.h"
+#include "Duration.h"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum class AHBCounter : uint8
+{
+    SellerItemsCreated,
+    BuyerBids,
+    BuyerBuyouts,
+    DbStatements,
+    SettledItems,           // items the bot won or got back, destroyed without a mail
+    BotProceeds,            // copper of the bot's sales, kept out of the mails too
+    Relisted,               // bot auctions given a new expire time instead of running out
+    ToppedUp,               // trade goods added to a bot auction of the same item instead of listed on their own
+    BuyerQueriesCoalesced,  // buyer intervals left to a query of the house that was still pending
+    BuyerIntervalsDropped,  // buyer intervals skipped, the pending query already answers for as many as it may
+    Max
+};
+
+enum class AHBTimer : uint8
+{
+    Update,                 // all of AuctionHouseBot::Update()
+    UpdateMaintenance,      // reload, expire jobs and flushes at the start of Update()
+    Seller,                 // AddNewAuctions() of one house
+    BuyerCallback,          // evaluating and bidding on the auctions a buyer query returned
+    Max
+};
+
+enum class AHBGauge : uint8
+{
+    PendingBuyerQueries,
+    OldestBuyerQueryMs,     // how long the oldest pending buyer query has been waiting for its result
+    Max
+};
+
+// Alliance, Horde, Neutral and one slot for whatever is not about a single house
+constexpr uint32 AHB_METRIC_HOUSES = 4;
+
+// Bucket b holds latencies in [2^b, 2^(b+1)) microseconds, the last one everything above
+constexpr uint32 AHB_LATENCY_BUCKETS = 24;
+
+struct AHBMetricsSnapshot
+{
+    struct Timer
+    {
+        std::array<uint64, AHB_LATENCY_BUCKETS> buckets{};
+        uint64 count{ 0 };
+        uint64 totalMicroseconds{ 0 };
+
+        // Upper bound of the bucket the percentile falls into
+        uint64 Percentile(float percentile) const;
+    };
+
+    std::array<std::array<uint64, uint32(AHBCounter::Max)>, AHB_METRIC_HOUSES> counters{};
+    std::array<std::array<Timer, uint32(AHBTimer::Max)>, AHB_METRIC_HOUSES> timers{};
+    std::array<int64, uint32(AHBGauge::Max)> gauges{};
+};
+
+// Counters and latency histograms of the bot, cheap enough to always be on.
+// Every thread writes its own shard with relaxed atomics, shards are only summed up by Read().
+class AHBMetrics
+{
+public:
+    static AHBMetrics* instance();
+
+    // houseId is an auction house id (2, 6, 7), anything else counts as not house specific
+    void Add(AHBCounter counter, uint32 houseId, uint64 value = 1);
+    void Record(AHBTimer timer, uint32 houseId, Microseconds elapsed);
+
+    void AddGauge(AHBGauge gauge, int64 value) { _gauges[uint32(gauge)].fetch_add(value, std::memory_order_relaxed); }
+    void SetGauge(AHBGauge gauge, int64 value) { _gauges[uint32(gauge)].store(value, std::memory_order_relaxed); }
+
+    AHBMetricsSnapshot Read() const;
+
+    // Slot of a house in the snapshot arrays
+    static uint32 GetHouseSlot(uint32 houseId);
+
+    static char const* GetCounterName(AHBCounter counter);
+    static char const* GetTimerName(AHBTimer timer);
+
+private:
+    struct Shard
+    {
+        std::array<std::atomic<uint64>, AHB_METRIC_HOUSES * uint32(AHBCounter::Max)> counters{};
+        std::array<std::atomic<uint64>, AHB_METRIC_HOUSES * uint32(AHBTimer::Max) * AHB_LATENCY_BUCKETS> buckets{};
+        std::array<std::atomic<uint64>, AHB_METRIC_HOUSES * uint32(AHBTimer::Max)> totals{};
+    };
+
+    Shard& GetLocalShard();
+
+    // Shards outlive their threads, what a thread counted stays counted
+    mutable std::mutex _shardsLock;
+    std::vector<std::unique_ptr<Shard>> _shards;
+
+    std::array<std::atomic<int64>, uint32(AHBGauge::Max)> _gauges{};
+};
+
+#define sAHMetrics AHBMetrics::instance()
+
+// Records the lifetime of the scope into timer
+class AHBScopedTimer
+{
+public:
+    AHBScopedTimer(AHBTimer timer, uint32 houseId) : _timer(timer), _houseId(houseId), _start(std::chrono::steady_clock::now()) { }
+
+    // Also a trace event, if tracing is on
+    ~AHBScopedTimer();
+
+private:
+    AHBTimer _timer;
+    uint32 _houseId;
+    std::chrono::steady_clock::time_point _start;
+};
+
+#endif
@@ -0,0 +1,137 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PriceBook.h"
+
+#include "DatabaseEnv.h"
+#include "Log.h"
+#include "Metrics.h"
+#include "Statements.h"
+#include "StringFormat.h"
+
+void AHBPriceBook::Load()
+{
+    _prices.clear(); // in case of reload
+    _dirty.clear();
+
+    QueryResult results = sAHStatements->Query(AHB_CHAR_SEL_MARKET_PRICES);
+
+    if (results)
+    {
+        do
+        {
+            const Field* fields = results->Fetch();
+
+            AHBMarketPrice& record = _prices[fields[0].Get<uint32>()];
+            record.price = fields[1].Get<float>();
+            record.sold = fields[2].Get<uint32>();
+            record.expired = fields[3].Get<uint32>();
+            record.lastSeen = fields[4].Get<uint32>();
+        } while (results->NextRow());
+    }
+
+    LOG_INFO("module.ahbot", "AuctionHouseBot: Loaded {} market prices", _prices.size());
+}
+
+AHBMarketPrice& AHBPriceBook::Touch(uint32 itemId, uint32 now)
+{
+    AHBMarketPrice& record = _prices[itemId];
+    record.lastSeen = now;
+
+    if (!record.dirty)
+    {
+        record.dirty = true;
+        _dirty.push_back(itemId);
+    }
+
+    return record;
+}
+
+void AHBPriceBook::RecordSale(uint32 itemId, uint64 totalPrice, uint32 count, uint32 now)
+{
+    if (!count || !totalPrice)
+        return;
+
+    AHBMarketPrice& record = Touch(itemId, now);
+    const float unitPrice = float(totalPrice) / count;
+
+    if (!record.sold)
+        record.price = unitPrice;
+    else
+        record.price += _smoothing * (unitPrice - record.price);
+
+    record.sold += count;
+}
+
+void AHBPriceBook::RecordExpired(uint32 itemId, uint32 now)
+{
+    ++Touch(itemId, now).expired;
+}
+
+AHBMarketPrice const* AHBPriceBook::Get(uint32 itemId) const
+{
+    const auto found = _prices.find(itemId);
+    return found != _prices.end() ? &found->second : nullptr;
+}
+
+std::optional<uint32> AHBPriceBook::GetPrice(uint32 itemId, uint32 minSold) const
+{
+    AHBMarketPrice const* record = Get(itemId);
+
+    if (!record || !record->sold || record->sold < minSold)
+        return std::nullopt;
+
+    return record->price;
+}
+
+void AHBPriceBook::Flush(bool direct)
+{
+    if (_dirty.empty())
+        return;
+
+    // Multi row upserts, in chunks to keep every statement a reasonable size
+    constexpr std::size_t rowsPerStatement = 500;
+
+    CharacterDatabaseTransaction trans = CharacterDatabase.BeginTransaction();
+    std::string values;
+
+    for (std::size_t i = 0; i < _dirty.size(); ++i)
+    {
+        AHBMarketPrice& record = _prices[_dirty[i]];
+        record.dirty = false;
+
+        if (!values.empty())
+            values += ',';
+
+        values += Acore::StringFormatFmt("({},{},{},{},{})", _dirty[i], record.price, record.sold, record.expired, record.lastSeen);
+
+        if ((i + 1) % rowsPerStatement == 0 || i + 1 == _dirty.size())
+        {
+            sAHStatements->Append(trans, AHB_CHAR_REP_MARKET_PRICES, values);
+            sAHMetrics->Add(AHBCounter::DbStatements, 0);
+            values.clear();
+        }
+    }
+
+    LOG_DEBUG("module.ahbot", "AuctionHouseBot: Writing {} market prices", _dirty.size());
+    _dirty.clear();
+
+    if (direct)
+        CharacterDatabase.DirectCommitTransaction(trans);
+    else
+        CharacterDatabase.CommitTransaction(trans);
+}
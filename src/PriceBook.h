@@ -0,0 +1,68 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AHB_PRICE_BOOK_H
+#define AHB_PRICE_BOOK_H
+
+#include "Define.h"
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+// What the market paid for one item id
+struct AHBMarketPrice
+{
+    float price{ 0 };       // per unit, exponentially weighted moving average of the sales
+    uint32 sold{ 0 };       // units
+    uint32 expired{ 0 };    // auctions that expired without a bid
+    uint32 lastSeen{ 0 };   // unix time of the last sale or expiration
+    bool dirty{ false };
+};
+
+// In-memory book of market prices, fed by auction outcomes and written to
+// mod_auctionhousebot_market_prices in batches, never per sale
+class AHBPriceBook
+{
+public:
+    void Load();
+
+    // Weight of a new sale in the moving average, 0 < smoothing <= 1
+    void SetSmoothing(float smoothing) { _smoothing = smoothing; }
+
+    void RecordSale(uint32 itemId, uint64 totalPrice, uint32 count, uint32 now);
+    void RecordExpired(uint32 itemId, uint32 now);
+
+    AHBMarketPrice const* Get(uint32 itemId) const;
+
+    // Per unit market price, only once at least minSold units were sold
+    std::optional<uint32> GetPrice(uint32 itemId, uint32 minSold) const;
+
+    // Writes every changed record, directly when the world is shutting down
+    void Flush(bool direct = false);
+
+    std::size_t Size() const { return _prices.size(); }
+    std::size_t DirtyCount() const { return _dirty.size(); }
+
+private:
+    AHBMarketPrice& Touch(uint32 itemId, uint32 now);
+
+    std::unordered_map<uint32, AHBMarketPrice> _prices;
+    std::vector<uint32> _dirty;
+    float _smoothing{ 0.2f };
+};
+
+#endif
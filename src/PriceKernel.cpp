@@ -0,0 +1,160 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PriceKernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace
+{
+    // splitmix64, good enough for prices and a few times cheaper per bit than std::mt19937
+    inline uint64 NextRandom(uint64& state)
+    {
+        uint64 z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+}
+
+AHBPriceOverride AHBPriceOverride::Make(uint32 meanPrice, uint32 minPrice)
+{
+    if (minPrice > meanPrice)
+        minPrice = meanPrice * 0.8;
+
+    AHBPriceOverride priceOverride;
+    priceOverride.mean = meanPrice;
+    priceOverride.floor = minPrice;
+    priceOverride.stdDev = std::max(1.f, priceOverride.mean - priceOverride.floor) * 0.2f; // results will be about mean-3*stddev and mean+3*stddev
+    return priceOverride;
+}
+
+uint32 AHBPriceOverride::Sample(std::mt19937& rng) const
+{
+    std::normal_distribution<float> x(mean, stdDev);
+    return std::max(x(rng), floor); // Never fall below the floor, we cannot deal with negative numbers, which sometimes can happen
+}
+
+void AHBPriceBatch::Clear()
+{
+    _basePrice.clear();
+    _overrideSlot.clear();
+    _override.clear();
+    _buyout.clear();
+    _bid.clear();
+}
+
+void AHBPriceBatch::Reserve(std::size_t count)
+{
+    _basePrice.reserve(count);
+    _overrideSlot.reserve(count);
+    _override.reserve(count);
+    _buyout.reserve(count);
+    _bid.reserve(count);
+}
+
+void AHBPriceBatch::Add(uint64 basePrice, AHBPriceOverride const* priceOverride)
+{
+    if (priceOverride)
+    {
+        _overrideSlot.push_back(_basePrice.size());
+        _override.push_back(*priceOverride);
+    }
+
+    _basePrice.push_back(basePrice);
+}
+
+void AHBPriceBatch::GenerateNormals(std::size_t count, uint64& state, std::vector<float>& out)
+{
+    // Box-Muller makes two variates from every pair of uniforms, both come from one 64 bit number
+    const std::size_t pairs = (count + 1) / 2;
+    out.resize(pairs * 2);
+
+    constexpr float scale = 1.f / 16777216.f; // 2^-24, the precision of a float mantissa
+    for (std::size_t i = 0; i < pairs; ++i)
+    {
+        const uint64 random = NextRandom(state);
+        const float u1 = ((random >> 40) + 1) * scale;            // (0, 1], log(0) is not allowed
+        const float u2 = ((random >> 8) & 0xFFFFFF) * scale;      // [0, 1)
+
+        const float radius = std::sqrt(-2.f * std::log(u1));
+        const float angle = 2.f * std::numbers::pi_v<float> * u2;
+
+        out[2 * i] = radius * std::cos(angle);
+        out[2 * i + 1] = radius * std::sin(angle);
+    }
+
+    out.resize(count);
+}
+
+void AHBPriceBatch::Calculate(uint32 minBuyoutPercent, uint32 maxBuyoutPercent, uint32 minBidPercent, uint32 maxBidPercent, std::mt19937& rng)
+{
+    const std::size_t count = _basePrice.size();
+    uint64 state = (uint64(rng()) << 32) | rng();
+
+    if (!_override.empty())
+    {
+        GenerateNormals(_override.size(), state, _normals);
+
+        for (std::size_t i = 0; i < _override.size(); ++i)
+        {
+            AHBPriceOverride const& priceOverride = _override[i];
+            _basePrice[_overrideSlot[i]] = uint32(std::max(priceOverride.mean + priceOverride.stdDev * _normals[i], priceOverride.floor));
+        }
+    }
+
+    // Both multipliers of an item from one 64 bit random number, each half mapped onto [min, max] by multiply and shift
+    const uint64 buyoutSpan = maxBuyoutPercent >= minBuyoutPercent ? maxBuyoutPercent - minBuyoutPercent + 1 : 1;
+    const uint64 bidSpan = maxBidPercent >= minBidPercent ? maxBidPercent - minBidPercent + 1 : 1;
+
+    _buyout.resize(count);
+    _bid.resize(count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const uint64 random = NextRandom(state);
+        const uint64 buyoutPercent = minBuyoutPercent + (((random >> 32) * buyoutSpan) >> 32);
+        const uint64 bidPercent = minBidPercent + (((random & 0xFFFFFFFF) * bidSpan) >> 32);
+
+        _buyout[i] = _basePrice[i] * buyoutPercent / 100;
+        _bid[i] = _buyout[i] * bidPercent / 100;
+    }
+}
+
+AHBBuyerBid CalculateBuyerBid(uint32 currentPrice, uint64 basePrice, uint32 count, uint32 buyerPrice, uint32 outBid, float bidRate)
+{
+    AHBBuyerBid bid;
+
+    const uint64 worth = basePrice * count * buyerPrice;
+    if (currentPrice >= worth)
+        return bid;
+
+    bid.bidMax = worth;
+
+    float overBidAmount = (bid.bidMax - currentPrice) * bidRate; // How much money we bid, over top of the current price
+    overBidAmount = std::min(overBidAmount, static_cast<float>(currentPrice) * 1.2f); // Don't overbid more than 20%, no normal player would do that
+    bid.bidValue = static_cast<float>(currentPrice) + overBidAmount;
+    bid.bidPrice = static_cast<uint32>(bid.bidValue);
+
+    // Check our bid is high enough to be valid. If not, correct it to minimum.
+    if (currentPrice + outBid > bid.bidPrice)
+        bid.bidPrice = currentPrice + outBid;
+
+    return bid;
+}
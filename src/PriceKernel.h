@@ -0,0 +1,89 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AHB_PRICE_KERNEL_H
+#define AHB_PRICE_KERNEL_H
+
+#include "Define.h"
+#include <random>
+#include <vector>
+
+// Price override of one item, resolved once when mod_auctionhousebot_priceOverride is loaded
+struct AHBPriceOverride
+{
+    float mean{ 0 };
+    float floor{ 0 };
+    float stdDev{ 0 };
+
+    // Fixes a min price above the mean and derives the spread from the distance between them
+    static AHBPriceOverride Make(uint32 meanPrice, uint32 minPrice);
+
+    // Single draw, for callers that price one item at a time (the buyer)
+    uint32 Sample(std::mt19937& rng) const;
+};
+
+// What the buyer bids on one auction
+struct AHBBuyerBid
+{
+    float bidMax{ 0 };      // what the auction is worth to the buyer, 0 if it is not worth more than the current price
+    float bidValue{ 0 };    // before it is raised to the minimum outbid
+    uint32 bidPrice{ 0 };
+};
+
+// basePrice is per unit, buyerPrice the multiplier of the item's quality and bidRate the share of the
+// difference between worth and current price the buyer offers on top of the current price
+AHBBuyerBid CalculateBuyerBid(uint32 currentPrice, uint64 basePrice, uint32 count, uint32 buyerPrice, uint32 outBid, float bidRate);
+
+// Prices a whole batch of items of one quality at once.
+// The caller's generator only seeds a splitmix64 stream once per batch, normal variates for the overridden items are
+// generated in bulk (Box-Muller) and the buyout/bid multipliers are applied in one pass over the batch,
+// so the inner loops have no per item allocations, lookups or calls into std::mt19937.
+class AHBPriceBatch
+{
+public:
+    void Clear();
+    void Reserve(std::size_t count);
+
+    // basePrice is the vendor price, used unless priceOverride is set
+    void Add(uint64 basePrice, AHBPriceOverride const* priceOverride);
+
+    // Multipliers are in percent, drawn uniformly from [min, max] for every item
+    void Calculate(uint32 minBuyoutPercent, uint32 maxBuyoutPercent, uint32 minBidPercent, uint32 maxBidPercent, std::mt19937& rng);
+
+    std::size_t Size() const { return _basePrice.size(); }
+
+    // Per unit prices, valid after Calculate()
+    uint64 GetBuyout(std::size_t index) const { return _buyout[index]; }
+    uint64 GetBid(std::size_t index) const { return _bid[index]; }
+
+    // Fills out with count standard normal variates, advances state
+    static void GenerateNormals(std::size_t count, uint64& state, std::vector<float>& out);
+
+private:
+    std::vector<uint64> _basePrice;
+
+    // Only the overridden items, as indexes into the batch
+    std::vector<uint32> _overrideSlot;
+    std::vector<AHBPriceOverride> _override;
+
+    std::vector<float> _normals;
+
+    std::vector<uint64> _buyout;
+    std::vector<uint64> _bid;
+};
+
+#endif
@@ -0,0 +1,127 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Profiler.h"
+
+#ifdef AHBOT_PROFILING
+
+#include "Log.h"
+#include "StringFormat.h"
+#include <algorithm>
+#include <map>
+
+/*static*/ AHBProfiler* AHBProfiler::instance()
+{
+    static AHBProfiler instance;
+    return &instance;
+}
+
+AHBProfiler::Ring& AHBProfiler::GetLocalRing()
+{
+    thread_local Ring* ring = nullptr;
+
+    if (!ring)
+    {
+        std::lock_guard<std::mutex> guard(_ringsLock);
+        ring = _rings.emplace_back(std::make_unique<Ring>()).get();
+        ring->thread = _rings.size() - 1;
+    }
+
+    return *ring;
+}
+
+void AHBProfiler::Record(char const* name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+{
+    Ring& ring = GetLocalRing();
+
+    const uint64 index = ring.head.load(std::memory_order_relaxed);
+    Slot& slot = ring.slots[index % Ring::Size];
+
+    // Odd while the slot is written
+    slot.sequence.store(index * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(std::chrono::duration_cast<std::chrono::nanoseconds>(start - _epoch).count(), std::memory_order_relaxed);
+    slot.duration.store(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(), std::memory_order_relaxed);
+
+    slot.sequence.store(index * 2 + 2, std::memory_order_release);
+    ring.head.store(index + 1, std::memory_order_release);
+}
+
+std::vector<std::string> DumpAHBProfile()
+{
+    AHBProfiler* profiler = AHBProfiler::instance();
+
+    struct Summary
+    {
+        uint64 count{ 0 };
+        uint64 total{ 0 };
+        uint64 max{ 0 };
+    };
+
+    std::map<std::string, Summary> summaries;
+
+    std::lock_guard<std::mutex> guard(profiler->_ringsLock);
+
+    for (auto const& ring : profiler->_rings)
+    {
+        const uint64 head = ring->head.load(std::memory_order_acquire);
+        const uint64 first = head > AHBProfiler::Ring::Size ? head - AHBProfiler::Ring::Size : 0;
+
+        for (uint64 index = first; index < head; ++index)
+        {
+            AHBProfiler::Slot const& slot = ring->slots[index % AHBProfiler::Ring::Size];
+
+            const uint64 sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence != index * 2 + 2)
+                continue; // overwritten since we read head
+
+            char const* name = slot.name.load(std::memory_order_relaxed);
+            const uint64 start = slot.start.load(std::memory_order_relaxed);
+            const uint64 duration = slot.duration.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+                continue;
+
+            LOG_INFO("module.ahbot", "AHBProfile: thread {} {} start {} ns duration {} ns", ring->thread, name, start, duration);
+
+            Summary& summary = summaries[name];
+            ++summary.count;
+            summary.total += duration;
+            summary.max = std::max(summary.max, duration);
+        }
+    }
+
+    std::vector<std::string> lines;
+    lines.push_back(Acore::StringFormatFmt("AuctionHouseBot profile, {} probes over {} threads, records written to the log:", summaries.size(), profiler->_rings.size()));
+
+    for (auto const& [name, summary] : summaries)
+        lines.push_back(Acore::StringFormatFmt("  {}: {} times, avg {} us, max {} us", name, summary.count, summary.total / summary.count / 1000, summary.max / 1000));
+
+    return lines;
+}
+
+#else
+
+std::vector<std::string> DumpAHBProfile()
+{
+    return { "AuctionHouseBot was built without AHBOT_PROFILING, there are no probes to dump." };
+}
+
+#endif
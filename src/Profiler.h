@@ -0,0 +1,97 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AHB_PROFILER_H
+#define AHB_PROFILER_H
+
+#include "Define.h"
+#include <string>
+#include <vector>
+
+// Scoped timing probes, AHB_PROFILE_SCOPE("name") times the rest of the enclosing scope.
+// They only exist if the module is built with AHBOT_PROFILING defined, otherwise they compile to nothing.
+#ifdef AHBOT_PROFILING
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+class AHBProfiler
+{
+public:
+    static AHBProfiler* instance();
+
+    // name has to outlive the profiler, probes pass string literals
+    void Record(char const* name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+
+private:
+    friend std::vector<std::string> DumpAHBProfile();
+
+    // One record per probe hit. Written as a seqlock, so Dump() can read a ring while its thread keeps writing.
+    struct Slot
+    {
+        std::atomic<uint64> sequence{ 0 };
+        std::atomic<char const*> name{ nullptr };
+        std::atomic<uint64> start{ 0 };     // nanoseconds since the profiler was created
+        std::atomic<uint64> duration{ 0 };  // nanoseconds
+    };
+
+    // Written only by the thread that owns it, older records are overwritten
+    struct Ring
+    {
+        static constexpr std::size_t Size = 4096;
+
+        std::array<Slot, Size> slots;
+        std::atomic<uint64> head{ 0 };
+        uint32 thread{ 0 };
+    };
+
+    Ring& GetLocalRing();
+
+    const std::chrono::steady_clock::time_point _epoch{ std::chrono::steady_clock::now() };
+
+    std::mutex _ringsLock;
+    std::vector<std::unique_ptr<Ring>> _rings;
+};
+
+class AHBProfileScope
+{
+public:
+    explicit AHBProfileScope(char const* name) : _name(name), _start(std::chrono::steady_clock::now()) { }
+    ~AHBProfileScope() { AHBProfiler::instance()->Record(_name, _start, std::chrono::steady_clock::now()); }
+
+private:
+    char const* _name;
+    std::chrono::steady_clock::time_point _start;
+};
+
+#define AHB_PROFILE_CONCAT_IMPL(a, b) a##b
+#define AHB_PROFILE_CONCAT(a, b) AHB_PROFILE_CONCAT_IMPL(a, b)
+#define AHB_PROFILE_SCOPE(name) AHBProfileScope AHB_PROFILE_CONCAT(ahbProfileScope, __LINE__)(name)
+
+#else
+
+#define AHB_PROFILE_SCOPE(name) ((void)0)
+
+#endif
+
+// Writes every record still in the rings to the log and returns a summary per probe
+std::vector<std::string> DumpAHBProfile();
+
+#endif
@@ -0,0 +1,199 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Statements.h"
+
+#include "DatabaseEnv.h"
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+    enum class AHBDatabase : uint8
+    {
+        Character,
+        World
+    };
+
+    struct AHBStatementInfo
+    {
+        char const* name;
+        AHBDatabase database;
+        char const* sql;
+    };
+
+    constexpr std::array<AHBStatementInfo, AHB_STATEMENT_MAX> statements =
+    { {
+        { "bot character", AHBDatabase::Character, "SELECT 1 FROM characters WHERE account = {} AND guid = {}" },
+        { "buyer auctions", AHBDatabase::Character, "SELECT id FROM auctionhouse WHERE itemowner<>{} AND buyguid<>{} AND buyguid=0" },
+        { "auction bid", AHBDatabase::Character, "UPDATE auctionhouse SET buyguid = '{}', lastbid = '{}' WHERE id = '{}'" },
+        { "expire house", AHBDatabase::Character, "UPDATE auctionhouse SET time = {} WHERE itemowner = {} AND houseid = {}" },
+        { "expire auctions", AHBDatabase::Character, "UPDATE auctionhouse SET time = {} WHERE id IN ({})" },
+        { "relist auction", AHBDatabase::Character, "UPDATE auctionhouse SET time = {}, startbid = {}, buyoutprice = {} WHERE id = {}" },
+        { "top up item", AHBDatabase::Character, "UPDATE item_instance SET count = {} WHERE guid = {}" },
+        { "top up auction", AHBDatabase::Character, "UPDATE auctionhouse SET startbid = {}, buyoutprice = {} WHERE id = {}" },
+        { "fill items", AHBDatabase::Character, "INSERT INTO item_instance (guid, itemEntry, owner_guid, creatorGuid, giftCreatorGuid, count, duration, "
+            "charges, flags, enchantments, randomPropertyId, durability, playedTime, text) VALUES {}" },
+        { "fill auctions", AHBDatabase::Character, "INSERT INTO auctionhouse (id, houseid, itemguid, itemowner, buyoutprice, time, buyguid, lastbid, "
+            "startbid, deposit) VALUES {}" },
+        { "purge auctions", AHBDatabase::Character, "DELETE FROM auctionhouse WHERE id IN ({})" },
+        { "market prices", AHBDatabase::Character, "SELECT item, price, sold, expired, lastSeen FROM mod_auctionhousebot_market_prices" },
+        { "write market prices", AHBDatabase::Character, "INSERT INTO mod_auctionhousebot_market_prices (item, price, sold, expired, lastSeen) VALUES {} "
+            "ON DUPLICATE KEY UPDATE price = VALUES(price), sold = VALUES(sold), expired = VALUES(expired), lastSeen = VALUES(lastSeen)" },
+        { "settled items", AHBDatabase::Character, "DELETE FROM item_instance WHERE guid IN ({})" },
+
+        { "settings", AHBDatabase::World, "SELECT {} FROM mod_auctionhousebot WHERE auctionhouse = {}" },
+        { "write settings", AHBDatabase::World, "UPDATE mod_auctionhousebot SET {} WHERE auctionhouse = {}" },
+        { "disabled items", AHBDatabase::World, "SELECT item FROM mod_auctionhousebot_disabled_items" },
+        { "vendor items", AHBDatabase::World, "SELECT distinct item FROM npc_vendor" },
+        { "loot items", AHBDatabase::World, "SELECT item FROM creature_loot_template UNION "
+            "SELECT item FROM reference_loot_template UNION "
+            "SELECT item FROM disenchant_loot_template UNION "
+            "SELECT item FROM fishing_loot_template UNION "
+            "SELECT item FROM gameobject_loot_template UNION "
+            "SELECT item FROM item_loot_template UNION "
+            "SELECT item FROM milling_loot_template UNION "
+            "SELECT item FROM pickpocketing_loot_template UNION "
+            "SELECT item FROM prospecting_loot_template UNION "
+            "SELECT item FROM skinning_loot_template" },
+        { "loot chances", AHBDatabase::World, "SELECT item, MAX(Chance) FROM ("
+            "SELECT item, Chance FROM creature_loot_template UNION ALL "
+            "SELECT item, Chance FROM reference_loot_template UNION ALL "
+            "SELECT item, Chance FROM disenchant_loot_template UNION ALL "
+            "SELECT item, Chance FROM fishing_loot_template UNION ALL "
+            "SELECT item, Chance FROM gameobject_loot_template UNION ALL "
+            "SELECT item, Chance FROM item_loot_template UNION ALL "
+            "SELECT item, Chance FROM milling_loot_template UNION ALL "
+            "SELECT item, Chance FROM pickpocketing_loot_template UNION ALL "
+            "SELECT item, Chance FROM prospecting_loot_template UNION ALL "
+            "SELECT item, Chance FROM skinning_loot_template) AS loot GROUP BY item" },
+        { "price overrides", AHBDatabase::World, "SELECT item, avgPrice, minPrice FROM mod_auctionhousebot_priceOverride" },
+        { "item weights", AHBDatabase::World, "SELECT item, weight FROM mod_auctionhousebot_item_weights" },
+    } };
+}
+
+/*static*/ AHBStatements* AHBStatements::instance()
+{
+    static AHBStatements instance;
+    return &instance;
+}
+
+/*static*/ char const* AHBStatements::GetName(AHBStatementId id)
+{
+    return statements[id].name;
+}
+
+/*static*/ char const* AHBStatements::GetSql(AHBStatementId id)
+{
+    return statements[id].sql;
+}
+
+QueryResult AHBStatements::QueryFormatted(AHBStatementId id, std::string const& sql)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    QueryResult result = statements[id].database == AHBDatabase::World ? WorldDatabase.Query(sql) : CharacterDatabase.Query(sql);
+
+    Record(id, std::chrono::duration_cast<Microseconds>(std::chrono::steady_clock::now() - start));
+    return result;
+}
+
+QueryCallback AHBStatements::AsyncQueryFormatted(AHBStatementId id, std::string const& sql, std::function<void(QueryResult)> callback)
+{
+    const auto start = std::chrono::steady_clock::now();
+    auto timedCallback = [this, id, start, callback = std::move(callback)](QueryResult result)
+    {
+        Record(id, std::chrono::duration_cast<Microseconds>(std::chrono::steady_clock::now() - start));
+        callback(std::move(result));
+    };
+
+    if (statements[id].database == AHBDatabase::World)
+        return WorldDatabase.AsyncQuery(sql).WithCallback(std::move(timedCallback));
+
+    return CharacterDatabase.AsyncQuery(sql).WithCallback(std::move(timedCallback));
+}
+
+void AHBStatements::ExecuteFormatted(AHBStatementId id, std::string const& sql, bool direct)
+{
+    Count(id);
+
+    if (statements[id].database == AHBDatabase::World)
+    {
+        if (direct)
+            WorldDatabase.DirectExecute(sql);
+        else
+            WorldDatabase.Execute(sql);
+    }
+    else
+    {
+        if (direct)
+            CharacterDatabase.DirectExecute(sql);
+        else
+            CharacterDatabase.Execute(sql);
+    }
+}
+
+void AHBStatements::AppendFormatted(CharacterDatabaseTransaction trans, AHBStatementId id, std::string const& sql)
+{
+    Count(id);
+    trans->Append(sql);
+}
+
+void AHBStatements::Count(AHBStatementId id)
+{
+    _counters[id].count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AHBStatements::Record(AHBStatementId id, Microseconds elapsed)
+{
+    const uint64 microseconds = std::max<int64>(0, elapsed.count());
+    Counters& counters = _counters[id];
+
+    counters.count.fetch_add(1, std::memory_order_relaxed);
+    counters.timed.fetch_add(1, std::memory_order_relaxed);
+    counters.totalMicroseconds.fetch_add(microseconds, std::memory_order_relaxed);
+
+    uint64 max = counters.maxMicroseconds.load(std::memory_order_relaxed);
+    while (microseconds > max && !counters.maxMicroseconds.compare_exchange_weak(max, microseconds, std::memory_order_relaxed))
+        ;
+}
+
+std::vector<AHBStatementStats> AHBStatements::GetStats() const
+{
+    std::vector<AHBStatementStats> stats;
+
+    for (uint32 id = 0; id < AHB_STATEMENT_MAX; ++id)
+    {
+        Counters const& counters = _counters[id];
+        if (!counters.count.load(std::memory_order_relaxed))
+            continue;
+
+        AHBStatementStats& statement = stats.emplace_back();
+        statement.id = AHBStatementId(id);
+        statement.count = counters.count.load(std::memory_order_relaxed);
+        statement.timed = counters.timed.load(std::memory_order_relaxed);
+        statement.totalMicroseconds = counters.totalMicroseconds.load(std::memory_order_relaxed);
+        statement.maxMicroseconds = counters.maxMicroseconds.load(std::memory_order_relaxed);
+    }
+
+    std::sort(stats.begin(), stats.end(), [](AHBStatementStats const& left, AHBStatementStats const& right)
+    {
+        return left.totalMicroseconds != right.totalMicroseconds ? left.totalMicroseconds > right.totalMicroseconds : left.count > right.count;
+    });
+
+    return stats;
+}
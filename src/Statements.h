@@ -0,0 +1,133 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AHB_STATEMENTS_H
+#define AHB_STATEMENTS_H
+
+#include "Define.h"
+#include "DatabaseEnvFwd.h"
+#include "Duration.h"
+#include "StringFormat.h"
+#include <array>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Every statement the bot sends, Character and World tell the connection pool
+enum AHBStatementId : uint32
+{
+    AHB_CHAR_SEL_BOT_CHARACTER,
+    AHB_CHAR_SEL_BUYER_AUCTIONS,
+    AHB_CHAR_UPD_AUCTION_BID,
+    AHB_CHAR_UPD_EXPIRE_HOUSE,
+    AHB_CHAR_UPD_EXPIRE_AUCTIONS,
+    AHB_CHAR_UPD_RELIST_AUCTION,
+    AHB_CHAR_UPD_TOP_UP_ITEM,
+    AHB_CHAR_UPD_TOP_UP_AUCTION,
+    AHB_CHAR_INS_ITEM_INSTANCES,
+    AHB_CHAR_INS_AUCTIONS,
+    AHB_CHAR_DEL_AUCTIONS,
+    AHB_CHAR_SEL_MARKET_PRICES,
+    AHB_CHAR_REP_MARKET_PRICES,
+    AHB_CHAR_DEL_ITEM_INSTANCES,
+
+    AHB_WORLD_SEL_SETTINGS,
+    AHB_WORLD_UPD_SETTINGS,
+    AHB_WORLD_SEL_DISABLED_ITEMS,
+    AHB_WORLD_SEL_VENDOR_ITEMS,
+    AHB_WORLD_SEL_LOOT_ITEMS,
+    AHB_WORLD_SEL_LOOT_CHANCES,
+    AHB_WORLD_SEL_PRICE_OVERRIDES,
+    AHB_WORLD_SEL_ITEM_WEIGHTS,
+
+    AHB_STATEMENT_MAX
+};
+
+// What one statement cost so far. Synchronous queries are timed while they run, asynchronous ones
+// from sending them until their callback, statements without a result are only counted.
+struct AHBStatementStats
+{
+    AHBStatementId id{ AHB_STATEMENT_MAX };
+    uint64 count{ 0 };
+    uint64 timed{ 0 };
+    uint64 totalMicroseconds{ 0 };
+    uint64 maxMicroseconds{ 0 };
+};
+
+// Registry of the bot's SQL, all of it goes through here so every statement is counted and timed by id.
+// The core prepares the statements of its pools from its own enums in its connection classes and has no
+// way for a module to add to them, so the statements are formatted from their registered SQL and sent as
+// text. Call sites only know the ids and would not change if the core ever lets modules prepare statements.
+class AHBStatements
+{
+public:
+    static AHBStatements* instance();
+
+    static char const* GetName(AHBStatementId id);
+    static char const* GetSql(AHBStatementId id);
+
+    template<class... Args>
+    static std::string Format(AHBStatementId id, Args&&... args)
+    {
+        return fmt::format(fmt::runtime(GetSql(id)), std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    QueryResult Query(AHBStatementId id, Args&&... args) { return QueryFormatted(id, Format(id, std::forward<Args>(args)...)); }
+
+    // callback is timed together with the query, the time from sending it until the result arrived is recorded
+    template<class... Args>
+    QueryCallback AsyncQuery(AHBStatementId id, std::function<void(QueryResult)> callback, Args&&... args)
+    {
+        return AsyncQueryFormatted(id, Format(id, std::forward<Args>(args)...), std::move(callback));
+    }
+
+    // Direct ones block until the statement ran, for shutdown and reloads
+    template<class... Args>
+    void Execute(AHBStatementId id, bool direct, Args&&... args) { ExecuteFormatted(id, Format(id, std::forward<Args>(args)...), direct); }
+
+    template<class... Args>
+    void Append(CharacterDatabaseTransaction trans, AHBStatementId id, Args&&... args) { AppendFormatted(trans, id, Format(id, std::forward<Args>(args)...)); }
+
+    // Statements that ran at least once, the most expensive in total first
+    std::vector<AHBStatementStats> GetStats() const;
+
+private:
+    QueryResult QueryFormatted(AHBStatementId id, std::string const& sql);
+    QueryCallback AsyncQueryFormatted(AHBStatementId id, std::string const& sql, std::function<void(QueryResult)> callback);
+    void ExecuteFormatted(AHBStatementId id, std::string const& sql, bool direct);
+    void AppendFormatted(CharacterDatabaseTransaction trans, AHBStatementId id, std::string const& sql);
+
+    void Count(AHBStatementId id);
+    void Record(AHBStatementId id, Microseconds elapsed);
+
+    // Queries run on the world thread and on the reload thread
+    struct Counters
+    {
+        std::atomic<uint64> count{ 0 };
+        std::atomic<uint64> timed{ 0 };
+        std::atomic<uint64> totalMicroseconds{ 0 };
+        std::atomic<uint64> maxMicroseconds{ 0 };
+    };
+
+    std::array<Counters, AHB_STATEMENT_MAX> _counters;
+};
+
+#define sAHStatements AHBStatements::instance()
+
+#endif
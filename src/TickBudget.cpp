@@ -0,0 +1,143 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TickBudget.h"
+
+#include "Log.h"
+#include <algorithm>
+
+namespace
+{
+    constexpr float averageWeight = 0.2f;       // weight of the latest update in the moving average
+    constexpr uint32 degradeCooldown = 2;       // updates a level is kept before degrading further, lets it take effect
+    constexpr uint32 recoveryTicks = 10;        // updates in a row well within budget before recovering a level
+    constexpr float recoveryShare = 0.5f;       // "well within" is an average below this share of its budget
+}
+
+void AHBTickBudget::Configure(Milliseconds averageBudget, Milliseconds p99Budget, uint32 window)
+{
+    _averageBudget = averageBudget;
+    _p99Budget = p99Budget;
+
+    _recent.assign(std::max(window, 1u), 0);
+    _next = 0;
+    _ticks = 0;
+    _average = 0;
+    _ticksSinceChange = 0;
+    _calmTicks = 0;
+
+    if (_level != AHBDegradation::None)
+        SetLevel(AHBDegradation::None, "reconfigured");
+}
+
+void AHBTickBudget::Record(Microseconds elapsed)
+{
+    if (_averageBudget == 0ms && _p99Budget == 0ms)
+        return;
+
+    const int64 microseconds = elapsed.count();
+    _average = _ticks ? _average + averageWeight * (microseconds - _average) : microseconds;
+    _recent[_next] = microseconds;
+    _next = (_next + 1) % _recent.size();
+    ++_ticks;
+    ++_ticksSinceChange;
+
+    // A single slow update is not enough to degrade, the p99 only counts while slow updates keep coming
+    const Microseconds p99 = GetP99();
+    const bool averageOver = _averageBudget > 0ms && GetAverage() > _averageBudget;
+    const bool p99Over = _p99Budget > 0ms && p99 > _p99Budget && elapsed > _p99Budget;
+
+    if (averageOver || p99Over)
+    {
+        _calmTicks = 0;
+
+        if (_level < AHBDegradation::OneHousePerTick && _ticksSinceChange >= degradeCooldown)
+            SetLevel(AHBDegradation(uint8(_level) + 1), averageOver ? "average over budget" : "p99 over budget");
+
+        return;
+    }
+
+    const bool calm = (_averageBudget == 0ms || GetAverage() < _averageBudget * recoveryShare) &&
+        (_p99Budget == 0ms || p99 <= _p99Budget);
+
+    _calmTicks = calm ? _calmTicks + 1 : 0;
+
+    if (_level != AHBDegradation::None && _calmTicks >= recoveryTicks)
+    {
+        _calmTicks = 0;
+        SetLevel(AHBDegradation(uint8(_level) - 1), "back within budget");
+    }
+}
+
+uint32 AHBTickBudget::GetItemsPerCycle(uint32 itemsPerCycle) const
+{
+    if (_level >= AHBDegradation::QuarterItemsPerCycle)
+        return std::max(itemsPerCycle / 4, 1u);
+
+    if (_level >= AHBDegradation::HalfItemsPerCycle)
+        return std::max(itemsPerCycle / 2, 1u);
+
+    return itemsPerCycle;
+}
+
+bool AHBTickBudget::ShouldSkipHouse(uint32 slot, uint32 houseCount) const
+{
+    if (_level < AHBDegradation::OneHousePerTick || houseCount < 2)
+        return false;
+
+    return _ticks % houseCount != slot;
+}
+
+Microseconds AHBTickBudget::GetP99() const
+{
+    const std::size_t count = std::min<uint64>(_ticks, _recent.size());
+    if (!count)
+        return 0us;
+
+    // A copy of at most window values, once per update
+    std::vector<int64> sorted(_recent.begin(), _recent.begin() + count);
+    const std::size_t rank = std::min(count - 1, count * 99 / 100);
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    return Microseconds(sorted[rank]);
+}
+
+char const* AHBTickBudget::GetLevelName(AHBDegradation level)
+{
+    switch (level)
+    {
+        case AHBDegradation::None: return "none";
+        case AHBDegradation::HalfItemsPerCycle: return "half ItemsPerCycle";
+        case AHBDegradation::QuarterItemsPerCycle: return "quarter ItemsPerCycle";
+        case AHBDegradation::BuyerDeferred: return "buyer deferred";
+        case AHBDegradation::OneHousePerTick: return "one house per update";
+        default: return "unknown";
+    }
+}
+
+void AHBTickBudget::SetLevel(AHBDegradation level, char const* reason)
+{
+    const bool degrading = level > _level;
+    _level = level;
+    _ticksSinceChange = 0;
+
+    if (degrading)
+        LOG_WARN("module.ahbot", "AuctionHouseBot: Update took avg {} us, p99 {} us ({}), degrading to: {}",
+            GetAverage().count(), GetP99().count(), reason, GetLevelName(level));
+    else
+        LOG_INFO("module.ahbot", "AuctionHouseBot: Update took avg {} us, p99 {} us ({}), recovering to: {}",
+            GetAverage().count(), GetP99().count(), reason, GetLevelName(level));
+}
@@ -0,0 +1,75 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AHB_TICK_BUDGET_H
+#define AHB_TICK_BUDGET_H
+
+#include "Define.h"
+#include "Duration.h"
+#include <vector>
+
+// How far the bot has backed off to stay within its time budget, every level includes the ones below
+enum class AHBDegradation : uint8
+{
+    None,
+    HalfItemsPerCycle,      // the seller creates half of ItemsPerCycle per update
+    QuarterItemsPerCycle,   // a quarter
+    BuyerDeferred,          // no new buyer queries, pending ones are still handled
+    OneHousePerTick,        // the seller only works on one house per update, in turns
+    Max
+};
+
+// Watchdog of the time AuctionHouseBot::Update() takes. Tracks a moving average and the p99 of the
+// last updates against the configured budgets, degrades one level at a time while they are exceeded
+// and recovers one level at a time once the average stayed well below and the p99 within budget for a while.
+class AHBTickBudget
+{
+public:
+    // Budgets of 0 disable the watchdog, window is the number of updates the p99 is taken over
+    void Configure(Milliseconds averageBudget, Milliseconds p99Budget, uint32 window);
+
+    void Record(Microseconds elapsed);
+
+    AHBDegradation GetLevel() const { return _level; }
+    uint32 GetItemsPerCycle(uint32 itemsPerCycle) const;
+    bool IsBuyerDeferred() const { return _level >= AHBDegradation::BuyerDeferred; }
+
+    // slot is the position of the house among the houseCount houses the seller works on
+    bool ShouldSkipHouse(uint32 slot, uint32 houseCount) const;
+
+    Microseconds GetAverage() const { return Microseconds(static_cast<int64>(_average)); }
+    Microseconds GetP99() const;
+
+    static char const* GetLevelName(AHBDegradation level);
+
+private:
+    void SetLevel(AHBDegradation level, char const* reason);
+
+    Microseconds _averageBudget{ 0 };
+    Microseconds _p99Budget{ 0 };
+
+    float _average{ 0 };
+    std::vector<int64> _recent;     // ring buffer of the last window updates, in microseconds
+    std::size_t _next{ 0 };
+    uint64 _ticks{ 0 };
+
+    AHBDegradation _level{ AHBDegradation::None };
+    uint32 _ticksSinceChange{ 0 };
+    uint32 _calmTicks{ 0 };
+};
+
+#endif
@@ -0,0 +1,222 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TraceWriter.h"
+
+#include "Log.h"
+#include "StringFormat.h"
+#include <filesystem>
+#include <utility>
+
+namespace
+{
+    // Events waiting for the writer, anything beyond is dropped rather than growing without bounds
+    constexpr std::size_t maxPendingEvents = 100000;
+
+    // The writer wakes up this often, or earlier once this many events are waiting
+    constexpr std::chrono::seconds writeInterval = std::chrono::seconds(1);
+    constexpr std::size_t writeBatch = 4096;
+}
+
+AHBTraceWriter::~AHBTraceWriter()
+{
+    Shutdown();
+}
+
+/*static*/ AHBTraceWriter* AHBTraceWriter::instance()
+{
+    static AHBTraceWriter instance;
+    return &instance;
+}
+
+/*static*/ uint32 AHBTraceWriter::GetThreadIndex()
+{
+    static std::atomic<uint32> threads{ 0 };
+    thread_local const uint32 index = ++threads;
+    return index;
+}
+
+void AHBTraceWriter::Configure(std::string path, uint64 maxFileSize)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    _path = std::move(path);
+    _maxFileSize = maxFileSize;
+}
+
+void AHBTraceWriter::SetEnabled(bool enabled)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+
+    if (_enabled.exchange(enabled) == enabled)
+        return;
+
+    if (enabled && !_thread.joinable())
+    {
+        _stop = false;
+        _thread = std::thread(&AHBTraceWriter::Run, this);
+    }
+
+    // When disabled, the writer closes the file on its next wake up, then only wakes up with the interval
+    _close = !enabled;
+    _wake.notify_one();
+}
+
+void AHBTraceWriter::Complete(char const* name, uint32 houseId, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+{
+    if (!IsEnabled())
+        return;
+
+    Push({ name, 'X', uint64(std::chrono::duration_cast<std::chrono::microseconds>(start - _epoch).count()),
+        uint64(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()), GetThreadIndex(), houseId, 0 });
+}
+
+void AHBTraceWriter::Instant(char const* name, uint32 houseId, uint64 value)
+{
+    if (!IsEnabled())
+        return;
+
+    Push({ name, 'i', uint64(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _epoch).count()),
+        0, GetThreadIndex(), houseId, value });
+}
+
+void AHBTraceWriter::Push(Event const& event)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+
+    if (_pending.size() >= maxPendingEvents)
+    {
+        ++_dropped;
+        return;
+    }
+
+    _pending.push_back(event);
+
+    if (_pending.size() == writeBatch)
+        _wake.notify_one();
+}
+
+void AHBTraceWriter::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _enabled = false;
+        _stop = true;
+    }
+
+    _wake.notify_one();
+
+    if (_thread.joinable())
+        _thread.join();
+}
+
+void AHBTraceWriter::Run()
+{
+    std::vector<Event> events;
+    std::unique_lock<std::mutex> lock(_lock);
+
+    while (true)
+    {
+        _wake.wait_for(lock, writeInterval, [this]() { return _stop || _close || (_enabled && _pending.size() >= writeBatch); });
+
+        events.swap(_pending);
+        const uint64 dropped = std::exchange(_dropped, 0);
+        const bool stop = _stop;
+        const bool close = std::exchange(_close, false);
+
+        lock.unlock();
+
+        if (dropped)
+            LOG_WARN("module.ahbot", "AuctionHouseBot: Trace writer fell behind, dropped {} events", dropped);
+
+        if (!events.empty())
+            Write(events);
+
+        events.clear();
+
+        if (close || stop)
+            CloseFile();
+
+        lock.lock();
+
+        if (stop)
+            break;
+    }
+}
+
+void AHBTraceWriter::Write(std::vector<Event> const& events)
+{
+    std::string path;
+    uint64 maxFileSize;
+
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        path = _path;
+        maxFileSize = _maxFileSize;
+    }
+
+    std::string buffer;
+
+    for (Event const& event : events)
+    {
+        if (!_file.is_open())
+        {
+            _file.open(path, std::ios::out | std::ios::trunc);
+            if (!_file)
+            {
+                LOG_ERROR("module.ahbot", "AuctionHouseBot: Cannot open trace file {}", path);
+                return;
+            }
+
+            _file << "[";
+            _fileSize = 1;
+        }
+
+        buffer = Acore::StringFormatFmt("{}{{\"name\":\"{}\",\"cat\":\"ahbot\",\"ph\":\"{}\",\"ts\":{},\"pid\":1,\"tid\":{}",
+            _fileSize > 1 ? ",\n" : "\n", event.name, event.phase, event.timestamp, event.thread);
+
+        if (event.phase == 'X')
+            buffer += Acore::StringFormatFmt(",\"dur\":{}", event.duration);
+        else
+            buffer += ",\"s\":\"t\"";
+
+        buffer += Acore::StringFormatFmt(",\"args\":{{\"house\":{},\"value\":{}}}}}", event.houseId, event.value);
+
+        _file << buffer;
+        _fileSize += buffer.size();
+
+        if (_fileSize >= maxFileSize)
+        {
+            CloseFile();
+
+            std::error_code error;
+            std::filesystem::rename(path, path + ".1", error);
+            if (error)
+                LOG_ERROR("module.ahbot", "AuctionHouseBot: Cannot rotate trace file {}: {}", path, error.message());
+        }
+    }
+
+    _file.flush();
+}
+
+void AHBTraceWriter::CloseFile()
+{
+    if (!_file.is_open())
+        return;
+
+    _file << "\n]\n";
+    _file.close();
+}
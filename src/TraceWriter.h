@@ -0,0 +1,97 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AHB_TRACE_WRITER_H
+#define AHB_TRACE_WRITER_H
+
+#include "Define.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Writes bot phases and database writes as Chrome trace events (JSON array format, loads in
+// chrome://tracing and Perfetto). Callers only append to a buffer, formatting and file writes
+// happen on a thread of its own. The file is rotated to <file>.1 once it reaches its max size.
+class AHBTraceWriter
+{
+public:
+    ~AHBTraceWriter();
+
+    static AHBTraceWriter* instance();
+
+    // Takes effect with the next file that is opened
+    void Configure(std::string path, uint64 maxFileSize);
+
+    void SetEnabled(bool enabled);
+    bool IsEnabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+    // A phase that ran from start to end
+    void Complete(char const* name, uint32 houseId, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+
+    // Something that happened now, value is shown as its argument
+    void Instant(char const* name, uint32 houseId, uint64 value);
+
+    // Writes what is buffered and stops the writer thread
+    void Shutdown();
+
+private:
+    struct Event
+    {
+        char const* name;
+        char phase;
+        uint64 timestamp;   // microseconds since the writer was created
+        uint64 duration;    // microseconds, complete events only
+        uint32 thread;
+        uint32 houseId;
+        uint64 value;
+    };
+
+    void Push(Event const& event);
+    void Run();
+    void Write(std::vector<Event> const& events);
+    void CloseFile();
+
+    static uint32 GetThreadIndex();
+
+    const std::chrono::steady_clock::time_point _epoch{ std::chrono::steady_clock::now() };
+    std::atomic<bool> _enabled{ false };
+
+    // Shared with the writer thread
+    std::mutex _lock;
+    std::condition_variable _wake;
+    std::vector<Event> _pending;
+    uint64 _dropped{ 0 };
+    bool _stop{ false };
+    bool _close{ false };       // disabled since the writer last woke up, it closes the file once
+    std::string _path{ "ahbot_trace.json" };
+    uint64 _maxFileSize{ 64 * 1024 * 1024 };
+
+    std::thread _thread;
+
+    // Writer thread only
+    std::ofstream _file;
+    uint64 _fileSize{ 0 };
+};
+
+#define sAHTrace AHBTraceWriter::instance()
+
+#endif
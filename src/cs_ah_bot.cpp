@@ -18,7 +18,11 @@
 #include "ScriptMgr.h"
 #include "Chat.h"
 #include "AuctionHouseBot.h"
+#include "ItemIndex.h"
+#include "Profiler.h"
+#include "TraceWriter.h"
 #include "Config.h"
+#include <cctype>
 
 #if AC_COMPILER == AC_COMPILER_GNU
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
@@ -66,6 +70,20 @@ public:
             return static_cast<ItemQualities>(-1); // Invalid
         };
 
+        // Takes on/off instead of an ahMapID
+        if (opt && strcmp(opt, "trace") == 0)
+        {
+            if (!ahMapIdStr || (strcmp(ahMapIdStr, "on") != 0 && strcmp(ahMapIdStr, "off") != 0))
+            {
+                handler->PSendSysMessage("Syntax is: ahbotoptions trace on|off");
+                return false;
+            }
+
+            sAHTrace->SetEnabled(strcmp(ahMapIdStr, "on") == 0);
+            handler->PSendSysMessage(sAHTrace->IsEnabled() ? "AuctionHouseBot tracing is on." : "AuctionHouseBot tracing is off.");
+            return true;
+        }
+
         if (ahMapIdStr)
         {
             ahMapID = uint32(strtoul(ahMapIdStr, NULL, 0));
@@ -109,6 +127,12 @@ public:
             handler->PSendSysMessage("bidinterval");
             handler->PSendSysMessage("bidsperinterval");
             handler->PSendSysMessage("reload");
+            handler->PSendSysMessage("fill");
+            handler->PSendSysMessage("filterstats");
+            handler->PSendSysMessage("stats");
+            handler->PSendSysMessage("profile");
+            handler->PSendSysMessage("trace");
+            handler->PSendSysMessage("purge (not abbreviated)");
             return true;
         }
         else if (strncmp(opt, "ahexpire", l) == 0)
@@ -120,17 +144,19 @@ public:
             }
 
             sAHBot->Commands(AHBotCommand::ahexpire, ahMapID, 0, NULL);
+            handler->PSendSysMessage("Bot auctions will be expired over the next updates, see the log for progress.");
         }
         else if (strncmp(opt, "ahexpireclass", l) == 0)
         {
             char* param1 = strtok(NULL, " ");
-            if (!ahMapIdStr)
+            if (!ahMapIdStr || !param1)
             {
                 handler->PSendSysMessage("Syntax is: ahbotoptions ahexpireclass $ahMapID (2, 6 or 7) $class");
                 return false;
             }
 
             sAHBot->Commands(AHBotCommand::ahexpireclass, ahMapID, 0, param1);
+            handler->PSendSysMessage("Bot auctions will be expired over the next updates, see the log for progress.");
         }
         else if (strncmp(opt, "minitems", l) == 0)
         {
@@ -404,9 +430,70 @@ public:
         }
         else if (strncmp(opt, "reload", l) == 0)
         {
+            if (!sAHBot->ScheduleReload())
+            {
+                handler->PSendSysMessage("AuctionHouseBot is already reloading.");
+                return false;
+            }
+
             LOG_INFO("server.loading", "Reloading AuctionHouseBot...");
-            sAHBot->InitializeConfiguration();
-            sAHBot->Initialize();
+            handler->PSendSysMessage("AuctionHouseBot is reloading in the background, changes are applied on one of the next updates.");
+        }
+        else if (strncmp(opt, "fill", l) == 0)
+        {
+            if (!ahMapIdStr)
+            {
+                handler->PSendSysMessage("Syntax is: ahbotoptions fill $ahMapID (2, 6 or 7)");
+                return false;
+            }
+
+            // Again while it runs for the progress
+            handler->SendSysMessage(sAHBot->FillHouse(ahMapID));
+        }
+        else if (strncmp(opt, "filterstats", l) == 0)
+        {
+            for (std::string const& line : sAHIndex->FormatStats())
+                handler->SendSysMessage(line);
+        }
+        else if (strncmp(opt, "stats", l) == 0)
+        {
+            // Without an ahMapID all houses are listed
+            for (std::string const& line : sAHBot->FormatStats(ahMapID))
+                handler->SendSysMessage(line);
+        }
+        else if (strncmp(opt, "profile", l) == 0)
+        {
+            for (std::string const& line : DumpAHBProfile())
+                handler->SendSysMessage(line);
+        }
+        // Destructive, only the full word, an abbreviation stays one of the options above
+        else if (strcmp(opt, "purge") == 0)
+        {
+            if (!ahMapIdStr)
+            {
+                handler->PSendSysMessage("Syntax is: ahbotoptions purge $ahMapID (2, 6 or 7) [$class] [$color]");
+                return false;
+            }
+
+            // Optional filters in any order, a number is an item class, a name a quality
+            std::optional<uint32> itemClass;
+            std::optional<uint32> quality;
+
+            while (char* filter = strtok(NULL, " "))
+            {
+                if (isdigit(static_cast<unsigned char>(filter[0])))
+                    itemClass = uint32(strtoul(filter, NULL, 0));
+                else if (ItemQualities color = qualityStringToEnum(filter, strlen(filter)); color != static_cast<ItemQualities>(-1))
+                    quality = color;
+                else
+                {
+                    handler->PSendSysMessage("Syntax is: ahbotoptions purge $ahMapID (2, 6 or 7) [$class] [$color]");
+                    return false;
+                }
+            }
+
+            const uint32 queued = sAHBot->PurgeHouse(ahMapID, itemClass, quality);
+            handler->SendSysMessage(std::to_string(queued) + " bot auctions will be purged over the next updates, see the log for progress.");
         }
         else
         {